@@ -319,17 +319,20 @@ static struct net_pkt *prepare_non_vlan_pkt(struct eth_context *ctx,
 	return pkt;
 }
 
-static int read_data(struct eth_context *ctx, int fd)
+/* Max number of frames read from the host before handing them over */
+#define RX_BURST 8
+
+static struct net_pkt *read_data(struct eth_context *ctx, int fd,
+				 struct net_if **iface)
 {
 	uint16_t vlan_tag = NET_VLAN_TAG_UNSPEC;
-	struct net_if *iface;
 	struct net_pkt *pkt = NULL;
 	int status;
 	int count;
 
 	count = eth_read_data(fd, ctx->recv, sizeof(ctx->recv));
 	if (count <= 0) {
-		return 0;
+		return NULL;
 	}
 
 #if defined(CONFIG_NET_VLAN)
@@ -339,12 +342,12 @@ static int read_data(struct eth_context *ctx, int fd)
 		if (ntohs(hdr->type) == NET_ETH_PTYPE_VLAN) {
 			pkt = prepare_vlan_pkt(ctx, count, &vlan_tag, &status);
 			if (!pkt) {
-				return status;
+				return NULL;
 			}
 		} else {
 			pkt = prepare_non_vlan_pkt(ctx, count, &status);
 			if (!pkt) {
-				return status;
+				return NULL;
 			}
 
 			net_pkt_set_vlan_tci(pkt, 0);
@@ -354,20 +357,58 @@ static int read_data(struct eth_context *ctx, int fd)
 	{
 		pkt = prepare_non_vlan_pkt(ctx, count, &status);
 		if (!pkt) {
-			return status;
+			return NULL;
 		}
 	}
 #endif
 
-	iface = get_iface(ctx, vlan_tag);
+	*iface = get_iface(ctx, vlan_tag);
 
-	update_gptp(iface, pkt, false);
+	update_gptp(*iface, pkt, false);
 
-	if (net_recv_data(iface, pkt) < 0) {
-		net_pkt_unref(pkt);
+	return pkt;
+}
+
+static void recv_batch(struct net_if *iface, struct net_pkt **pkts,
+		       int count)
+{
+	if (net_recv_data_batch(iface, pkts, count) < 0) {
+		while (count-- > 0) {
+			net_pkt_unref(pkts[count]);
+		}
 	}
+}
 
-	return 0;
+/* Read the frames pending on the host side and pass them to the stack
+ * in batches, one per run of frames for the same interface.
+ */
+static void read_burst(struct eth_context *ctx, int fd)
+{
+	struct net_pkt *pkts[RX_BURST];
+	struct net_if *batch_iface = NULL;
+	int count = 0;
+
+	do {
+		struct net_if *iface;
+		struct net_pkt *pkt;
+
+		pkt = read_data(ctx, fd, &iface);
+		if (!pkt) {
+			continue;
+		}
+
+		if (count > 0 && iface != batch_iface) {
+			recv_batch(batch_iface, pkts, count);
+			count = 0;
+		}
+
+		batch_iface = iface;
+		pkts[count++] = pkt;
+	} while (count < RX_BURST && !eth_wait_data(fd));
+
+	if (count > 0) {
+		recv_batch(batch_iface, pkts, count);
+	}
 }
 
 static void eth_rx(struct eth_context *ctx)
@@ -377,7 +418,7 @@ static void eth_rx(struct eth_context *ctx)
 	while (1) {
 		if (net_if_is_up(ctx->iface)) {
 			while (!eth_wait_data(ctx->dev_fd)) {
-				read_data(ctx, ctx->dev_fd);
+				read_burst(ctx, ctx->dev_fd);
 				k_yield();
 			}
 		}
@@ -461,12 +461,33 @@ release_desc:
 	return pkt;
 }
 
+/* Max number of frames handed over to the stack at once */
+#define RX_BURST 8
+
+static void rx_submit(struct net_pkt **pkts, int count)
+{
+	struct net_if *iface = net_pkt_iface(pkts[0]);
+	int res;
+
+	res = net_recv_data_batch(iface, pkts, count);
+	if (res < 0) {
+		eth_stats_update_errors_rx(iface);
+		LOG_ERR("Failed to enqueue frame "
+			"into RX queue: %d", res);
+		while (count-- > 0) {
+			net_pkt_unref(pkts[count]);
+		}
+	}
+}
+
 static void rx_thread(void *arg1, void *unused1, void *unused2)
 {
 	uint16_t vlan_tag = NET_VLAN_TAG_UNSPEC;
 	const struct device *dev;
 	struct eth_stm32_hal_dev_data *dev_data;
+	struct net_pkt *pkts[RX_BURST];
 	struct net_pkt *pkt;
+	int count;
 	int res;
 	uint32_t status;
 	HAL_StatusTypeDef hal_ret = HAL_OK;
@@ -490,15 +511,24 @@ static void rx_thread(void *arg1, void *unused1, void *unused2)
 				net_eth_carrier_on(get_iface(dev_data,
 							     vlan_tag));
 			}
+			/* Pass the frames on in batches, each one covering
+			 * a run of frames for the same interface.
+			 */
+			count = 0;
+
 			while ((pkt = eth_rx(dev, &vlan_tag)) != NULL) {
-				res = net_recv_data(net_pkt_iface(pkt), pkt);
-				if (res < 0) {
-					eth_stats_update_errors_rx(
-							net_pkt_iface(pkt));
-					LOG_ERR("Failed to enqueue frame "
-						"into RX queue: %d", res);
-					net_pkt_unref(pkt);
+				if (count == RX_BURST ||
+				    (count > 0 && net_pkt_iface(pkt) !=
+				     net_pkt_iface(pkts[0]))) {
+					rx_submit(pkts, count);
+					count = 0;
 				}
+
+				pkts[count++] = pkt;
+			}
+
+			if (count > 0) {
+				rx_submit(pkts, count);
 			}
 		} else if (res == -EAGAIN) {
 			/* semaphore timeout period expired, check link status */
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <init.h>
+#include <errno.h>
+#include <drivers/flash.h>
+
+/* Asynchronous operations are done by the blocking driver API from a
+ * dedicated work queue, in the order they are requested. Reads of
+ * other threads can then go on during an erase when the driver supports
+ * erase suspend.
+ */
+
+enum {
+	FLASH_ASYNC_READ,
+	FLASH_ASYNC_WRITE,
+	FLASH_ASYNC_ERASE,
+};
+
+static K_KERNEL_STACK_DEFINE(flash_async_stack, CONFIG_FLASH_ASYNC_STACK_SIZE);
+static struct k_work_q flash_async_work_q;
+
+static void flash_async_handler(struct k_work *work)
+{
+	struct flash_async_req *req =
+		CONTAINER_OF(work, struct flash_async_req, work);
+	int rc;
+
+	switch (req->op) {
+	case FLASH_ASYNC_READ:
+		rc = flash_read(req->dev, req->offset, req->data,
+				req->len);
+		break;
+	case FLASH_ASYNC_WRITE:
+		rc = flash_write(req->dev, req->offset, req->data,
+				 req->len);
+		break;
+	default:
+		rc = flash_erase(req->dev, req->offset, req->len);
+		break;
+	}
+
+	req->result = rc;
+
+	if (req->cb != NULL) {
+		req->cb(req->dev, req, rc);
+	}
+}
+
+void flash_async_req_init(struct flash_async_req *req, flash_async_cb_t cb,
+			  void *user_data)
+{
+	req->cb = cb;
+	req->user_data = user_data;
+	req->result = 0;
+	k_work_init(&req->work, flash_async_handler);
+}
+
+static int submit(const struct device *dev, struct flash_async_req *req,
+		  uint8_t op, off_t offset, void *data, size_t len)
+{
+	int busy = k_work_busy_get(&req->work);
+
+	/* A request may be submitted again from its callback, while its
+	 * work item is still running on the queue thread.
+	 */
+	if ((busy & K_WORK_RUNNING) != 0 &&
+	    k_current_get() == &flash_async_work_q.thread) {
+		busy &= ~K_WORK_RUNNING;
+	}
+
+	if (busy != 0) {
+		return -EBUSY;
+	}
+
+	req->dev = dev;
+	req->op = op;
+	req->offset = offset;
+	req->data = data;
+	req->len = len;
+
+	(void)k_work_submit_to_queue(&flash_async_work_q, &req->work);
+
+	return 0;
+}
+
+int flash_read_async(const struct device *dev, off_t offset, void *data,
+		     size_t len, struct flash_async_req *req)
+{
+	return submit(dev, req, FLASH_ASYNC_READ, offset, data, len);
+}
+
+int flash_write_async(const struct device *dev, off_t offset,
+		      const void *data, size_t len,
+		      struct flash_async_req *req)
+{
+	return submit(dev, req, FLASH_ASYNC_WRITE, offset, (void *)data, len);
+}
+
+int flash_erase_async(const struct device *dev, off_t offset, size_t size,
+		      struct flash_async_req *req)
+{
+	return submit(dev, req, FLASH_ASYNC_ERASE, offset, NULL, size);
+}
+
+static int flash_async_init(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	k_work_queue_start(&flash_async_work_q, flash_async_stack,
+			   K_KERNEL_STACK_SIZEOF(flash_async_stack),
+			   CONFIG_FLASH_ASYNC_PRIORITY, NULL);
+	k_thread_name_set(&flash_async_work_q.thread, "flash_async");
+
+	return 0;
+}
+
+SYS_INIT(flash_async_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
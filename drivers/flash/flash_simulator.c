@@ -159,6 +159,43 @@ static const struct flash_parameters flash_sim_parameters = {
 	.erase_value = FLASH_SIMULATOR_ERASE_VALUE
 };
 
+#ifdef CONFIG_FLASH_SIMULATOR_SIMULATE_TIMING
+#ifdef CONFIG_FLASH_SIMULATOR_ERASE_SUSPEND
+#define ERASE_SLICE_US CONFIG_FLASH_SIMULATOR_ERASE_SUSPEND_INTERVAL_US
+#else
+#define ERASE_SLICE_US CONFIG_FLASH_SIMULATOR_MIN_ERASE_TIME_US
+#endif
+
+/* The flash is busy for the duration of an operation, an operation
+ * requested meanwhile by another thread waits for it to end. An erase is
+ * done in slices of ERASE_SLICE_US, which lets operations of other
+ * threads in between as a flash suspending the erase would.
+ */
+static K_MUTEX_DEFINE(flash_sim_busy);
+
+static void flash_sim_busy_wait(uint32_t time_us, uint32_t slice_us)
+{
+	bool lock = IS_ENABLED(CONFIG_MULTITHREADING) && !k_is_pre_kernel() &&
+		    !k_is_in_isr();
+
+	while (time_us > 0) {
+		uint32_t us = MIN(time_us, slice_us);
+
+		if (lock) {
+			k_mutex_lock(&flash_sim_busy, K_FOREVER);
+		}
+
+		k_busy_wait(us);
+
+		if (lock) {
+			k_mutex_unlock(&flash_sim_busy);
+		}
+
+		time_us -= us;
+	}
+}
+#endif /* CONFIG_FLASH_SIMULATOR_SIMULATE_TIMING */
+
 static int flash_range_is_valid(const struct device *dev, off_t offset,
 				size_t len)
 {
@@ -195,7 +232,8 @@ static int flash_sim_read(const struct device *dev, const off_t offset,
 	FLASH_SIM_STATS_INCN(flash_sim_stats, bytes_read, len);
 
 #ifdef CONFIG_FLASH_SIMULATOR_SIMULATE_TIMING
-	k_busy_wait(CONFIG_FLASH_SIMULATOR_MIN_READ_TIME_US);
+	flash_sim_busy_wait(CONFIG_FLASH_SIMULATOR_MIN_READ_TIME_US,
+			    CONFIG_FLASH_SIMULATOR_MIN_READ_TIME_US);
 	FLASH_SIM_STATS_INCN(flash_sim_stats, flash_read_time_us,
 		   CONFIG_FLASH_SIMULATOR_MIN_READ_TIME_US);
 #endif
@@ -270,7 +308,8 @@ static int flash_sim_write(const struct device *dev, const off_t offset,
 
 #ifdef CONFIG_FLASH_SIMULATOR_SIMULATE_TIMING
 	/* wait before returning */
-	k_busy_wait(CONFIG_FLASH_SIMULATOR_MIN_WRITE_TIME_US);
+	flash_sim_busy_wait(CONFIG_FLASH_SIMULATOR_MIN_WRITE_TIME_US,
+			    CONFIG_FLASH_SIMULATOR_MIN_WRITE_TIME_US);
 	FLASH_SIM_STATS_INCN(flash_sim_stats, flash_write_time_us,
 		   CONFIG_FLASH_SIMULATOR_MIN_WRITE_TIME_US);
 #endif
@@ -324,7 +363,8 @@ static int flash_sim_erase(const struct device *dev, const off_t offset,
 
 #ifdef CONFIG_FLASH_SIMULATOR_SIMULATE_TIMING
 	/* wait before returning */
-	k_busy_wait(CONFIG_FLASH_SIMULATOR_MIN_ERASE_TIME_US);
+	flash_sim_busy_wait(CONFIG_FLASH_SIMULATOR_MIN_ERASE_TIME_US,
+			    ERASE_SLICE_US);
 	FLASH_SIM_STATS_INCN(flash_sim_stats, flash_erase_time_us,
 		   CONFIG_FLASH_SIMULATOR_MIN_ERASE_TIME_US);
 #endif
@@ -112,6 +112,17 @@ struct spi_nor_config {
  */
 struct spi_nor_data {
 	struct k_sem sem;
+#ifdef CONFIG_SPI_NOR_ERASE_SUSPEND
+	/* Serializes the operations other than reads, which only take
+	 * sem and may go on while an erase is in progress.
+	 */
+	struct k_sem op_sem;
+	/* Low 32-bits of the cycle counter at which the erase in
+	 * progress was last resumed.
+	 */
+	uint32_t ts_erase_resumed;
+	bool erasing;
+#endif
 #if DT_INST_NODE_HAS_PROP(0, has_dpd)
 	/* Low 32-bits of uptime counter at which device last entered
 	 * deep power-down.
@@ -470,6 +481,9 @@ static void acquire_device(const struct device *dev)
 	if (IS_ENABLED(CONFIG_MULTITHREADING)) {
 		struct spi_nor_data *const driver_data = dev->data;
 
+#ifdef CONFIG_SPI_NOR_ERASE_SUSPEND
+		k_sem_take(&driver_data->op_sem, K_FOREVER);
+#endif
 		k_sem_take(&driver_data->sem, K_FOREVER);
 	}
 
@@ -493,6 +507,9 @@ static void release_device(const struct device *dev)
 		struct spi_nor_data *const driver_data = dev->data;
 
 		k_sem_give(&driver_data->sem);
+#ifdef CONFIG_SPI_NOR_ERASE_SUSPEND
+		k_sem_give(&driver_data->op_sem);
+#endif
 	}
 }
 
@@ -543,6 +560,73 @@ static int spi_nor_wrsr(const struct device *dev,
 	return ret;
 }
 
+#ifdef CONFIG_SPI_NOR_ERASE_SUSPEND
+/* Suspend the erase in progress, if any, for a read.
+ *
+ * The erase is given at least CONFIG_SPI_NOR_ERASE_RESUME_INTERVAL_US
+ * since it was last resumed to make progress.  The bus lock must be
+ * held.
+ *
+ * @return true if an erase was suspended
+ */
+static bool erase_suspend(const struct device *dev)
+{
+	struct spi_nor_data *const driver_data = dev->data;
+	uint32_t elapsed_us;
+
+	if (!driver_data->erasing) {
+		return false;
+	}
+
+	elapsed_us = k_cyc_to_us_floor32(k_cycle_get_32() -
+					 driver_data->ts_erase_resumed);
+	if (elapsed_us < CONFIG_SPI_NOR_ERASE_RESUME_INTERVAL_US) {
+		k_busy_wait(CONFIG_SPI_NOR_ERASE_RESUME_INTERVAL_US -
+			    elapsed_us);
+	}
+
+	/* WIP clears once the device is suspended, or if the erase
+	 * completed meanwhile, in which case resuming does nothing.
+	 */
+	spi_nor_cmd_write(dev, SPI_NOR_CMD_PES);
+	spi_nor_wait_until_ready(dev);
+
+	return true;
+}
+
+static void erase_resume(const struct device *dev)
+{
+	struct spi_nor_data *const driver_data = dev->data;
+
+	spi_nor_cmd_write(dev, SPI_NOR_CMD_PER);
+	driver_data->ts_erase_resumed = k_cycle_get_32();
+}
+
+/* Wait for an erase to complete, holding only op_sem so that reads can
+ * suspend it meanwhile.
+ */
+static int erase_wait_until_ready(const struct device *dev)
+{
+	struct spi_nor_data *const driver_data = dev->data;
+	int ret;
+
+	driver_data->ts_erase_resumed = k_cycle_get_32();
+	driver_data->erasing = true;
+
+	do {
+		k_sem_give(&driver_data->sem);
+		k_sleep(K_MSEC(1));
+		k_sem_take(&driver_data->sem, K_FOREVER);
+
+		ret = spi_nor_rdsr(dev);
+	} while ((ret >= 0) && (ret & SPI_NOR_WIP_BIT));
+
+	driver_data->erasing = false;
+
+	return (ret < 0) ? ret : 0;
+}
+#endif /* CONFIG_SPI_NOR_ERASE_SUSPEND */
+
 static int spi_nor_read(const struct device *dev, off_t addr, void *dest,
 			size_t size)
 {
@@ -554,11 +638,29 @@ static int spi_nor_read(const struct device *dev, off_t addr, void *dest,
 		return -EINVAL;
 	}
 
+#ifdef CONFIG_SPI_NOR_ERASE_SUSPEND
+	struct spi_nor_data *const driver_data = dev->data;
+	bool suspended;
+
+	/* Only the bus is needed, an erase may be in progress */
+	k_sem_take(&driver_data->sem, K_FOREVER);
+
+	suspended = erase_suspend(dev);
+
+	ret = spi_nor_cmd_addr_read(dev, SPI_NOR_CMD_READ, addr, dest, size);
+
+	if (suspended) {
+		erase_resume(dev);
+	}
+
+	k_sem_give(&driver_data->sem);
+#else
 	acquire_device(dev);
 
 	ret = spi_nor_cmd_addr_read(dev, SPI_NOR_CMD_READ, addr, dest, size);
 
 	release_device(dev);
+#endif
 	return ret;
 }
 
@@ -641,6 +743,8 @@ static int spi_nor_erase(const struct device *dev, off_t addr, size_t size)
 	ret = spi_nor_write_protection_set(dev, false);
 
 	while ((size > 0) && (ret == 0)) {
+		bool suspendable = false;
+
 		spi_nor_cmd_write(dev, SPI_NOR_CMD_WREN);
 
 		if (size == flash_size) {
@@ -668,6 +772,7 @@ static int spi_nor_erase(const struct device *dev, off_t addr, size_t size)
 				spi_nor_cmd_addr_write(dev, bet->cmd, addr, NULL, 0);
 				addr += BIT(bet->exp);
 				size -= BIT(bet->exp);
+				suspendable = true;
 			} else {
 				LOG_DBG("Can't erase %zu at 0x%lx",
 					size, (long)addr);
@@ -675,6 +780,15 @@ static int spi_nor_erase(const struct device *dev, off_t addr, size_t size)
 			}
 		}
 
+#ifdef CONFIG_SPI_NOR_ERASE_SUSPEND
+		if (suspendable) {
+			ret = erase_wait_until_ready(dev);
+			continue;
+		}
+#else
+		ARG_UNUSED(suspendable);
+#endif
+
 #ifdef __XCC__
 		/*
 		 * FIXME: remove this hack once XCC is fixed.
@@ -1129,6 +1243,9 @@ static int spi_nor_init(const struct device *dev)
 		struct spi_nor_data *const driver_data = dev->data;
 
 		k_sem_init(&driver_data->sem, 1, K_SEM_MAX_LIMIT);
+#ifdef CONFIG_SPI_NOR_ERASE_SUSPEND
+		k_sem_init(&driver_data->op_sem, 1, K_SEM_MAX_LIMIT);
+#endif
 	}
 
 	return spi_nor_configure(dev);
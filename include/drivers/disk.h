@@ -74,6 +74,12 @@ struct disk_info {
 	const struct disk_operations *ops;
 	/** Device associated to this disk */
 	const struct device *dev;
+#ifdef CONFIG_DISK_CACHE
+	/** Internally used number of sectors, 0 if the disk is not cached */
+	uint32_t cache_sector_count;
+	/** Internally used sector following the last one read */
+	uint32_t cache_next_sector;
+#endif
 };
 
 /**
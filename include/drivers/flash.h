@@ -24,6 +24,9 @@
 #include <stddef.h>
 #include <sys/types.h>
 #include <device.h>
+#if defined(CONFIG_FLASH_ASYNC)
+#include <kernel.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -442,6 +445,114 @@ static inline int z_impl_flash_read_jedec_id(const struct device *dev,
 }
 #endif /* CONFIG_FLASH_JESD216_API */
 
+#if defined(CONFIG_FLASH_ASYNC)
+struct flash_async_req;
+
+/**
+ * @brief Completion callback of an asynchronous flash operation.
+ *
+ * Invoked from the asynchronous flash operations thread. The request can
+ * be reused from the callback.
+ *
+ * @param dev flash device
+ * @param req completed request
+ * @param result 0 on success, negative errno code on fail
+ */
+typedef void (*flash_async_cb_t)(const struct device *dev,
+				 struct flash_async_req *req, int result);
+
+/**
+ * @brief Asynchronous flash operation request.
+ *
+ * The request must be initialized with flash_async_req_init() before its
+ * first use. The caller may change @a cb and @a user_data between
+ * operations, the other fields are internal. The request must stay valid
+ * until it is completed.
+ */
+struct flash_async_req {
+	/** Called on completion, may be NULL */
+	flash_async_cb_t cb;
+	/** Free for the caller to use */
+	void *user_data;
+	/** Result of the operation, set before calling back */
+	int result;
+
+	/* Internal */
+	struct k_work work;
+	const struct device *dev;
+	off_t offset;
+	void *data;
+	size_t len;
+	uint8_t op;
+};
+
+/**
+ * @brief Initialize an asynchronous flash operation request.
+ *
+ * Must be called once before the request is first used, and not while an
+ * operation of the request is pending.
+ *
+ * @param req request to initialize
+ * @param cb called on completion, may be NULL
+ * @param user_data free for the caller to use
+ */
+void flash_async_req_init(struct flash_async_req *req, flash_async_cb_t cb,
+			  void *user_data);
+
+/**
+ *  @brief  Read data from flash asynchronously
+ *
+ *  Same as flash_read(), with the read done from the asynchronous flash
+ *  operations thread. Operations are done in the order they are requested.
+ *
+ *  @param  dev             : flash device
+ *  @param  offset          : Offset (byte aligned) to read
+ *  @param  data            : Buffer to store read data
+ *  @param  len             : Number of bytes to read.
+ *  @param  req             : Request, completed through its callback
+ *
+ *  @return  0 if the request is queued, -EBUSY if it is already pending.
+ */
+int flash_read_async(const struct device *dev, off_t offset, void *data,
+		     size_t len, struct flash_async_req *req);
+
+/**
+ *  @brief  Write buffer into flash memory asynchronously
+ *
+ *  Same as flash_write(), with the write done from the asynchronous flash
+ *  operations thread. The data must stay valid until the request is
+ *  completed.
+ *
+ *  @param  dev             : flash device
+ *  @param  offset          : starting offset for the write
+ *  @param  data            : data to write
+ *  @param  len             : Number of bytes to write
+ *  @param  req             : Request, completed through its callback
+ *
+ *  @return  0 if the request is queued, -EBUSY if it is already pending.
+ */
+int flash_write_async(const struct device *dev, off_t offset,
+		      const void *data, size_t len,
+		      struct flash_async_req *req);
+
+/**
+ *  @brief  Erase part or all of a flash memory asynchronously
+ *
+ *  Same as flash_erase(), with the erase done from the asynchronous flash
+ *  operations thread. With drivers supporting erase suspend, flash_read()
+ *  can be used from other threads while the erase is in progress.
+ *
+ *  @param  dev             : flash device
+ *  @param  offset          : erase area starting offset
+ *  @param  size            : size of area to be erased
+ *  @param  req             : Request, completed through its callback
+ *
+ *  @return  0 if the request is queued, -EBUSY if it is already pending.
+ */
+int flash_erase_async(const struct device *dev, off_t offset, size_t size,
+		      struct flash_async_req *req);
+#endif /* CONFIG_FLASH_ASYNC */
+
 /**
  *  @brief  Get the minimum write block size supported by the driver
  *
@@ -129,6 +129,22 @@ struct fcb {
 	/**< The value flash takes when it is erased. This is read from
 	 * flash parameters and initialized upon call to fcb_init.
 	 */
+
+#ifdef CONFIG_FCB_BACKGROUND_ERASE
+	struct k_work f_erase_work;
+	/**< Work item erasing the rotated sector, internal state */
+
+	struct k_mutex f_erase_mtx;
+	/**< Locking for the pending erase, internal state */
+
+	struct flash_sector *f_erase_pending;
+	/**< Sector rotated out but not erased yet, internal state */
+
+	bool f_erase_init;
+	/**< Background erase initialized, internal state. The fcb must be
+	 * zeroed before its first fcb_init.
+	 */
+#endif
 };
 
 /**
@@ -13,6 +13,10 @@
 #include <sys/dlist.h>
 #include <fs/fs_interface.h>
 
+#ifdef CONFIG_FILE_SYSTEM_ASYNC
+#include <kernel.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -79,6 +83,9 @@ enum {
  * @param mountp_len Length of Mount point string
  * @param fs Pointer to File system interface of the mount point
  * @param flags Mount flags
+ * @param async_reqs Queue of asynchronous requests of the mount point
+ * @param async_node Entry for the list of mount points with requests
+ * @param async_busy Whether a worker is servicing the mount point
  */
 struct fs_mount_t {
 	sys_dnode_t node;
@@ -90,6 +97,11 @@ struct fs_mount_t {
 	size_t mountp_len;
 	const struct fs_file_system_t *fs;
 	uint8_t flags;
+#ifdef CONFIG_FILE_SYSTEM_ASYNC
+	sys_slist_t async_reqs;
+	sys_snode_t async_node;
+	bool async_busy;
+#endif
 };
 
 /**
@@ -419,6 +431,108 @@ int fs_truncate(struct fs_file_t *zfp, off_t length);
  */
 int fs_sync(struct fs_file_t *zfp);
 
+#if defined(CONFIG_FILE_SYSTEM_ASYNC) || defined(__DOXYGEN__)
+struct fs_async_req;
+
+/**
+ * @brief Asynchronous request completion callback
+ *
+ * Called from a file system worker thread.
+ *
+ * @param req Pointer to the completed request
+ * @param result Result of the request, as returned by the blocking call
+ */
+typedef void (*fs_async_cb_t)(struct fs_async_req *req, ssize_t result);
+
+/**
+ * @brief Asynchronous file request
+ *
+ * The completion fields are set by the caller before submitting the
+ * request, the others by the submit functions. The request must stay
+ * valid until it completes.
+ *
+ * @param cb Callback called on completion, may be NULL
+ * @param signal Signal raised with the result on completion, after the
+ * callback, may be NULL
+ * @param user_data User data for the callback
+ * @param result Result of the request, as returned by the blocking call
+ */
+struct fs_async_req {
+	fs_async_cb_t cb;
+	struct k_poll_signal *signal;
+	void *user_data;
+	ssize_t result;
+	/* fields filled by file system core */
+	sys_snode_t node;
+	struct fs_file_t *zfp;
+	void *ptr;
+	size_t size;
+	off_t offset;
+	uint8_t op;
+};
+
+/**
+ * @brief Read file asynchronously
+ *
+ * Queues the read of up to @p size bytes at @p offset of the file to
+ * the file system workers. Requests of a mount point are serviced in
+ * order, reads of adjacent areas of a file queued one after another are
+ * done as a single read when they fit in
+ * @kconfig{CONFIG_FILE_SYSTEM_ASYNC_MERGE_SIZE} bytes.
+ *
+ * The file position is undefined while requests on the file are
+ * pending, blocking calls on the file must not be mixed with them.
+ *
+ * @param zfp Pointer to the file object
+ * @param ptr Pointer to the data buffer
+ * @param size Number of bytes to be read
+ * @param offset Offset in the file to read from
+ * @param req Pointer to the request, with the completion fields set
+ *
+ * @retval 0 if the request is queued;
+ * @retval -EBADF when the file is not open;
+ * @retval -ENOTSUP when not implemented by underlying file system driver.
+ */
+int fs_read_async(struct fs_file_t *zfp, void *ptr, size_t size,
+		  off_t offset, struct fs_async_req *req);
+
+/**
+ * @brief Write file asynchronously
+ *
+ * Queues the write of @p size bytes at @p offset of the file, as
+ * @ref fs_read_async queues reads. Adjacent writes are merged the same
+ * way.
+ *
+ * @param zfp Pointer to the file object
+ * @param ptr Pointer to the data buffer
+ * @param size Number of bytes to be written
+ * @param offset Offset in the file to write to
+ * @param req Pointer to the request, with the completion fields set
+ *
+ * @retval 0 if the request is queued;
+ * @retval -EBADF when the file is not open;
+ * @retval -ENOTSUP when not implemented by underlying file system driver.
+ */
+int fs_write_async(struct fs_file_t *zfp, const void *ptr, size_t size,
+		   off_t offset, struct fs_async_req *req);
+
+/**
+ * @brief Flush file asynchronously
+ *
+ * Queues a @ref fs_sync of the file. It completes after the requests on
+ * the mount point queued before it, consecutive syncs of a file are
+ * done once.
+ *
+ * @param zfp Pointer to the file object
+ * @param req Pointer to the request, with the completion fields set
+ *
+ * @retval 0 if the request is queued;
+ * @retval -EBADF when the file is not open;
+ * @retval -ENOTSUP when not implemented by underlying file system driver.
+ */
+int fs_sync_async(struct fs_file_t *zfp, struct fs_async_req *req);
+#endif /* CONFIG_FILE_SYSTEM_ASYNC */
+
 /**
  * @brief Directory create
  *
@@ -515,6 +629,7 @@ int fs_mount(struct fs_mount_t *mp);
  * @retval 0 on success;
  * @retval -EINVAL if no system has been mounted at given mount point;
  * @retval -ENOTSUP when not supported by underlying file system driver;
+ * @retval -EBUSY when asynchronous requests are pending on the mount point;
  * @retval <0 an other negative errno code on error.
  */
 int fs_unmount(struct fs_mount_t *mp);
@@ -13,10 +13,25 @@
 
 #include <lfs.h>
 
+#ifdef CONFIG_FS_LITTLEFS_STATS
+#include <stats/stats.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#ifdef CONFIG_FS_LITTLEFS_STATS
+/** @brief Statistics of a LittleFS mount */
+STATS_SECT_START(littlefs_stats)
+STATS_SECT_ENTRY32(reads)	/* Reads from flash */
+STATS_SECT_ENTRY32(progs)	/* Programs to flash */
+STATS_SECT_ENTRY32(erases)	/* Block erases */
+STATS_SECT_ENTRY32(cache_hits)	/* Block cache entries read from RAM */
+STATS_SECT_ENTRY32(cache_misses)	/* Block cache entries read from flash */
+STATS_SECT_END;
+#endif
+
 /** @brief Filesystem info structure for LittleFS mount */
 struct fs_littlefs {
 	/* Defaulted in driver, customizable before mount. */
@@ -37,6 +52,17 @@ struct fs_littlefs {
 	struct lfs lfs;
 	const struct flash_area *area;
 	struct k_mutex mutex;
+
+#ifdef CONFIG_FS_LITTLEFS_BLOCK_CACHE
+	/* Block cache entries in LRU order, allocated at mount. */
+	sys_dlist_t block_cache;
+	void *block_cache_mem;
+#endif
+
+#ifdef CONFIG_FS_LITTLEFS_STATS
+	/* Registered as a stats group named after the mount point. */
+	STATS_SECT_DECL(littlefs_stats) stats;
+#endif
 };
 
 /** @brief Define a littlefs configuration with customized size
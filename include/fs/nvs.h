@@ -43,6 +43,14 @@ extern "C" {
  * @param nvs_lock Mutex
  * @param flash_device Flash Device runtime structure
  * @param flash_parameters Flash memory parameters structure
+ * @param lookup_cache Address of the newest ATE of the IDs mapping to each
+ * cache position, or NVS_LOOKUP_CACHE_NO_ADDR
+ * @param erase_work Work item erasing the sector left by garbage collection
+ * @param erase_lock Mutex protecting the pending erase
+ * @param erase_addr Address of the sector pending erase
+ * @param erase_pending Flag indicating if a sector is pending erase
+ * @param erase_init Flag indicating if the background erase is initialized,
+ * the structure must be zeroed before it is first mounted
  */
 struct nvs_fs {
 	off_t offset;
@@ -54,8 +62,46 @@ struct nvs_fs {
 	struct k_mutex nvs_lock;
 	const struct device *flash_device;
 	const struct flash_parameters *flash_parameters;
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	uint32_t lookup_cache[CONFIG_NVS_LOOKUP_CACHE_SIZE];
+#endif
+#ifdef CONFIG_NVS_BACKGROUND_ERASE
+	struct k_work erase_work;
+	struct k_mutex erase_lock;
+	uint32_t erase_addr;
+	bool erase_pending;
+	bool erase_init;
+#endif
+};
+
+/**
+ * @brief Non-volatile Storage entry found by nvs_walk()
+ *
+ * @param id Id of the entry
+ * @param len Length of the entry data, 0 for a deleted entry
+ * @param data_addr Address of the entry data, private
+ * @param wra Allocation table entry write address at the time of the walk,
+ * private
+ */
+struct nvs_walk_entry {
+	uint16_t id;
+	uint16_t len;
+	uint32_t data_addr;
+	uint32_t wra;
 };
 
+/**
+ * @brief Callback called by nvs_walk() for each entry
+ *
+ * @param fs Pointer to file system
+ * @param entry Entry found
+ * @param param Parameter given to nvs_walk()
+ *
+ * @return 0 to continue the walk, any other value stops it.
+ */
+typedef int (*nvs_walk_cb_t)(struct nvs_fs *fs,
+			     const struct nvs_walk_entry *entry, void *param);
+
 /**
  * @}
  */
@@ -152,6 +198,42 @@ ssize_t nvs_read(struct nvs_fs *fs, uint16_t id, void *data, size_t len);
  */
 ssize_t nvs_read_hist(struct nvs_fs *fs, uint16_t id, void *data, size_t len, uint16_t cnt);
 
+/**
+ * @brief nvs_walk
+ *
+ * Walk all the entries of the file system once, from the most recent to the
+ * oldest one. All entries written for an id are reported, including older
+ * ones and deletes, so the first entry reported for an id is the current
+ * one. The callback must not write to the file system.
+ *
+ * @param fs Pointer to file system
+ * @param cb Callback called for each entry
+ * @param param Parameter passed to the callback
+ *
+ * @retval 0 Success
+ * @return Value returned by the callback if it stopped the walk, or negative
+ * value of errno.h defined error codes.
+ */
+int nvs_walk(struct nvs_fs *fs, nvs_walk_cb_t cb, void *param);
+
+/**
+ * @brief nvs_read_entry
+ *
+ * Read the data of an entry reported by nvs_walk() without looking it up
+ * again. The entry can only be read until the next write to the file system.
+ *
+ * @param fs Pointer to file system
+ * @param entry Entry reported by nvs_walk()
+ * @param data Pointer to data buffer
+ * @param len Number of bytes to be read
+ *
+ * @return Number of bytes read, see nvs_read(). When the file system has been
+ * written since the walk, returns -EAGAIN. On error, returns negative value
+ * of errno.h defined error codes.
+ */
+ssize_t nvs_read_entry(struct nvs_fs *fs, const struct nvs_walk_entry *entry,
+		       void *data, size_t len);
+
 /**
  * @brief nvs_calc_free_space
  *
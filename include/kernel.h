@@ -1844,6 +1844,31 @@ extern int k_queue_merge_slist(struct k_queue *queue, sys_slist_t *list);
  */
 __syscall void *k_queue_get(struct k_queue *queue, k_timeout_t timeout);
 
+/**
+ * @brief Get all elements from a queue in one operation.
+ *
+ * This routine removes every data item currently in @a queue and returns
+ * them as a NULL-terminated singly-linked list, with the first word in each
+ * data item pointing to the next data item. If the queue is empty the
+ * caller waits for a single data item, which is returned as a list of one.
+ *
+ * @note Only valid for queues whose items were not added with
+ * k_queue_alloc_append() or k_queue_alloc_prepend().
+ *
+ * @note @a timeout must be set to K_NO_WAIT if called from ISR.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param queue Address of the queue.
+ * @param timeout Non-negative waiting period to obtain a data item
+ *                or one of the special values K_NO_WAIT and
+ *                K_FOREVER.
+ *
+ * @return Address of the first data item if successful; NULL if returned
+ * without waiting, or waiting period timed out.
+ */
+extern void *k_queue_get_list(struct k_queue *queue, k_timeout_t timeout);
+
 /**
  * @brief Remove an element from a queue.
  *
@@ -2186,6 +2211,36 @@ struct k_fifo {
 	ret; \
 	})
 
+/**
+ * @brief Get all elements from a FIFO queue in one operation.
+ *
+ * This routine removes every data item from @a fifo and returns them,
+ * oldest first, as a NULL-terminated singly-linked list with the first
+ * word in each data item pointing to the next data item. If the FIFO is
+ * empty the caller waits for a single data item.
+ *
+ * @note Only valid for FIFOs whose items were not added with
+ * k_fifo_alloc_put().
+ *
+ * @note @a timeout must be set to K_NO_WAIT if called from ISR.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param fifo Address of the FIFO queue.
+ * @param timeout Waiting period to obtain a data item,
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return Address of the first data item if successful; NULL if returned
+ * without waiting, or waiting period timed out.
+ */
+#define k_fifo_get_list(fifo, timeout) \
+	({ \
+	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_fifo, get_list, fifo, timeout); \
+	void *ret = k_queue_get_list(&(fifo)->_queue, timeout); \
+	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_fifo, get_list, fifo, timeout, ret); \
+	ret; \
+	})
+
 /**
  * @brief Query a FIFO queue to see if it has data available.
  *
@@ -4952,8 +5007,60 @@ struct k_heap {
 	struct sys_heap heap;
 	_wait_q_t wait_q;
 	struct k_spinlock lock;
+#ifdef CONFIG_HEAP_CACHE
+	struct k_heap_cache *cache;
+#endif
+};
+
+#ifdef CONFIG_HEAP_CACHE
+
+/* One magazine of cached blocks of a single size class */
+struct z_heap_cache_mag {
+	uint16_t count;
+	void *slots[CONFIG_HEAP_CACHE_DEPTH];
+};
+
+/** Statistics of a k_heap allocation cache, summed over all CPUs */
+struct k_heap_cache_stats {
+	/** Allocations served from a magazine without taking the heap lock */
+	uint32_t alloc_hits;
+	/** Allocations that found their magazine empty */
+	uint32_t alloc_misses;
+	/** Frees absorbed by a magazine */
+	uint32_t free_hits;
+	/** Batches moved from the heap into a magazine */
+	uint32_t refills;
+	/** Batches moved from a magazine back to the heap */
+	uint32_t flushes;
+	/** Bytes currently held in magazines, unavailable to other CPUs */
+	size_t cached_bytes;
+};
+
+/* Magazines and counters of one CPU */
+struct z_heap_cache_cpu {
+	struct k_spinlock lock;
+	struct z_heap_cache_mag mags[CONFIG_HEAP_CACHE_CLASSES];
+	uint32_t alloc_hits;
+	uint32_t alloc_misses;
+	uint32_t free_hits;
+	uint32_t refills;
+	uint32_t flushes;
 };
 
+/**
+ * @brief Per-CPU allocation cache of a k_heap
+ *
+ * Storage for the magazines attached to a heap with
+ * k_heap_cache_attach().  The contents are private.
+ */
+struct k_heap_cache {
+	struct z_heap_cache_cpu cpus[CONFIG_MP_NUM_CPUS];
+	/* Allocators blocked on the heap */
+	atomic_t waiters;
+};
+
+#endif /* CONFIG_HEAP_CACHE */
+
 /**
  * @brief Initialize a k_heap
  *
@@ -5026,6 +5133,52 @@ void *k_heap_alloc(struct k_heap *h, size_t bytes,
  */
 void k_heap_free(struct k_heap *h, void *mem);
 
+#if defined(CONFIG_HEAP_CACHE) || defined(__DOXYGEN__)
+
+/**
+ * @brief Attach a per-CPU allocation cache to a k_heap
+ *
+ * Small allocations and frees with no more than pointer alignment are
+ * then served from per-CPU, per-size-class magazines without taking
+ * the heap lock.  Magazines are refilled from and flushed to the heap
+ * in batches of half their depth.  Blocks sitting in a magazine are not
+ * available to other CPUs until flushed, so a cached heap needs some
+ * headroom; an allocation that fails flushes the magazines of all
+ * CPUs before it gives up or blocks, and frees bypass the magazines
+ * while allocators are blocked on the heap.
+ *
+ * Must be called after k_heap_init() (for heaps defined with
+ * K_HEAP_DEFINE(), after kernel start) and before the heap is shared.
+ *
+ * @param h Heap to attach the cache to
+ * @param cache Cache storage, cleared here and owned by the heap from
+ *        now on
+ */
+void k_heap_cache_attach(struct k_heap *h, struct k_heap_cache *cache);
+
+/**
+ * @brief Return the blocks cached on the current CPU to the heap
+ *
+ * Useful before a large allocation or when a thread is about to migrate
+ * for good.  Has no effect if the heap has no cache attached.
+ *
+ * @param h Heap whose local magazines are flushed
+ */
+void k_heap_cache_flush(struct k_heap *h);
+
+/**
+ * @brief Get the statistics of a k_heap allocation cache
+ *
+ * @param h Heap with an attached cache
+ * @param stats Filled with the counters summed over all CPUs
+ *
+ * @retval 0 on success
+ * @retval -EINVAL if the heap has no cache attached
+ */
+int k_heap_cache_stats_get(struct k_heap *h, struct k_heap_cache_stats *stats);
+
+#endif /* CONFIG_HEAP_CACHE */
+
 /* Hand-calculated minimum heap sizes needed to return a successful
  * 1-byte allocation.  See details in lib/os/heap.[ch]
  */
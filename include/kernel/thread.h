@@ -102,6 +102,10 @@ struct _thread_base {
 	/* Recursive count of irq_lock() calls */
 	uint8_t global_lock_count;
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* CPU index of the run queue holding this thread */
+	uint8_t runq_cpu;
+#endif
 #endif
 
 #ifdef CONFIG_SCHED_CPU_MASK
@@ -128,6 +128,11 @@ struct _cpu {
 
 	/* Per CPU architecture specifics */
 	struct _cpu_arch arch;
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* Run queue of threads homed on this CPU, can be big */
+	struct _ready_q ready_q;
+#endif
 };
 
 typedef struct _cpu _cpu_t;
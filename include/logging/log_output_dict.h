@@ -47,6 +47,23 @@ struct log_dict_output_dropped_msg_t {
 	uint16_t num_dropped_messages;
 } __packed;
 
+/** First byte of the frame synchronization sequence. */
+#define LOG_DICT_OUTPUT_FRAME_SYNC0 0x5A
+
+/** Second byte of the frame synchronization sequence. */
+#define LOG_DICT_OUTPUT_FRAME_SYNC1 0x4C
+
+/**
+ * Header of a frame carrying one dictionary based log message, with
+ * CONFIG_LOG_DICTIONARY_FRAMING. The message is followed by its CRC-8
+ * (CCITT, initial value 0xFF), so that a parser can find the start of
+ * the next message after losing data.
+ */
+struct log_dict_output_frame_hdr_t {
+	uint8_t sync[2];
+	uint16_t len;
+} __packed;
+
 /** @brief Process log messages v2 for dictionary-basde logging.
  *
  * Function is using provided context with the buffer and output function to
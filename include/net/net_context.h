@@ -115,6 +115,18 @@ typedef void (*net_context_send_cb_t)(struct net_context *context,
 				      int status,
 				      void *user_data);
 
+/**
+ * @typedef net_context_writable_cb_t
+ * @brief Network context writable callback.
+ *
+ * @details The writable callback is called when a connection that could not
+ * take more data can do so again, i.e. when the TCP send window opens. It is
+ * called from the RX thread without any connection lock held.
+ *
+ * @param context The context to use.
+ */
+typedef void (*net_context_writable_cb_t)(struct net_context *context);
+
 /**
  * @typedef net_tcp_accept_cb_t
  * @brief Accept callback
@@ -242,6 +254,11 @@ __net_socket struct net_context {
 	 */
 	net_context_connect_cb_t connect_cb;
 
+	/** Writable callback to be called when a full connection can take
+	 * more data again.
+	 */
+	net_context_writable_cb_t writable_cb;
+
 #if defined(CONFIG_NET_CONTEXT_NET_PKT_POOL)
 	/** Get TX net_buf pool for this context.
 	 */
@@ -281,6 +298,11 @@ __net_socket struct net_context {
 		/** Mutex used by condition variable */
 		struct k_mutex *lock;
 	} cond;
+
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+	/** epoll instance entries watching this socket */
+	sys_slist_t epoll_items;
+#endif
 #endif /* CONFIG_NET_SOCKETS */
 
 #if defined(CONFIG_NET_OFFLOAD)
@@ -965,6 +987,36 @@ int net_context_sendto(struct net_context *context,
 		       k_timeout_t timeout,
 		       void *user_data);
 
+/**
+ * @brief Send a chain of network buffers without copying it.
+ *
+ * @details The fragments are attached to the outgoing packet as they
+ * are, only the protocol headers are allocated by the stack. If
+ * dst_addr is NULL, the packet is sent to the address given in
+ * net_context_connect(). Only UDP and TCP contexts are supported, and
+ * a UDP datagram must fit into the MTU of the network interface.
+ * The fragments should come from a TX data pool (see
+ * net_pkt_get_reserve_tx_data()) so that the driver can access them.
+ *
+ * @param context The network context to use.
+ * @param frags Data to send. On success the caller's reference to the
+ * buffer chain is consumed, on error it is left to the caller.
+ * @param dst_addr Destination address or NULL.
+ * @param addrlen Length of the address.
+ * @param cb Caller-supplied callback function.
+ * @param timeout Currently this value is not used.
+ * @param user_data Caller-supplied user data.
+ *
+ * @return numbers of bytes sent on success, a negative errno otherwise
+ */
+int net_context_send_buf(struct net_context *context,
+			 struct net_buf *frags,
+			 const struct sockaddr *dst_addr,
+			 socklen_t addrlen,
+			 net_context_send_cb_t cb,
+			 k_timeout_t timeout,
+			 void *user_data);
+
 /**
  * @brief Send data in iovec to a peer specified in msghdr struct.
  *
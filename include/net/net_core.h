@@ -117,6 +117,24 @@ enum net_verdict {
  */
 int net_recv_data(struct net_if *iface, struct net_pkt *pkt);
 
+/**
+ * @brief Called by network device driver when a burst of network packets
+ * has been received. Behaves like net_recv_data() for each packet, but the
+ * packets are queued to the RX traffic class threads with one queue
+ * operation and one wakeup per traffic class.
+ *
+ * The packets are queued in order. Either all of them are taken by the
+ * stack, or none is and the caller remains responsible for them.
+ *
+ * @param iface Network interface where the packets were received.
+ * @param pkts Array of received network packets.
+ * @param count Number of packets in the array.
+ *
+ * @return 0 if ok, <0 if error.
+ */
+int net_recv_data_batch(struct net_if *iface, struct net_pkt **pkts,
+			size_t count);
+
 /**
  * @brief Send data to network.
  *
@@ -27,6 +27,7 @@
 #include <net/net_ip.h>
 #include <net/dns_resolve.h>
 #include <net/socket_select.h>
+#include <net/socket_epoll.h>
 #include <stdlib.h>
 
 #ifdef __cplusplus
@@ -404,6 +405,62 @@ static inline ssize_t zsock_recv(int sock, void *buf, size_t max_len,
 	return zsock_recvfrom(sock, buf, max_len, flags, NULL, NULL);
 }
 
+struct net_buf;
+
+/**
+ * @brief Receive data as network buffers, without copying it
+ *
+ * @details
+ * @rst
+ * Zero-copy variant of ``zsock_recvfrom()`` for UDP and TCP sockets.
+ * Instead of copying the payload into a caller buffer, the fragments
+ * holding it are detached from the received packet and returned in
+ * ``frags``. The caller owns the returned chain and must release it
+ * with ``net_buf_unref()``. For a datagram socket one call returns one
+ * datagram, for a stream socket one call returns the data of one
+ * received segment. ``ZSOCK_MSG_PEEK`` is not supported.
+ * This function can only be called from supervisor mode and requires
+ * :kconfig:`CONFIG_NET_SOCKETS_ZEROCOPY`.
+ * @endrst
+ *
+ * @param sock Socket descriptor
+ * @param frags Returned buffer chain, NULL if 0 is returned
+ * @param flags ZSOCK_MSG_DONTWAIT is supported
+ * @param src_addr Source address of the data, or NULL
+ * @param addrlen Length of src_addr, updated on return
+ *
+ * @return Number of bytes received, 0 at end of stream, -1 on error
+ * with errno set.
+ */
+ssize_t zsock_recv_buf(int sock, struct net_buf **frags, int flags,
+		       struct sockaddr *src_addr, socklen_t *addrlen);
+
+/**
+ * @brief Send network buffers without copying them
+ *
+ * @details
+ * @rst
+ * Zero-copy variant of ``zsock_sendto()`` for UDP and TCP sockets. The
+ * fragments are attached to the outgoing packet behind the protocol
+ * headers. On success the caller's reference to ``frags`` is consumed,
+ * on error it is left untouched. A UDP datagram must fit into the
+ * interface MTU, otherwise ``EMSGSIZE`` is returned. TCP keeps its own
+ * copy of the data for retransmission.
+ * This function can only be called from supervisor mode and requires
+ * :kconfig:`CONFIG_NET_SOCKETS_ZEROCOPY`.
+ * @endrst
+ *
+ * @param sock Socket descriptor
+ * @param frags Data to send, allocated from a network TX data pool
+ * @param flags ZSOCK_MSG_DONTWAIT is supported
+ * @param dest_addr Destination address, or NULL for a connected socket
+ * @param addrlen Length of dest_addr
+ *
+ * @return Number of bytes sent, -1 on error with errno set.
+ */
+ssize_t zsock_send_buf(int sock, struct net_buf *frags, int flags,
+		       const struct sockaddr *dest_addr, socklen_t addrlen);
+
 /**
  * @brief Control blocking/non-blocking mode of a socket
  *
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_
+#define ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_
+
+/**
+ * @brief BSD Sockets compatible API
+ * @defgroup bsd_sockets BSD Sockets compatible API
+ * @ingroup networking
+ * @{
+ */
+
+#include <toolchain.h>
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ZSOCK_EPOLL* values are compatible with Linux */
+/** zsock_epoll_ctl: Add a file descriptor to the interest set */
+#define ZSOCK_EPOLL_CTL_ADD 1
+/** zsock_epoll_ctl: Remove a file descriptor from the interest set */
+#define ZSOCK_EPOLL_CTL_DEL 2
+/** zsock_epoll_ctl: Change the events of a registered file descriptor */
+#define ZSOCK_EPOLL_CTL_MOD 3
+
+/** Data available to read, same as ZSOCK_POLLIN */
+#define ZSOCK_EPOLLIN 0x001
+/** Priority data available, same as ZSOCK_POLLPRI */
+#define ZSOCK_EPOLLPRI 0x002
+/** Writing possible, same as ZSOCK_POLLOUT */
+#define ZSOCK_EPOLLOUT 0x004
+/** Error condition, always reported */
+#define ZSOCK_EPOLLERR 0x008
+/** Peer closed connection, always reported */
+#define ZSOCK_EPOLLHUP 0x010
+/** Disable the entry after one event, re-arm with ZSOCK_EPOLL_CTL_MOD */
+#define ZSOCK_EPOLLONESHOT (1U << 30)
+/** Report an entry only when new data arrives (edge triggered) */
+#define ZSOCK_EPOLLET (1U << 31)
+
+/** User data returned with an event */
+typedef union zsock_epoll_data {
+	void *ptr;
+	int fd;
+	uint32_t u32;
+	uint64_t u64;
+} zsock_epoll_data_t;
+
+/** Event registered with zsock_epoll_ctl() and returned by zsock_epoll_wait() */
+struct zsock_epoll_event {
+	uint32_t events;
+	zsock_epoll_data_t data;
+};
+
+/**
+ * @brief Create an epoll instance
+ *
+ * @details
+ * @rst
+ * Allocate a file descriptor for a persistent socket interest set. Unlike
+ * :c:func:`zsock_poll()`, the set is registered once and ready sockets
+ * are queued by the stack as data arrives, so the cost of a wakeup does
+ * not depend on the number of idle descriptors.
+ * The descriptor is released with :c:func:`zsock_close()`.
+ * See `Linux manual page
+ * <https://man7.org/linux/man-pages/man2/epoll_create1.2.html>`__
+ * for a description. No flags are supported.
+ * This function is also exposed as ``epoll_create1()``
+ * if :kconfig:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ */
+__syscall int zsock_epoll_create1(int flags);
+
+/**
+ * @brief Add, modify or remove an entry of an epoll instance
+ *
+ * @details
+ * @rst
+ * See `Linux manual page
+ * <https://man7.org/linux/man-pages/man2/epoll_ctl.2.html>`__
+ * for a description. Only native sockets can be added, other file
+ * descriptors fail with ``EPERM``. Closing a socket removes it from
+ * all epoll instances.
+ * This function is also exposed as ``epoll_ctl()``
+ * if :kconfig:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ */
+__syscall int zsock_epoll_ctl(int epfd, int op, int fd,
+			      struct zsock_epoll_event *event);
+
+/**
+ * @brief Wait for events on an epoll instance
+ *
+ * @details
+ * @rst
+ * See `Linux manual page
+ * <https://man7.org/linux/man-pages/man2/epoll_wait.2.html>`__
+ * for a description. Sockets are always writable, as with
+ * :c:func:`zsock_poll()`.
+ * This function is also exposed as ``epoll_wait()``
+ * if :kconfig:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ */
+__syscall int zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+			       int maxevents, int timeout);
+
+#ifdef CONFIG_NET_SOCKETS_POSIX_NAMES
+
+#define EPOLL_CTL_ADD ZSOCK_EPOLL_CTL_ADD
+#define EPOLL_CTL_DEL ZSOCK_EPOLL_CTL_DEL
+#define EPOLL_CTL_MOD ZSOCK_EPOLL_CTL_MOD
+
+#define EPOLLIN ZSOCK_EPOLLIN
+#define EPOLLPRI ZSOCK_EPOLLPRI
+#define EPOLLOUT ZSOCK_EPOLLOUT
+#define EPOLLERR ZSOCK_EPOLLERR
+#define EPOLLHUP ZSOCK_EPOLLHUP
+#define EPOLLONESHOT ZSOCK_EPOLLONESHOT
+#define EPOLLET ZSOCK_EPOLLET
+
+#define epoll_data_t zsock_epoll_data_t
+#define epoll_event zsock_epoll_event
+
+static inline int epoll_create1(int flags)
+{
+	return zsock_epoll_create1(flags);
+}
+
+static inline int epoll_ctl(int epfd, int op, int fd,
+			    struct zsock_epoll_event *event)
+{
+	return zsock_epoll_ctl(epfd, op, fd, event);
+}
+
+static inline int epoll_wait(int epfd, struct zsock_epoll_event *events,
+			     int maxevents, int timeout)
+{
+	return zsock_epoll_wait(epfd, events, maxevents, timeout);
+}
+
+#endif /* CONFIG_NET_SOCKETS_POSIX_NAMES */
+
+#ifdef __cplusplus
+}
+#endif
+
+#include <syscalls/socket_epoll.h>
+
+/**
+ * @}
+ */
+
+#endif /* ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_ */
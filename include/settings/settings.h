@@ -183,6 +183,34 @@ struct settings_handler_static {
 	 */
 };
 
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+/**
+ * @struct settings_handler_index
+ * Entry of the index of static handlers, sorted by name at initialization.
+ */
+struct settings_handler_index {
+	const struct settings_handler_static *handler;
+};
+
+#if defined(CONFIG_SETTINGS_STATIC_HANDLER_INDEX)
+#define Z_SETTINGS_STATIC_HANDLER_INDEX(_hname)				     \
+	STRUCT_SECTION_ITERABLE(settings_handler_index,			     \
+				settings_handler_index_ ## _hname) = {	     \
+		.handler = &settings_handler_ ## _hname,		     \
+	}
+#else
+#define Z_SETTINGS_STATIC_HANDLER_INDEX(_hname)				     \
+	extern const struct settings_handler_static			     \
+		settings_handler_ ## _hname
+#endif
+
+/**
+ * @endcond
+ */
+
 /**
  * Define a static handler for settings items
  *
@@ -199,6 +227,9 @@ struct settings_handler_static {
 
 #define SETTINGS_STATIC_HANDLER_DEFINE(_hname, _tree, _get, _set, _commit,   \
 				       _export)				     \
+	extern const struct settings_handler_static			     \
+		settings_handler_ ## _hname;				     \
+	Z_SETTINGS_STATIC_HANDLER_INDEX(_hname);			     \
 	const STRUCT_SECTION_ITERABLE(settings_handler_static,		     \
 				      settings_handler_ ## _hname) = {       \
 		.name = _tree,						     \
@@ -333,6 +364,37 @@ int settings_save_one(const char *name, const void *value, size_t val_len);
  */
 int settings_delete(const char *name);
 
+/**
+ * Write a single serialized value to persisted storage later.
+ *
+ * The value is kept in RAM and written by the system work queue after
+ * CONFIG_SETTINGS_DEFERRED_SAVE_DELAY milliseconds, together with the
+ * other pending values. Writing the same item again before that only
+ * replaces the pending value. A value that does not fit in RAM is written
+ * at once with @ref settings_save_one.
+ *
+ * @param name Name/key of the settings item.
+ * @param value Pointer to the value of the settings item, it is copied.
+ * NULL to delete the item.
+ * @param val_len Length of the value.
+ *
+ * @return 0 on success, non-zero on failure.
+ */
+int settings_save_one_deferred(const char *name, const void *value,
+			       size_t val_len);
+
+/**
+ * Write all values pending from @ref settings_save_one_deferred to
+ * persisted storage.
+ *
+ * When this returns successfully all the values saved before the call are in
+ * persisted storage. Values the backend fails to write stay pending, so that
+ * a later flush retries them. Loading settings does this first.
+ *
+ * @return 0 on success, otherwise the first error returned by the backend.
+ */
+int settings_flush(void);
+
 /**
  * Call commit for all settings handler. This should apply all
  * settings which has been set, but not applied yet.
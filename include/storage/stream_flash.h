@@ -21,6 +21,7 @@
  */
 
 #include <stdbool.h>
+#include <kernel.h>
 #include <drivers/flash.h>
 
 #ifdef __cplusplus
@@ -37,6 +38,8 @@ extern "C" {
  * This enables verifying that the data has been correctly stored (for
  * instance by using a SHA function). The write buffer 'buf' provided in
  * stream_flash_init is used as a read buffer for this purpose.
+ * When the stream is double buffered, the callback is invoked from the
+ * stream flash work queue with the buffer being written.
  *
  * @param buf Pointer to the data read.
  * @param len The length of the data read.
@@ -62,6 +65,14 @@ struct stream_flash_ctx {
 #ifdef CONFIG_STREAM_FLASH_ERASE
 	off_t last_erased_page_start_offset; /* Last erased offset */
 #endif
+#ifdef CONFIG_STREAM_FLASH_DOUBLE_BUFFER
+	struct k_work write_work; /* Writes wr_buf from the work queue */
+	struct k_sem write_done; /* Given when no write is in progress */
+	uint8_t *wr_buf; /* Buffer being written, or second buffer */
+	size_t wr_bytes; /* Number of bytes being written from wr_buf */
+	size_t wr_offset; /* Offset wr_buf is written to */
+	int wr_rc; /* Result of the last write */
+#endif
 };
 
 /**
@@ -78,6 +89,10 @@ struct stream_flash_ctx {
  *             of the flash device minus the offset.
  * @param cb Callback to be invoked on completed flash write operations.
  *
+ * A context whose stream was neither flushed nor aborted with
+ * @ref stream_flash_abort must not be initialized again, as a double
+ * buffered write may still be in progress.
+ *
  * @return non-negative on success, negative errno code on fail
  */
 int stream_flash_init(struct stream_flash_ctx *ctx, const struct device *fdev,
@@ -88,6 +103,9 @@ int stream_flash_init(struct stream_flash_ctx *ctx, const struct device *fdev,
  *
  * @note api-tags: pre-kernel-ok isr-ok
  *
+ * When the stream is double buffered, the bytes still being written are
+ * not counted until the next write to the stream.
+ *
  * @param ctx context
  *
  * @return Number of payload bytes written to flash.
@@ -114,6 +132,41 @@ size_t stream_flash_bytes_written(struct stream_flash_ctx *ctx);
 int stream_flash_buffered_write(struct stream_flash_ctx *ctx, const uint8_t *data,
 				size_t len, bool flush);
 
+/**
+ * @brief Give the stream a second write buffer.
+ *
+ * Once the second buffer is set, a buffer that fills up is written to the
+ * flash from the stream flash work queue while the other buffer takes
+ * the incoming data, and stream_flash_buffered_write only waits when
+ * both buffers are full. With CONFIG_STREAM_FLASH_ERASE, the page the
+ * next buffer will be written to is erased right after a write.
+ *
+ * A write error is returned by the next call to
+ * stream_flash_buffered_write. A flush write waits for all data to be
+ * written, so that the stream can then be used or initialized again.
+ * A stream given up before its end must be settled with
+ * @ref stream_flash_abort before the context is initialized again.
+ *
+ * @param ctx context initialized with stream_flash_init
+ * @param buf second write buffer, of the length given to stream_flash_init
+ *
+ * @return non-negative on success, negative errno code on fail
+ */
+int stream_flash_double_buffer_set(struct stream_flash_ctx *ctx, uint8_t *buf);
+
+/**
+ * @brief Abort a stream.
+ *
+ * Drop the data buffered and not written yet. When the stream is double
+ * buffered, wait for the write in progress, if any, to complete. The
+ * context can then be initialized again with @ref stream_flash_init.
+ *
+ * @param ctx context initialized with stream_flash_init
+ *
+ * @return non-negative on success, negative errno code on fail
+ */
+int stream_flash_abort(struct stream_flash_ctx *ctx);
+
 /**
  * @brief Erase the flash page to which a given offset belongs.
  *
@@ -11,6 +11,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <toolchain.h>
+#include <sys/atomic.h>
 
 #ifdef CONFIG_CBPRINTF_LIBC_SUBSTS
 #include <stdio.h>
@@ -344,6 +345,155 @@ int cbprintf(cbprintf_cb out, void *ctx, const char *format, ...);
  */
 int cbvprintf(cbprintf_cb out, void *ctx, const char *format, va_list ap);
 
+/** @brief Pre-parsed element of a format string.
+ *
+ * An element is the literal text preceding a conversion specification and
+ * the parsed specification.
+ */
+struct cbprintf_fmt_entry {
+	/** Length of the literal text. */
+	uint16_t lit_len;
+
+	/** Length of the conversion specification, 0 for the text
+	 * terminating the format string.
+	 */
+	uint16_t spec_len;
+
+	/** Parsed specification, private to the formatter. */
+	uint32_t conv[2];
+};
+
+/** @brief Format string with its pre-parsed conversion specifications.
+ *
+ * The format string is parsed into the table of entries on first use, so
+ * that later formatting only has to convert the values.
+ *
+ * Use @ref CBPRINTF_FMT_DEFINE to define one.
+ */
+struct cbprintf_fmt {
+	/** Format string. */
+	const char *format;
+
+	/** Table of pre-parsed elements. */
+	struct cbprintf_fmt_entry *entries;
+
+	/** Size of the table. */
+	uint16_t max_entries;
+
+	/** Number of elements in the table once parsed. */
+	uint16_t count;
+
+	/** Parsing state, private to the formatter. */
+	atomic_t state;
+};
+
+/** @brief Maximum number of pre-parsed elements of a format string.
+ *
+ * Every conversion specification but a trailing '%' takes at least two
+ * characters, plus one element for the terminating text.
+ *
+ * @param fmt string literal.
+ */
+#define CBPRINTF_FMT_ENTRIES(fmt) (sizeof(fmt) / 2U + 1U)
+
+/** @brief Define a format string to be pre-parsed.
+ *
+ * The table of entries is only reserved with
+ * @kconfig{CONFIG_CBPRINTF_PREPARSED_FMT}, otherwise the format is parsed
+ * on every call.
+ *
+ * @param name name of the struct cbprintf_fmt variable.
+ *
+ * @param fmt string literal.
+ */
+#ifdef CONFIG_CBPRINTF_PREPARSED_FMT
+#define CBPRINTF_FMT_DEFINE(name, fmt)					\
+	static struct cbprintf_fmt_entry				\
+		_CONCAT(name, _entries)[CBPRINTF_FMT_ENTRIES(fmt)];	\
+	static struct cbprintf_fmt name = {				\
+		.format = fmt,						\
+		.entries = _CONCAT(name, _entries),			\
+		.max_entries = CBPRINTF_FMT_ENTRIES(fmt),		\
+	}
+#else
+#define CBPRINTF_FMT_DEFINE(name, fmt)					\
+	static struct cbprintf_fmt name = {				\
+		.format = fmt,						\
+	}
+#endif
+
+/** @brief Dummy function to check the arguments of @ref CBPRINTF_FMT. */
+static inline __printf_like(1, 2)
+void z_cbprintf_fmt_arg_checker(const char *fmt, ...)
+{
+	ARG_UNUSED(fmt);
+}
+
+/** @brief *printf-like output through a callback with a pre-parsed format.
+ *
+ * Equivalent to cbprintf() for a string literal format, which is parsed
+ * only the first time this call site is executed.
+ *
+ * @param out the function used to emit each generated character.
+ *
+ * @param ctx context provided when invoking out
+ *
+ * @param fmt a string literal with characters and conversion specifications.
+ *
+ * @param ... arguments corresponding to the conversion specifications found
+ * within @p fmt.
+ *
+ * @return the number of characters printed, or a negative error value
+ * returned from invoking @p out.
+ */
+#define CBPRINTF_FMT(out, ctx, fmt, ...) ({				\
+	CBPRINTF_FMT_DEFINE(_z_cbprintf_fmt, fmt);			\
+	if (false) {							\
+		z_cbprintf_fmt_arg_checker(fmt, ##__VA_ARGS__);		\
+	}								\
+	cbprintf_fmt(out, ctx, &_z_cbprintf_fmt, ##__VA_ARGS__);	\
+})
+
+/** @brief *printf-like output through a callback with a pre-parsed format.
+ *
+ * @param out the function used to emit each generated character.
+ *
+ * @param ctx context provided when invoking out
+ *
+ * @param fmt format defined with @ref CBPRINTF_FMT_DEFINE.
+ *
+ * @param ... arguments corresponding to the conversion specifications found
+ * within the format.
+ *
+ * @return the number of characters printed, or a negative error value
+ * returned from invoking @p out.
+ */
+int cbprintf_fmt(cbprintf_cb out, void *ctx, struct cbprintf_fmt *fmt, ...);
+
+/** @brief varargs-aware *printf-like output through a callback with a
+ * pre-parsed format.
+ *
+ * The format is parsed on the first call. Formatting falls back to
+ * cbvprintf() while another thread is parsing it, or if it can't be
+ * represented by the table of entries.
+ *
+ * @note Without @kconfig{CONFIG_CBPRINTF_PREPARSED_FMT} this is cbvprintf()
+ * on the format string.
+ *
+ * @param out the function used to emit each generated character.
+ *
+ * @param ctx context provided when invoking out
+ *
+ * @param fmt format defined with @ref CBPRINTF_FMT_DEFINE.
+ *
+ * @param ap a reference to the values to be converted.
+ *
+ * @return the number of characters generated, or a negative error value
+ * returned from invoking @p out.
+ */
+int cbvprintf_fmt(cbprintf_cb out, void *ctx, struct cbprintf_fmt *fmt,
+		  va_list ap);
+
 #ifdef CONFIG_CBPRINTF_LIBC_SUBSTS
 
 /** @brief fprintf using Zephyrs cbprintf infrastructure.
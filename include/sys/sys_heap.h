@@ -120,6 +120,18 @@ void *sys_heap_aligned_alloc(struct sys_heap *heap, size_t align, size_t bytes);
  */
 void sys_heap_free(struct sys_heap *heap, void *mem);
 
+/** @brief Return the usable size of an allocated block
+ *
+ * Returns the number of bytes that can be used at the given pointer,
+ * which is at least the size requested when the block was allocated
+ * and may be larger due to chunk rounding.
+ *
+ * @param heap Heap containing the block
+ * @param mem A pointer previously returned from sys_heap_alloc()
+ * @return Usable size of the block in bytes
+ */
+size_t sys_heap_usable_size(struct sys_heap *heap, void *mem);
+
 /** @brief Expand the size of an existing allocation
  *
  * Returns a pointer to a new memory region with the same contents,
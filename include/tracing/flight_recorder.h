@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_TRACING_FLIGHT_RECORDER_H_
+#define ZEPHYR_INCLUDE_TRACING_FLIGHT_RECORDER_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Tracing Flight Recorder APIs
+ * @defgroup tracing_flight_recorder_apis Tracing Flight Recorder APIs
+ * @ingroup tracing_apis
+ *
+ * The flight recorder backend keeps the most recent tracing packets in a
+ * ring, overwriting the oldest ones. It is frozen, and optionally dumped
+ * to the console, on a fatal error. Its content is also part of core
+ * dumps.
+ * @{
+ */
+
+/**
+ * @typedef tracing_flight_recorder_dump_cb_t
+ * @brief Callback receiving the content of the flight recorder.
+ *
+ * @param data Part of the recorded data, oldest first.
+ * @param length Length of the data.
+ * @param user_data User data given to tracing_flight_recorder_dump().
+ */
+typedef void (*tracing_flight_recorder_dump_cb_t)(const uint8_t *data,
+						  size_t length,
+						  void *user_data);
+
+/**
+ * @brief Stop recording, keeping the recorded packets.
+ */
+void tracing_flight_recorder_freeze(void);
+
+/**
+ * @brief Resume recording after tracing_flight_recorder_freeze().
+ */
+void tracing_flight_recorder_resume(void);
+
+/**
+ * @brief Check whether the flight recorder is frozen.
+ *
+ * @return true if frozen, false if recording.
+ */
+bool tracing_flight_recorder_is_frozen(void);
+
+/**
+ * @brief Get the recorded packets.
+ *
+ * The recorder is frozen while @p cb is called with the recorded
+ * packets, oldest first, and is then resumed unless it was frozen
+ * already.
+ *
+ * @param cb Callback to call with the recorded data.
+ * @param user_data User data passed to @p cb.
+ *
+ * @return Number of bytes passed to @p cb.
+ */
+size_t tracing_flight_recorder_dump(tracing_flight_recorder_dump_cb_t cb,
+				    void *user_data);
+
+/**
+ * @brief Freeze the flight recorder and print its content.
+ *
+ * The packets are printed with printk() in hexadecimal, in lines
+ * prefixed with "#TR:" between a "#TR:BEGIN#" and a "#TR:END#" line,
+ * which scripts/tracing/parse_flight_recorder.py converts back to a
+ * trace.
+ */
+void tracing_flight_recorder_trigger(void);
+
+/**
+ * @}
+ */
+
+#ifdef CONFIG_TRACING_BACKEND_FLIGHT_RECORDER
+void z_tracing_flight_recorder_fatal_error(void);
+void z_tracing_flight_recorder_coredump(void);
+#else
+static inline void z_tracing_flight_recorder_fatal_error(void)
+{
+}
+
+static inline void z_tracing_flight_recorder_coredump(void)
+{
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_TRACING_FLIGHT_RECORDER_H_ */
@@ -72,6 +72,20 @@ void tracing_format_raw_data(uint8_t *data, uint32_t length);
  */
 void tracing_format_data(tracing_data_t *tracing_data_array, uint32_t count);
 
+/**
+ * @brief Tracing a message in raw data format, with a timestamp.
+ *
+ * The message is prefixed with the number of cycles elapsed since the
+ * previous timestamped message of the same buffer, as a variable length
+ * integer of 7 bits per byte, least significant first, with the top bit
+ * set on all bytes but the last. The timestamp is taken when the message
+ * is put in the buffer, so that messages of a buffer are in time order.
+ *
+ * @param data   Raw data to be traced.
+ * @param length Raw data length.
+ */
+void tracing_format_timed_data(uint8_t *data, uint32_t length);
+
 #ifdef __cplusplus
 }
 #endif
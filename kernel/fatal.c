@@ -14,6 +14,7 @@
 #include <logging/log.h>
 #include <fatal.h>
 #include <debug/coredump.h>
+#include <tracing/flight_recorder.h>
 
 LOG_MODULE_DECLARE(os, CONFIG_KERNEL_LOG_LEVEL);
 
@@ -122,6 +123,8 @@ void z_fatal_error(unsigned int reason, const z_arch_esf_t *esf)
 	LOG_ERR("Current thread: %p (%s)", thread,
 		log_strdup(thread_name_get(thread)));
 
+	z_tracing_flight_recorder_fatal_error();
+
 	coredump(reason, esf, thread);
 
 	k_sys_fatal_error_handler(reason, esf);
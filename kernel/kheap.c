@@ -9,11 +9,15 @@
 #include <wait_q.h>
 #include <init.h>
 #include <linker/linker-defs.h>
+#include <string.h>
 
 void k_heap_init(struct k_heap *h, void *mem, size_t bytes)
 {
 	z_waitq_init(&h->wait_q);
 	sys_heap_init(&h->heap, mem, bytes);
+#ifdef CONFIG_HEAP_CACHE
+	h->cache = NULL;
+#endif
 
 	SYS_PORT_TRACING_OBJ_INIT(k_heap, h);
 }
@@ -61,13 +65,334 @@ SYS_INIT(statics_init, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
 SYS_INIT(statics_init, POST_KERNEL, 0);
 #endif /* CONFIG_DEMAND_PAGING && !CONFIG_LINKER_GENERIC_SECTIONS_PRESENT_AT_BOOT */
 
+#ifdef CONFIG_HEAP_CACHE
+
+/* Size classes are powers of two from 16 bytes up. The magazines of a
+ * CPU are protected by their own lock, which only that CPU takes on the
+ * fast paths, so these need no heap lock. Moving blocks between a
+ * magazine and the heap happens in the regular paths below, which hold
+ * the heap lock and then take the magazine lock.
+ */
+#define CACHE_MIN_SHIFT 4
+#define CACHE_CLASS_SIZE(cls) ((size_t)1 << (CACHE_MIN_SHIFT + (cls)))
+#define CACHE_BATCH (CONFIG_HEAP_CACHE_DEPTH / 2)
+
+/* Any magazines may be used under their lock, the thread moving to
+ * another CPU before taking it only costs some contention.
+ */
+static inline struct z_heap_cache_cpu *cache_cpu_lock(struct k_heap *h,
+						      k_spinlock_key_t *key)
+{
+	struct z_heap_cache_cpu *cpu = &h->cache->cpus[_current_cpu->id];
+
+	*key = k_spin_lock(&cpu->lock);
+
+	return cpu;
+}
+
+/* Class serving an allocation, or -1 if it must go to the heap. Blocks
+ * are only cached with the natural sys_heap alignment.
+ */
+static int cache_alloc_class(struct k_heap *h, size_t align, size_t bytes)
+{
+	int cls;
+
+	if (h->cache == NULL || align > sizeof(void *) ||
+	    (align & (align - 1)) != 0 || bytes == 0) {
+		return -1;
+	}
+
+	for (cls = 0; cls < CONFIG_HEAP_CACHE_CLASSES; cls++) {
+		if (bytes <= CACHE_CLASS_SIZE(cls)) {
+			return cls;
+		}
+	}
+
+	return -1;
+}
+
+/* Class a freed block can be cached in, or -1. Blocks much larger
+ * than the class would waste memory and go back to the heap.
+ */
+static int cache_free_class(struct k_heap *h, void *mem)
+{
+	size_t usable;
+	int cls;
+
+	if (h->cache == NULL || mem == NULL ||
+	    ((uintptr_t)mem & (sizeof(void *) - 1)) != 0) {
+		return -1;
+	}
+
+	usable = sys_heap_usable_size(&h->heap, mem);
+
+	for (cls = 0; cls < CONFIG_HEAP_CACHE_CLASSES; cls++) {
+		if (usable < CACHE_CLASS_SIZE(cls + 1)) {
+			return usable >= CACHE_CLASS_SIZE(cls) ? cls : -1;
+		}
+	}
+
+	return -1;
+}
+
+static void *cache_get(struct k_heap *h, int cls)
+{
+	k_spinlock_key_t key;
+	struct z_heap_cache_cpu *cpu = cache_cpu_lock(h, &key);
+	struct z_heap_cache_mag *mag = &cpu->mags[cls];
+	void *mem = NULL;
+
+	if (mag->count > 0) {
+		mem = mag->slots[--mag->count];
+		cpu->alloc_hits++;
+	} else {
+		cpu->alloc_misses++;
+	}
+
+	k_spin_unlock(&cpu->lock, key);
+
+	return mem;
+}
+
+static bool cache_put(struct k_heap *h, int cls, void *mem)
+{
+	k_spinlock_key_t key;
+	struct z_heap_cache_cpu *cpu = cache_cpu_lock(h, &key);
+	struct z_heap_cache_mag *mag = &cpu->mags[cls];
+	bool cached = false;
+
+	/* Blocked allocators need the memory in the heap. They count
+	 * themselves before draining the magazines, under their locks, so
+	 * a block cached here is either seen by the drain or not cached.
+	 */
+	if (atomic_get(&h->cache->waiters) == 0 &&
+	    mag->count < CONFIG_HEAP_CACHE_DEPTH) {
+		mag->slots[mag->count++] = mem;
+		cpu->free_hits++;
+		cached = true;
+	}
+
+	k_spin_unlock(&cpu->lock, key);
+
+	return cached;
+}
+
+/* Called with h->lock held. Returns one block of the class and
+ * stocks the magazine with up to a batch more.
+ */
+static void *cache_refill(struct k_heap *h, int cls)
+{
+	k_spinlock_key_t key;
+	struct z_heap_cache_cpu *cpu;
+	struct z_heap_cache_mag *mag;
+	size_t size = CACHE_CLASS_SIZE(cls);
+	void *ret = sys_heap_aligned_alloc(&h->heap, sizeof(void *), size);
+
+	if (ret == NULL) {
+		return NULL;
+	}
+
+	cpu = cache_cpu_lock(h, &key);
+	mag = &cpu->mags[cls];
+
+	while (mag->count < CACHE_BATCH) {
+		void *mem = sys_heap_aligned_alloc(&h->heap, sizeof(void *),
+						   size);
+
+		if (mem == NULL) {
+			break;
+		}
+
+		mag->slots[mag->count++] = mem;
+	}
+
+	cpu->refills++;
+
+	k_spin_unlock(&cpu->lock, key);
+
+	return ret;
+}
+
+/* Called with h->lock held. Returns the oldest batch of a full
+ * magazine to the heap.
+ */
+static void cache_trim(struct k_heap *h, int cls)
+{
+	k_spinlock_key_t key;
+	struct z_heap_cache_cpu *cpu = cache_cpu_lock(h, &key);
+	struct z_heap_cache_mag *mag = &cpu->mags[cls];
+	int i;
+
+	if (mag->count < CONFIG_HEAP_CACHE_DEPTH) {
+		k_spin_unlock(&cpu->lock, key);
+		return;
+	}
+
+	for (i = 0; i < CACHE_BATCH; i++) {
+		sys_heap_free(&h->heap, mag->slots[i]);
+	}
+
+	mag->count -= CACHE_BATCH;
+	memmove(&mag->slots[0], &mag->slots[CACHE_BATCH],
+		mag->count * sizeof(mag->slots[0]));
+
+	cpu->flushes++;
+
+	k_spin_unlock(&cpu->lock, key);
+}
+
+/* Called with h->lock held. Returns all blocks of a CPU to the heap,
+ * and the number of blocks freed.
+ */
+static int cache_drain_cpu(struct k_heap *h, struct z_heap_cache_cpu *cpu)
+{
+	k_spinlock_key_t key = k_spin_lock(&cpu->lock);
+	int cls, freed = 0;
+
+	for (cls = 0; cls < CONFIG_HEAP_CACHE_CLASSES; cls++) {
+		struct z_heap_cache_mag *mag = &cpu->mags[cls];
+
+		while (mag->count > 0) {
+			sys_heap_free(&h->heap, mag->slots[--mag->count]);
+			freed++;
+		}
+	}
+
+	if (freed > 0) {
+		cpu->flushes++;
+	}
+
+	k_spin_unlock(&cpu->lock, key);
+
+	return freed;
+}
+
+/* Called with h->lock held. Returns the blocks of all CPUs to the
+ * heap, and the number of blocks freed.
+ */
+static int cache_drain(struct k_heap *h)
+{
+	int i, freed = 0;
+
+	for (i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		freed += cache_drain_cpu(h, &h->cache->cpus[i]);
+	}
+
+	return freed;
+}
+
+void k_heap_cache_attach(struct k_heap *h, struct k_heap_cache *cache)
+{
+	__ASSERT(h->cache == NULL, "heap %p already has a cache", h);
+
+	(void)memset(cache, 0, sizeof(*cache));
+	h->cache = cache;
+}
+
+void k_heap_cache_flush(struct k_heap *h)
+{
+	k_spinlock_key_t key;
+	int freed;
+
+	if (h->cache == NULL) {
+		return;
+	}
+
+	key = k_spin_lock(&h->lock);
+
+	freed = cache_drain_cpu(h, &h->cache->cpus[_current_cpu->id]);
+
+	if ((IS_ENABLED(CONFIG_MULTITHREADING)) && (freed > 0) &&
+	    (z_unpend_all(&h->wait_q) != 0)) {
+		z_reschedule(&h->lock, key);
+	} else {
+		k_spin_unlock(&h->lock, key);
+	}
+}
+
+int k_heap_cache_stats_get(struct k_heap *h, struct k_heap_cache_stats *stats)
+{
+	int i, cls;
+
+	if (h->cache == NULL) {
+		return -EINVAL;
+	}
+
+	(void)memset(stats, 0, sizeof(*stats));
+
+	/* Counters of other CPUs are read without synchronization, the
+	 * result is a snapshot good enough for monitoring.
+	 */
+	for (i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct z_heap_cache_cpu *cpu = &h->cache->cpus[i];
+
+		stats->alloc_hits += cpu->alloc_hits;
+		stats->alloc_misses += cpu->alloc_misses;
+		stats->free_hits += cpu->free_hits;
+		stats->refills += cpu->refills;
+		stats->flushes += cpu->flushes;
+
+		for (cls = 0; cls < CONFIG_HEAP_CACHE_CLASSES; cls++) {
+			stats->cached_bytes += cpu->mags[cls].count *
+				CACHE_CLASS_SIZE(cls);
+		}
+	}
+
+	return 0;
+}
+
+#endif /* CONFIG_HEAP_CACHE */
+
+/* Called with h->lock held */
+static void *heap_alloc_locked(struct k_heap *h, int cls, size_t align,
+			       size_t bytes)
+{
+#ifdef CONFIG_HEAP_CACHE
+	void *ret = NULL;
+
+	if (cls >= 0) {
+		ret = cache_refill(h, cls);
+	}
+
+	if (ret == NULL) {
+		ret = sys_heap_aligned_alloc(&h->heap, align, bytes);
+	}
+
+	/* Blocks cached by the CPUs may be what is missing */
+	if (ret == NULL && h->cache != NULL && cache_drain(h) > 0) {
+		ret = sys_heap_aligned_alloc(&h->heap, align, bytes);
+	}
+
+	return ret;
+#else
+	ARG_UNUSED(cls);
+
+	return sys_heap_aligned_alloc(&h->heap, align, bytes);
+#endif
+}
+
 void *k_heap_aligned_alloc(struct k_heap *h, size_t align, size_t bytes,
 			k_timeout_t timeout)
 {
 	int64_t now;
 	int64_t end = (int64_t)sys_clock_timeout_end_calc(timeout);
 	void *ret = NULL;
-	k_spinlock_key_t key = k_spin_lock(&h->lock);
+	int cls = -1;
+	k_spinlock_key_t key;
+
+#ifdef CONFIG_HEAP_CACHE
+	cls = cache_alloc_class(h, align, bytes);
+	if (cls >= 0) {
+		ret = cache_get(h, cls);
+		if (ret != NULL) {
+			SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_heap, aligned_alloc, h, timeout);
+			SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_heap, aligned_alloc, h, timeout, ret);
+			return ret;
+		}
+	}
+#endif
+
+	key = k_spin_lock(&h->lock);
 
 	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_heap, aligned_alloc, h, timeout);
 
@@ -76,7 +401,7 @@ void *k_heap_aligned_alloc(struct k_heap *h, size_t align, size_t bytes,
 	bool blocked_alloc = false;
 
 	while (ret == NULL) {
-		ret = sys_heap_aligned_alloc(&h->heap, align, bytes);
+		ret = heap_alloc_locked(h, cls, align, bytes);
 
 		now = sys_clock_tick_get();
 		if (!(IS_ENABLED(CONFIG_MULTITHREADING)) ||
@@ -88,6 +413,16 @@ void *k_heap_aligned_alloc(struct k_heap *h, size_t align, size_t bytes,
 			blocked_alloc = true;
 
 			SYS_PORT_TRACING_OBJ_FUNC_BLOCKING(k_heap, aligned_alloc, h, timeout);
+
+#ifdef CONFIG_HEAP_CACHE
+			/* Keep frees from caching blocks while we wait, and
+			 * retry with the blocks cached until now.
+			 */
+			if (h->cache != NULL) {
+				atomic_inc(&h->cache->waiters);
+				continue;
+			}
+#endif
 		} else {
 			/**
 			 * @todo	Trace attempt to avoid empty trace segments
@@ -99,6 +434,12 @@ void *k_heap_aligned_alloc(struct k_heap *h, size_t align, size_t bytes,
 		key = k_spin_lock(&h->lock);
 	}
 
+#ifdef CONFIG_HEAP_CACHE
+	if (blocked_alloc && h->cache != NULL) {
+		atomic_dec(&h->cache->waiters);
+	}
+#endif
+
 	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_heap, aligned_alloc, h, timeout, ret);
 
 	k_spin_unlock(&h->lock, key);
@@ -118,10 +459,28 @@ void *k_heap_alloc(struct k_heap *h, size_t bytes, k_timeout_t timeout)
 
 void k_heap_free(struct k_heap *h, void *mem)
 {
-	k_spinlock_key_t key = k_spin_lock(&h->lock);
+	k_spinlock_key_t key;
+
+#ifdef CONFIG_HEAP_CACHE
+	int cls = cache_free_class(h, mem);
+
+	if (cls >= 0 && cache_put(h, cls, mem)) {
+		SYS_PORT_TRACING_OBJ_FUNC(k_heap, free, h);
+		return;
+	}
+#endif
+
+	key = k_spin_lock(&h->lock);
 
 	sys_heap_free(&h->heap, mem);
 
+#ifdef CONFIG_HEAP_CACHE
+	/* The local magazine was full, make room for the next frees */
+	if (cls >= 0) {
+		cache_trim(h, cls);
+	}
+#endif
+
 	SYS_PORT_TRACING_OBJ_FUNC(k_heap, free, h);
 	if ((IS_ENABLED(CONFIG_MULTITHREADING)) && (z_unpend_all(&h->wait_q) != 0)) {
 		z_reschedule(&h->lock, key);
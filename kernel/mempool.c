@@ -8,6 +8,7 @@
 #include <string.h>
 #include <sys/math_extras.h>
 #include <sys/util.h>
+#include <init.h>
 
 static void *z_heap_aligned_alloc(struct k_heap *heap, size_t align, size_t size)
 {
@@ -62,6 +63,22 @@ void k_free(void *ptr)
 K_HEAP_DEFINE(_system_heap, CONFIG_HEAP_MEM_POOL_SIZE);
 #define _SYSTEM_HEAP (&_system_heap)
 
+#ifdef CONFIG_HEAP_MEM_POOL_CACHE
+static struct k_heap_cache system_heap_cache;
+
+static int system_heap_cache_init(const struct device *unused)
+{
+	ARG_UNUSED(unused);
+
+	k_heap_cache_attach(_SYSTEM_HEAP, &system_heap_cache);
+
+	return 0;
+}
+
+/* After the heap itself, including its late init with demand paging */
+SYS_INIT(system_heap_cache_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+#endif
+
 void *k_aligned_alloc(size_t align, size_t size)
 {
 	__ASSERT(align / sizeof(void *) >= 1
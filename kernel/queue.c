@@ -351,6 +351,50 @@ void *z_impl_k_queue_get(struct k_queue *queue, k_timeout_t timeout)
 	return (ret != 0) ? NULL : _current->base.swap_data;
 }
 
+void *k_queue_get_list(struct k_queue *queue, k_timeout_t timeout)
+{
+	k_spinlock_key_t key = k_spin_lock(&queue->lock);
+	void *head;
+
+	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_queue, get_list, queue, timeout);
+
+	if (likely(!sys_sflist_is_empty(&queue->data_q))) {
+		/* Items queued without allocation carry no flags, so the
+		 * sflist links double as a NULL-terminated singly-linked
+		 * list which can be handed over as a whole.
+		 */
+		head = sys_sflist_peek_head(&queue->data_q);
+		sys_sflist_init(&queue->data_q);
+		k_spin_unlock(&queue->lock, key);
+
+		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_queue, get_list, queue, timeout, head);
+
+		return head;
+	}
+
+	SYS_PORT_TRACING_OBJ_FUNC_BLOCKING(k_queue, get_list, queue, timeout);
+
+	if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		k_spin_unlock(&queue->lock, key);
+
+		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_queue, get_list, queue, timeout, NULL);
+
+		return NULL;
+	}
+
+	int ret = z_pend_curr(&queue->lock, key, &queue->wait_q, timeout);
+
+	head = (ret != 0) ? NULL : _current->base.swap_data;
+	if (head != NULL) {
+		/* Handed over directly, never linked into data_q */
+		*(void **)head = NULL;
+	}
+
+	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_queue, get_list, queue, timeout, head);
+
+	return head;
+}
+
 bool k_queue_remove(struct k_queue *queue, void *data)
 {
 	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_queue, remove, queue);
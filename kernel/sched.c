@@ -16,6 +16,7 @@
 #include <kernel_internal.h>
 #include <logging/log.h>
 #include <sys/atomic.h>
+#include <sys/math_extras.h>
 LOG_MODULE_DECLARE(os, CONFIG_KERNEL_LOG_LEVEL);
 
 #if defined(CONFIG_SCHED_DUMB)
@@ -195,6 +196,143 @@ static ALWAYS_INLINE void z_priq_dumb_add(sys_dlist_t *pq,
 	sys_dlist_append(pq, &thread->base.qnode_dlist);
 }
 
+static inline bool is_aborting(struct k_thread *thread)
+{
+	return (thread->base.thread_state & _THREAD_ABORTING) != 0U;
+}
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+/* Each CPU owns a run queue, protected by its own runq_lock[].  The
+ * lock nests inside sched_spinlock (which still serializes thread
+ * state changes) and no two run queue locks are ever held at once.
+ * A thread is queued on the CPU it last ran on, if its mask still
+ * allows it, which keeps it cache-warm.  A CPU only picks from its
+ * own queue; when that queue is empty and the CPU would otherwise go
+ * idle, it steals the best thread it may run from the other CPUs.
+ * Priority order is thus kept per CPU, not across CPUs: a thread
+ * queued behind a busy CPU waits for that CPU unless some other CPU
+ * runs out of work.
+ */
+static struct k_spinlock runq_lock[CONFIG_MP_NUM_CPUS];
+
+static ALWAYS_INLINE uint8_t runq_home_cpu(struct k_thread *thread)
+{
+	uint8_t cpu = thread->base.cpu;
+
+#ifdef CONFIG_SCHED_CPU_MASK
+	if ((thread->base.cpu_mask & BIT(cpu)) == 0U) {
+		__ASSERT(thread->base.cpu_mask != 0U, "");
+		cpu = (uint8_t)u32_count_trailing_zeros(thread->base.cpu_mask);
+	}
+#endif
+	return cpu;
+}
+
+static ALWAYS_INLINE void runq_add(struct k_thread *thread)
+{
+	uint8_t id = runq_home_cpu(thread);
+	k_spinlock_key_t key = k_spin_lock(&runq_lock[id]);
+
+	thread->base.runq_cpu = id;
+	_priq_run_add(&_kernel.cpus[id].ready_q.runq, thread);
+	k_spin_unlock(&runq_lock[id], key);
+}
+
+static ALWAYS_INLINE void runq_remove(struct k_thread *thread)
+{
+	uint8_t id = thread->base.runq_cpu;
+	k_spinlock_key_t key = k_spin_lock(&runq_lock[id]);
+
+	_priq_run_remove(&_kernel.cpus[id].ready_q.runq, thread);
+	k_spin_unlock(&runq_lock[id], key);
+}
+
+static ALWAYS_INLINE struct k_thread *runq_cpu_best(uint8_t id)
+{
+	k_spinlock_key_t key = k_spin_lock(&runq_lock[id]);
+	struct k_thread *thread;
+
+	/* With CPU masks the DUMB backend walks past threads we may
+	 * not run, see _priq_dumb_mask_best()
+	 */
+	thread = _priq_run_best(&_kernel.cpus[id].ready_q.runq);
+
+	k_spin_unlock(&runq_lock[id], key);
+	return thread;
+}
+
+static ALWAYS_INLINE struct k_thread *runq_best(void)
+{
+	uint8_t id = _current_cpu->id;
+	struct k_thread *best = runq_cpu_best(id);
+
+	/* Only steal when this CPU would otherwise go idle */
+	if ((best != NULL) || (!z_is_idle_thread_object(_current) &&
+			       !is_aborting(_current) &&
+			       !z_is_thread_prevented_from_running(_current))) {
+		return best;
+	}
+
+	/* Start at the next CPU so that idle CPUs don't all pile
+	 * onto CPU 0
+	 */
+	for (uint8_t n = 1; n < CONFIG_MP_NUM_CPUS; n++) {
+		uint8_t i = (uint8_t)((id + n) % CONFIG_MP_NUM_CPUS);
+		struct k_thread *t = runq_cpu_best(i);
+
+		if ((t != NULL) &&
+		    ((best == NULL) || (z_sched_prio_cmp(t, best) > 0))) {
+			best = t;
+		}
+	}
+
+	return best;
+}
+
+/* Lockless check, on interrupt exit, that _current keeps the CPU.
+ * Only this CPU's run queue lock is taken, so interrupts that don't
+ * lead to a context switch never touch sched_spinlock.  Thread state
+ * is read without the scheduler lock: a concurrent change made on
+ * another CPU is followed by an IPI (or the next interrupt), whose
+ * exit path then sees it and takes the slow path.
+ */
+static ALWAYS_INLINE bool runq_keep_current(void)
+{
+	struct k_thread *best;
+
+	if (z_is_idle_thread_object(_current) || _current_cpu->swap_ok ||
+	    is_aborting(_current) ||
+	    z_is_thread_prevented_from_running(_current)) {
+		return false;
+	}
+
+#if (CONFIG_NUM_METAIRQ_PRIORITIES > 0) && (CONFIG_NUM_COOP_PRIORITIES > 0)
+	if (_current_cpu->metairq_preempted != NULL) {
+		return false;
+	}
+#endif
+
+	best = runq_cpu_best(_current_cpu->id);
+
+	return (best == NULL) || (z_sched_prio_cmp(_current, best) >= 0);
+}
+#else
+static ALWAYS_INLINE void runq_add(struct k_thread *thread)
+{
+	_priq_run_add(&_kernel.ready_q.runq, thread);
+}
+
+static ALWAYS_INLINE void runq_remove(struct k_thread *thread)
+{
+	_priq_run_remove(&_kernel.ready_q.runq, thread);
+}
+
+static ALWAYS_INLINE struct k_thread *runq_best(void)
+{
+	return _priq_run_best(&_kernel.ready_q.runq);
+}
+#endif /* CONFIG_SCHED_CPU_RUNQ */
+
 /* _current is never in the run queue until context switch on
  * SMP configurations, see z_requeue_current()
  */
@@ -203,12 +341,11 @@ static inline bool should_queue_thread(struct k_thread *th)
 	return !(IS_ENABLED(CONFIG_SMP)) || (th != _current);
 }
 
-static ALWAYS_INLINE void queue_thread(void *pq,
-				       struct k_thread *thread)
+static ALWAYS_INLINE void queue_thread(struct k_thread *thread)
 {
 	thread->base.thread_state |= _THREAD_QUEUED;
 	if (should_queue_thread(thread)) {
-		_priq_run_add(pq, thread);
+		runq_add(thread);
 	}
 #ifdef CONFIG_SMP
 	if (thread == _current) {
@@ -218,12 +355,11 @@ static ALWAYS_INLINE void queue_thread(void *pq,
 #endif
 }
 
-static ALWAYS_INLINE void dequeue_thread(void *pq,
-					 struct k_thread *thread)
+static ALWAYS_INLINE void dequeue_thread(struct k_thread *thread)
 {
 	thread->base.thread_state &= (uint8_t)~_THREAD_QUEUED;
 	if (should_queue_thread(thread)) {
-		_priq_run_remove(pq, thread);
+		runq_remove(thread);
 	}
 }
 
@@ -237,21 +373,16 @@ static ALWAYS_INLINE void dequeue_thread(void *pq,
 void z_requeue_current(struct k_thread *curr)
 {
 	if (z_is_thread_queued(curr)) {
-		_priq_run_add(&_kernel.ready_q.runq, curr);
+		runq_add(curr);
 	}
 }
 #endif
 
-static inline bool is_aborting(struct k_thread *thread)
-{
-	return (thread->base.thread_state & _THREAD_ABORTING) != 0U;
-}
-
 static ALWAYS_INLINE struct k_thread *next_up(void)
 {
 	struct k_thread *thread;
 
-	thread = _priq_run_best(&_kernel.ready_q.runq);
+	thread = runq_best();
 
 #if (CONFIG_NUM_METAIRQ_PRIORITIES > 0) && (CONFIG_NUM_COOP_PRIORITIES > 0)
 	/* MetaIRQs must always attempt to return back to a
@@ -317,12 +448,12 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 	/* Put _current back into the queue */
 	if ((thread != _current) && active &&
 		!z_is_idle_thread_object(_current) && !queued) {
-		queue_thread(&_kernel.ready_q.runq, _current);
+		queue_thread(_current);
 	}
 
 	/* Take the new _current out of the queue */
 	if (z_is_thread_queued(thread)) {
-		dequeue_thread(&_kernel.ready_q.runq, thread);
+		dequeue_thread(thread);
 	}
 
 	_current_cpu->swap_ok = false;
@@ -333,9 +464,9 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 static void move_thread_to_end_of_prio_q(struct k_thread *thread)
 {
 	if (z_is_thread_queued(thread)) {
-		dequeue_thread(&_kernel.ready_q.runq, thread);
+		dequeue_thread(thread);
 	}
-	queue_thread(&_kernel.ready_q.runq, thread);
+	queue_thread(thread);
 	update_cache(thread == _current);
 }
 
@@ -503,7 +634,7 @@ static void ready_thread(struct k_thread *thread)
 	if (!z_is_thread_queued(thread) && z_is_thread_ready(thread)) {
 		SYS_PORT_TRACING_OBJ_FUNC(k_thread, sched_ready, thread);
 
-		queue_thread(&_kernel.ready_q.runq, thread);
+		queue_thread(thread);
 		update_cache(false);
 #if defined(CONFIG_SMP) &&  defined(CONFIG_SCHED_IPI_SUPPORTED)
 		arch_sched_ipi();
@@ -549,7 +680,7 @@ void z_impl_k_thread_suspend(k_tid_t thread)
 
 	LOCKED(&sched_spinlock) {
 		if (z_is_thread_queued(thread)) {
-			dequeue_thread(&_kernel.ready_q.runq, thread);
+			dequeue_thread(thread);
 		}
 		z_mark_thread_as_suspended(thread);
 		update_cache(thread == _current);
@@ -610,7 +741,7 @@ static _wait_q_t *pended_on_thread(struct k_thread *thread)
 static void unready_thread(struct k_thread *thread)
 {
 	if (z_is_thread_queued(thread)) {
-		dequeue_thread(&_kernel.ready_q.runq, thread);
+		dequeue_thread(thread);
 	}
 	update_cache(thread == _current);
 }
@@ -773,9 +904,9 @@ bool z_set_prio(struct k_thread *thread, int prio)
 		if (need_sched) {
 			/* Don't requeue on SMP if it's the running thread */
 			if (!(IS_ENABLED(CONFIG_SMP)) || z_is_thread_queued(thread)) {
-				dequeue_thread(&_kernel.ready_q.runq, thread);
+				dequeue_thread(thread);
 				thread->base.prio = (int8_t)prio;
-				queue_thread(&_kernel.ready_q.runq, thread);
+				queue_thread(thread);
 			} else {
 				thread->base.prio = (int8_t)prio;
 			}
@@ -899,6 +1030,12 @@ void *z_get_next_switch_handle(void *interrupted)
 #ifdef CONFIG_SMP
 	void *ret = NULL;
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	if (runq_keep_current()) {
+		return interrupted;
+	}
+#endif
+
 	LOCKED(&sched_spinlock) {
 		struct k_thread *old_thread = _current, *new_thread;
 
@@ -934,8 +1071,7 @@ void *z_get_next_switch_handle(void *interrupted)
 			 * will not return into it.
 			 */
 			if (z_is_thread_queued(old_thread)) {
-				_priq_run_add(&_kernel.ready_q.runq,
-					      old_thread);
+				runq_add(old_thread);
 			}
 		}
 		old_thread->switch_handle = interrupted;
@@ -1098,14 +1234,14 @@ int z_unpend_all(_wait_q_t *wait_q)
 	return need_sched;
 }
 
-void z_sched_init(void)
+static void init_ready_q(struct _ready_q *rq)
 {
 #ifdef CONFIG_SCHED_DUMB
-	sys_dlist_init(&_kernel.ready_q.runq);
+	sys_dlist_init(&rq->runq);
 #endif
 
 #ifdef CONFIG_SCHED_SCALABLE
-	_kernel.ready_q.runq = (struct _priq_rb) {
+	rq->runq = (struct _priq_rb) {
 		.tree = {
 			.lessthan_fn = z_priq_rb_lessthan,
 		}
@@ -1113,9 +1249,20 @@ void z_sched_init(void)
 #endif
 
 #ifdef CONFIG_SCHED_MULTIQ
-	for (int i = 0; i < ARRAY_SIZE(_kernel.ready_q.runq.queues); i++) {
-		sys_dlist_init(&_kernel.ready_q.runq.queues[i]);
+	for (int i = 0; i < ARRAY_SIZE(rq->runq.queues); i++) {
+		sys_dlist_init(&rq->runq.queues[i]);
+	}
+#endif
+}
+
+void z_sched_init(void)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		init_ready_q(&_kernel.cpus[i].ready_q);
 	}
+#else
+	init_ready_q(&_kernel.ready_q);
 #endif
 
 #ifdef CONFIG_TIMESLICING
@@ -1175,8 +1322,8 @@ void z_impl_k_thread_deadline_set(k_tid_t tid, int deadline)
 	LOCKED(&sched_spinlock) {
 		thread->base.prio_deadline = k_cycle_get_32() + deadline;
 		if (z_is_thread_queued(thread)) {
-			dequeue_thread(&_kernel.ready_q.runq, thread);
-			queue_thread(&_kernel.ready_q.runq, thread);
+			dequeue_thread(thread);
+			queue_thread(thread);
 		}
 	}
 }
@@ -1207,10 +1354,9 @@ void z_impl_k_yield(void)
 
 	if (!(IS_ENABLED(CONFIG_SMP)) ||
 	    z_is_thread_queued(_current)) {
-		dequeue_thread(&_kernel.ready_q.runq,
-			       _current);
+		dequeue_thread(_current);
 	}
-	queue_thread(&_kernel.ready_q.runq, _current);
+	queue_thread(_current);
 	update_cache(true);
 	z_swap(&sched_spinlock, key);
 }
@@ -1499,7 +1645,7 @@ static void end_thread(struct k_thread *thread)
 		thread->base.thread_state |= _THREAD_DEAD;
 		thread->base.thread_state &= (uint8_t)~_THREAD_ABORTING;
 		if (z_is_thread_queued(thread)) {
-			dequeue_thread(&_kernel.ready_q.runq, thread);
+			dequeue_thread(thread);
 		}
 		if (thread->base.pended_on != NULL) {
 			unpend_thread_no_timeout(thread);
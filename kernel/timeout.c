@@ -11,11 +11,10 @@
 #include <syscall_handler.h>
 #include <drivers/timer/system_timer.h>
 #include <sys_clock.h>
+#include <sys/math_extras.h>
 
 static uint64_t curr_tick;
 
-static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
-
 static struct k_spinlock timeout_lock;
 
 #define MAX_WAIT ((IS_ENABLED(CONFIG_SYSTEM_CLOCK_SLOPPY_IDLE)) \
@@ -36,6 +35,189 @@ static inline int z_vrfy_sys_clock_hw_cycles_per_sec_runtime_get(void)
 #endif /* CONFIG_USERSPACE */
 #endif /* CONFIG_TIMER_READS_ITS_FREQUENCY_AT_RUNTIME */
 
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+
+/* Hierarchical timer wheel.  Each timeout stores its absolute expiry
+ * tick in dticks.  A timeout lives at the level matching the highest
+ * WHEEL_BITS-wide group of bits in which its expiry differs from
+ * curr_tick, in the slot given by that group of its expiry.  So every
+ * timeout at level N expires before any timeout at level N+1, and
+ * within a level the slot index orders them.  Slots at level 0 hold
+ * timeouts for one exact tick.  When curr_tick moves into a new group
+ * at level N, the matching slot at that level is cascaded down.
+ */
+#define WHEEL_BITS 5
+#define WHEEL_SLOTS BIT(WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SLOTS - 1U)
+#define WHEEL_LEVELS CONFIG_TIMEOUT_WHEEL_LEVELS
+
+/* Slot lists are only valid while their bit is set in wheel_map */
+static sys_dlist_t wheel[WHEEL_LEVELS][WHEEL_SLOTS];
+static uint32_t wheel_map[WHEEL_LEVELS];
+
+/* Timeouts beyond the span of the whole wheel, unsorted */
+static sys_dlist_t wheel_overflow = SYS_DLIST_STATIC_INIT(&wheel_overflow);
+
+static inline uint64_t expiry_of(const struct _timeout *t)
+{
+	return (uint64_t)t->dticks;
+}
+
+static inline unsigned int wheel_idx(uint64_t tick, int level)
+{
+	return (unsigned int)(tick >> (level * WHEEL_BITS)) & WHEEL_MASK;
+}
+
+static int wheel_level(uint64_t expiry)
+{
+	uint64_t diff = (expiry ^ curr_tick) >> WHEEL_BITS;
+
+	if (diff == 0U) {
+		return 0;
+	}
+
+	return MIN((63 - u64_count_leading_zeros(diff)) / WHEEL_BITS + 1,
+		   WHEEL_LEVELS);
+}
+
+static void wheel_insert(struct _timeout *to)
+{
+	int level = wheel_level(expiry_of(to));
+	unsigned int idx;
+
+	if (level == WHEEL_LEVELS) {
+		sys_dlist_append(&wheel_overflow, &to->node);
+		return;
+	}
+
+	idx = wheel_idx(expiry_of(to), level);
+	if ((wheel_map[level] & BIT(idx)) == 0U) {
+		sys_dlist_init(&wheel[level][idx]);
+		wheel_map[level] |= BIT(idx);
+	}
+	sys_dlist_append(&wheel[level][idx], &to->node);
+}
+
+/* Re-insert every timeout of a list relative to the current curr_tick.
+ * Relative order of timeouts with equal expiry is preserved.
+ */
+static void wheel_cascade(sys_dlist_t *list)
+{
+	sys_dlist_t pending;
+	sys_dnode_t *node;
+
+	sys_dlist_init(&pending);
+	while ((node = sys_dlist_get(list)) != NULL) {
+		sys_dlist_append(&pending, node);
+	}
+
+	while ((node = sys_dlist_get(&pending)) != NULL) {
+		wheel_insert(CONTAINER_OF(node, struct _timeout, node));
+	}
+}
+
+/* Must be called with curr_tick already moved forward from "from",
+ * and never past the earliest pending expiry.
+ */
+static void wheel_advance(uint64_t from)
+{
+	if ((from >> (WHEEL_LEVELS * WHEEL_BITS)) !=
+	    (curr_tick >> (WHEEL_LEVELS * WHEEL_BITS))) {
+		wheel_cascade(&wheel_overflow);
+	}
+
+	for (int level = WHEEL_LEVELS - 1; level > 0; level--) {
+		unsigned int idx = wheel_idx(curr_tick, level);
+
+		if ((from >> (level * WHEEL_BITS)) ==
+		    (curr_tick >> (level * WHEEL_BITS))) {
+			continue;
+		}
+
+		if ((wheel_map[level] & BIT(idx)) != 0U) {
+			wheel_map[level] &= ~BIT(idx);
+			wheel_cascade(&wheel[level][idx]);
+		}
+	}
+}
+
+static struct _timeout *earliest(sys_dlist_t *list)
+{
+	struct _timeout *t, *ret = NULL;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(list, t, node) {
+		if ((ret == NULL) || (expiry_of(t) < expiry_of(ret))) {
+			ret = t;
+		}
+	}
+
+	return ret;
+}
+
+static struct _timeout *first(void)
+{
+	for (int level = 0; level < WHEEL_LEVELS; level++) {
+		if (wheel_map[level] != 0U) {
+			sys_dlist_t *slot =
+				&wheel[level][find_lsb_set(wheel_map[level]) - 1];
+
+			/* All level 0 entries in a slot share one expiry */
+			if (level == 0) {
+				return CONTAINER_OF(sys_dlist_peek_head(slot),
+						    struct _timeout, node);
+			}
+			return earliest(slot);
+		}
+	}
+
+	return earliest(&wheel_overflow);
+}
+
+/* Ticks from curr_tick until first() expires */
+static k_ticks_t first_dticks(void)
+{
+	return (k_ticks_t)(expiry_of(first()) - curr_tick);
+}
+
+static void remove_timeout(struct _timeout *t)
+{
+	int level = wheel_level(expiry_of(t));
+	unsigned int idx;
+
+	sys_dlist_remove(&t->node);
+
+	if (level < WHEEL_LEVELS) {
+		idx = wheel_idx(expiry_of(t), level);
+		if (sys_dlist_is_empty(&wheel[level][idx])) {
+			wheel_map[level] &= ~BIT(idx);
+		}
+	}
+}
+
+/* to->dticks holds the delay from curr_tick on entry */
+static void timeout_insert(struct _timeout *to)
+{
+	to->dticks += curr_tick;
+	wheel_insert(to);
+}
+
+static k_ticks_t timeout_dticks(const struct _timeout *timeout)
+{
+	return (k_ticks_t)(expiry_of(timeout) - curr_tick);
+}
+
+static void advance_ticks(k_ticks_t dt)
+{
+	uint64_t from = curr_tick;
+
+	curr_tick += dt;
+	wheel_advance(from);
+}
+
+#else
+
+static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
+
 static struct _timeout *first(void)
 {
 	sys_dnode_t *t = sys_dlist_peek_head(&timeout_list);
@@ -50,6 +232,12 @@ static struct _timeout *next(struct _timeout *t)
 	return (n == NULL) ? NULL : CONTAINER_OF(n, struct _timeout, node);
 }
 
+/* Ticks from curr_tick until first() expires */
+static k_ticks_t first_dticks(void)
+{
+	return first()->dticks;
+}
+
 static void remove_timeout(struct _timeout *t)
 {
 	if (next(t) != NULL) {
@@ -59,6 +247,50 @@ static void remove_timeout(struct _timeout *t)
 	sys_dlist_remove(&t->node);
 }
 
+/* to->dticks holds the delay from curr_tick on entry */
+static void timeout_insert(struct _timeout *to)
+{
+	struct _timeout *t;
+
+	for (t = first(); t != NULL; t = next(t)) {
+		if (t->dticks > to->dticks) {
+			t->dticks -= to->dticks;
+			sys_dlist_insert(&t->node, &to->node);
+			break;
+		}
+		to->dticks -= t->dticks;
+	}
+
+	if (t == NULL) {
+		sys_dlist_append(&timeout_list, &to->node);
+	}
+}
+
+static k_ticks_t timeout_dticks(const struct _timeout *timeout)
+{
+	k_ticks_t ticks = 0;
+
+	for (struct _timeout *t = first(); t != NULL; t = next(t)) {
+		ticks += t->dticks;
+		if (timeout == t) {
+			break;
+		}
+	}
+
+	return ticks;
+}
+
+static void advance_ticks(k_ticks_t dt)
+{
+	if (first() != NULL) {
+		first()->dticks -= dt;
+	}
+
+	curr_tick += dt;
+}
+
+#endif /* CONFIG_TIMEOUT_QUEUE_WHEEL */
+
 static k_ticks_t elapsed(void)
 {
 	return (announce_remaining == 0) ? (k_ticks_t)sys_clock_elapsed() : 0;
@@ -69,7 +301,7 @@ static int32_t next_timeout(void)
 	struct _timeout *to = first();
 	k_ticks_t ticks_elapsed = elapsed();
 	int32_t ret = (int32_t)((to == NULL) ? MAX_WAIT
-		: CLAMP(to->dticks - ticks_elapsed, 0, MAX_WAIT));
+		: CLAMP(first_dticks() - ticks_elapsed, 0, MAX_WAIT));
 
 #ifdef CONFIG_TIMESLICING
 	if ((_current_cpu->slice_ticks != 0) && (_current_cpu->slice_ticks < ret)) {
@@ -94,8 +326,6 @@ void z_add_timeout(struct _timeout *to, _timeout_func_t fn,
 	to->fn = fn;
 
 	LOCKED(&timeout_lock) {
-		struct _timeout *t;
-
 		if ((IS_ENABLED(CONFIG_TIMEOUT_64BIT)) &&
 		    (Z_TICK_ABS(timeout.ticks) >= 0)) {
 		    /*? What is the intention here? int64_t = int64_t - uint64_t */
@@ -106,18 +336,7 @@ void z_add_timeout(struct _timeout *to, _timeout_func_t fn,
 			to->dticks = timeout.ticks + 1 + elapsed();
 		}
 
-		for (t = first(); t != NULL; t = next(t)) {
-			if (t->dticks > to->dticks) {
-				t->dticks -= to->dticks;
-				sys_dlist_insert(&t->node, &to->node);
-				break;
-			}
-			to->dticks -= t->dticks;
-		}
-
-		if (t == NULL) {
-			sys_dlist_append(&timeout_list, &to->node);
-		}
+		timeout_insert(to);
 
 		if (to == first()) {
 #if CONFIG_TIMESLICING
@@ -159,20 +378,11 @@ int z_abort_timeout(struct _timeout *to)
 /* must be locked */
 static k_ticks_t timeout_rem(const struct _timeout *timeout)
 {
-	k_ticks_t ticks = 0;
-
 	if (z_is_inactive_timeout(timeout)) {
 		return 0;
 	}
 
-	for (struct _timeout *t = first(); t != NULL; t = next(t)) {
-		ticks += t->dticks;
-		if (timeout == t) {
-			break;
-		}
-	}
-
-	return ticks - elapsed();
+	return timeout_dticks(timeout) - elapsed();
 }
 
 k_ticks_t z_timeout_remaining(const struct _timeout *timeout)
@@ -242,14 +452,13 @@ void sys_clock_announce(int32_t ticks)
 
 	announce_remaining = ticks;
 
-	while ((first() != NULL) && (first()->dticks <= announce_remaining)) {
+	while ((first() != NULL) && (first_dticks() <= announce_remaining)) {
 		struct _timeout *t = first();
 		/*? What is the intention here? int = int64_t */
-		int dt = t->dticks;
+		int dt = first_dticks();
 
-		curr_tick += dt;
 		announce_remaining -= dt;
-		t->dticks = 0;
+		advance_ticks(dt);
 		remove_timeout(t);
 
 		k_spin_unlock(&timeout_lock, key);
@@ -257,11 +466,7 @@ void sys_clock_announce(int32_t ticks)
 		key = k_spin_lock(&timeout_lock);
 	}
 
-	if (first() != NULL) {
-		first()->dticks -= announce_remaining;
-	}
-
-	curr_tick += announce_remaining;
+	advance_ticks(announce_remaining);
 	announce_remaining = 0;
 
 	sys_clock_set_timeout(next_timeout(), false);
@@ -20,6 +20,18 @@ int cbprintf(cbprintf_cb out, void *ctx, const char *format, ...)
 	return rc;
 }
 
+int cbprintf_fmt(cbprintf_cb out, void *ctx, struct cbprintf_fmt *fmt, ...)
+{
+	va_list ap;
+	int rc;
+
+	va_start(ap, fmt);
+	rc = cbvprintf_fmt(out, ctx, fmt, ap);
+	va_end(ap);
+
+	return rc;
+}
+
 #if defined(CONFIG_CBPRINTF_LIBC_SUBSTS)
 
 #include <stdio.h>
@@ -17,6 +17,7 @@
 #include <toolchain.h>
 #include <sys/types.h>
 #include <sys/util.h>
+#include <sys/atomic.h>
 #include <sys/cbprintf.h>
 
 /* newlib doesn't declare this function unless __POSIX_VISIBLE >= 200809.  No
@@ -1372,7 +1373,59 @@ static int outs(cbprintf_cb out,
 	return count;
 }
 
-int cbvprintf(cbprintf_cb out, void *ctx, const char *format, va_list ap)
+/* A conversion as kept in a format entry: its flags and specifier, and
+ * the width and precision given in the format, which must fit in 16 bits.
+ * The values set while converting are not needed.
+ */
+struct conversion_packed {
+	uint8_t flags[offsetof(struct conversion, specifier)];
+	char specifier;
+	int16_t width_value;
+	int16_t prec_value;
+};
+
+BUILD_ASSERT(sizeof(struct conversion_packed) <=
+	     sizeof(((struct cbprintf_fmt_entry *)NULL)->conv),
+	     "Conversion does not fit in a format entry");
+
+#ifdef CONFIG_CBPRINTF_PREPARSED_FMT
+static int conversion_pack(void *dst, const struct conversion *conv)
+{
+	struct conversion_packed packed;
+
+	if ((conv->width_value != (int16_t)conv->width_value) ||
+	    (conv->prec_value != (int16_t)conv->prec_value)) {
+		return -EINVAL;
+	}
+
+	memcpy(packed.flags, conv, sizeof(packed.flags));
+	packed.specifier = conv->specifier;
+	packed.width_value = (int16_t)conv->width_value;
+	packed.prec_value = (int16_t)conv->prec_value;
+	memcpy(dst, &packed, sizeof(packed));
+
+	return 0;
+}
+#endif /* CONFIG_CBPRINTF_PREPARSED_FMT */
+
+static void conversion_unpack(struct conversion *conv, const void *src)
+{
+	struct conversion_packed packed;
+
+	memcpy(&packed, src, sizeof(packed));
+	memcpy(conv, packed.flags, sizeof(packed.flags));
+	conv->specifier = packed.specifier;
+	conv->width_value = packed.width_value;
+	conv->prec_value = packed.prec_value;
+}
+
+/* Format with either the format string, when entry is null, or the
+ * pre-parsed entries in [entry, entry_end).
+ */
+static int format_conversions(cbprintf_cb out, void *ctx, const char *format,
+			      const struct cbprintf_fmt_entry *entry,
+			      const struct cbprintf_fmt_entry *entry_end,
+			      va_list ap)
 {
 	char buf[CONVERTED_BUFLEN];
 	int count = 0;
@@ -1405,8 +1458,17 @@ int cbvprintf(cbprintf_cb out, void *ctx, const char *format, va_list ap)
 	count += rc; \
 } while (false)
 
-	while (*format != '\0') {
-		if (*format != '%') {
+	while ((entry != NULL) ? (entry < entry_end) : (*format != '\0')) {
+		if (entry != NULL) {
+			/* The text up to the conversion in one go */
+			OUTS(format, format + entry->lit_len);
+			format += entry->lit_len;
+
+			if (entry->spec_len == 0U) {
+				++entry;
+				continue;
+			}
+		} else if (*format != '%') {
 			OUTC(*format);
 			++format;
 			continue;
@@ -1432,7 +1494,13 @@ int cbvprintf(cbprintf_cb out, void *ctx, const char *format, va_list ap)
 		const char *bpe = buf + sizeof(buf);
 		char sign = '\0';
 
-		format = extract_conversion(conv, sp);
+		if (entry != NULL) {
+			conversion_unpack(conv, entry->conv);
+			format += entry->spec_len;
+			++entry;
+		} else {
+			format = extract_conversion(conv, sp);
+		}
 
 		/* If dynamic width is specified, process it,
 		 * otherwise set width if present.
@@ -1868,3 +1936,104 @@ int cbvprintf(cbprintf_cb out, void *ctx, const char *format, va_list ap)
 #undef OUTS
 #undef OUTC
 }
+
+int cbvprintf(cbprintf_cb out, void *ctx, const char *format, va_list ap)
+{
+	return format_conversions(out, ctx, format, NULL, NULL, ap);
+}
+
+#ifdef CONFIG_CBPRINTF_PREPARSED_FMT
+/* Parsing state of a struct cbprintf_fmt */
+enum {
+	FMT_UNPARSED,
+	FMT_PARSING,
+	FMT_PARSED,
+	FMT_INVALID,
+};
+
+/* Parse a format string into its table of entries.
+ *
+ * @return 0 on success, -ENOMEM if the table is too small or -EINVAL if
+ * an element is too long, or a width or precision too large, for an entry.
+ */
+static int parse_fmt(struct cbprintf_fmt *fmt)
+{
+	struct cbprintf_fmt_entry *entry = fmt->entries;
+	const char *sp = fmt->format;
+
+	while (*sp != '\0') {
+		struct conversion conv;
+		const char *lp = sp;
+		const char *ep;
+
+		if (entry == &fmt->entries[fmt->max_entries]) {
+			return -ENOMEM;
+		}
+
+		while ((*sp != '\0') && (*sp != '%')) {
+			++sp;
+		}
+
+		if ((sp - lp) > UINT16_MAX) {
+			return -EINVAL;
+		}
+
+		entry->lit_len = (uint16_t)(sp - lp);
+		entry->spec_len = 0U;
+
+		if (*sp == '%') {
+			ep = extract_conversion(&conv, sp);
+
+			/* A trailing % is invalid and takes the terminating
+			 * null as specifier, don't go past it.
+			 */
+			if (conv.specifier == '\0') {
+				--ep;
+			}
+
+			if ((ep - sp) > UINT16_MAX) {
+				return -EINVAL;
+			}
+
+			entry->spec_len = (uint16_t)(ep - sp);
+			if (conversion_pack(entry->conv, &conv) != 0) {
+				return -EINVAL;
+			}
+
+			sp = ep;
+		}
+
+		++entry;
+	}
+
+	fmt->count = (uint16_t)(entry - fmt->entries);
+
+	return 0;
+}
+
+int cbvprintf_fmt(cbprintf_cb out, void *ctx, struct cbprintf_fmt *fmt,
+		  va_list ap)
+{
+	atomic_val_t state = atomic_get(&fmt->state);
+
+	if ((state == FMT_UNPARSED) &&
+	    atomic_cas(&fmt->state, FMT_UNPARSED, FMT_PARSING)) {
+		state = (parse_fmt(fmt) == 0) ? FMT_PARSED : FMT_INVALID;
+		atomic_set(&fmt->state, state);
+	}
+
+	/* Not parsed yet, or can't be */
+	if (state != FMT_PARSED) {
+		return cbvprintf(out, ctx, fmt->format, ap);
+	}
+
+	return format_conversions(out, ctx, fmt->format, fmt->entries,
+				  &fmt->entries[fmt->count], ap);
+}
+#else
+int cbvprintf_fmt(cbprintf_cb out, void *ctx, struct cbprintf_fmt *fmt,
+		  va_list ap)
+{
+	return cbvprintf(out, ctx, fmt->format, ap);
+}
+#endif /* CONFIG_CBPRINTF_PREPARSED_FMT */
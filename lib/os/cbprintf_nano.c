@@ -328,3 +328,9 @@ start:
 		goto start;
 	}
 }
+
+int cbvprintf_fmt(cbprintf_cb out, void *ctx, struct cbprintf_fmt *fmt,
+		  va_list ap)
+{
+	return cbvprintf(out, ctx, fmt->format, ap);
+}
@@ -187,6 +187,10 @@ def process_kconfigs(elf, database):
         database.add_kconfig("CONFIG_LOG_TIMESTAMP_64BIT",
                              kconfigs['CONFIG_LOG_TIMESTAMP_64BIT'])
 
+    if "CONFIG_LOG_DICTIONARY_FRAMING" in kconfigs:
+        database.add_kconfig("CONFIG_LOG_DICTIONARY_FRAMING",
+                             kconfigs['CONFIG_LOG_DICTIONARY_FRAMING'])
+
 
 def extract_static_string_sections(elf, database):
     """Extract sections containing static strings"""
@@ -20,3 +20,8 @@ class LogParser(abc.ABC):
     def parse_log_data(self, logdata, debug=False):
         """Parse log data"""
         return None
+
+    @abc.abstractmethod
+    def parse_stream(self, logdata, debug=False):
+        """Parse a chunk of a live log data stream"""
+        return None
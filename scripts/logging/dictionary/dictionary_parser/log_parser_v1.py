@@ -56,10 +56,40 @@ MSG_TYPE_DROPPED = 1
 # Number of dropped messages
 FMT_DROPPED_CNT = "H"
 
+# Need to keep sync with struct log_dict_output_frame_hdr_t in
+# include/logging/log_output_dict.h, used with
+# CONFIG_LOG_DICTIONARY_FRAMING.
+#
+# struct log_dict_output_frame_hdr_t {
+#     uint8_t sync[2];
+#     uint16_t len;
+# } __packed;
+#
+# The message is followed by its CRC-8.
+FRAME_SYNC = b"\x5a\x4c"
+FMT_FRAME_LEN = "H"
+FRAME_CRC_LEN = 1
+
+# Longest message: header, 10-bit package length, 12-bit data length
+FRAME_MAX_LEN = 32 + 1023 + 4095
+
 
 logger = logging.getLogger("parser")
 
 
+def crc8_ccitt(data, crc=0xFF):
+    """CRC-8 with polynomial 0x07, as crc8_ccitt() on target"""
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            if crc & 0x80:
+                crc = ((crc << 1) ^ 0x07) & 0xFF
+            else:
+                crc = (crc << 1) & 0xFF
+
+    return crc
+
+
 def get_log_level_str_color(lvl):
     """Convert numeric log level to string"""
     if lvl < 0 or lvl >= len(LOG_LEVELS):
@@ -180,8 +210,14 @@ class LogParserV1(LogParser):
         else:
             self.fmt_msg_timestamp = endian + FMT_MSG_TIMESTAMP_32
 
+        self.fmt_frame_len = endian + FMT_FRAME_LEN
+        self.framed = "CONFIG_LOG_DICTIONARY_FRAMING" in self.database.get_kconfigs()
+
         self.data_types = DataTypes(self.database)
 
+        # Data received but not parsed yet, see parse_stream()
+        self.pending = b''
+
 
     def __get_string(self, arg, arg_offset, string_tbl):
         one_str = self.database.find_string(arg)
@@ -422,30 +458,130 @@ class LogParserV1(LogParser):
         return next_msg_offset
 
 
-    def parse_log_data(self, logdata, debug=False):
-        """Parse binary log data and print the encoded log messages"""
-        offset = 0
+    def get_msg_len(self, logdata, offset):
+        """Get the length of the message at offset, None if there is not
+        enough data to tell or -1 if the message type is unknown"""
+        if offset >= len(logdata):
+            return None
 
-        while offset < len(logdata):
-            # Get message type
-            msg_type = struct.unpack_from(self.fmt_msg_type, logdata, offset)[0]
-            offset += struct.calcsize(self.fmt_msg_type)
+        msg_type = struct.unpack_from(self.fmt_msg_type, logdata, offset)[0]
+        msg_len = struct.calcsize(self.fmt_msg_type)
 
-            if msg_type == MSG_TYPE_DROPPED:
-                num_dropped = struct.unpack_from(self.fmt_dropped_cnt, logdata, offset)
-                offset += struct.calcsize(self.fmt_dropped_cnt)
+        if msg_type == MSG_TYPE_DROPPED:
+            return msg_len + struct.calcsize(self.fmt_dropped_cnt)
 
-                print("--- %d messages dropped ---" % num_dropped)
+        if msg_type != MSG_TYPE_NORMAL:
+            return -1
 
-            elif msg_type == MSG_TYPE_NORMAL:
-                ret = self.parse_one_normal_msg(logdata, offset)
-                if ret is None:
-                    return False
+        hdr_len = struct.calcsize(self.fmt_msg_hdr) + struct.calcsize(self.fmt_msg_timestamp)
+        if len(logdata) < offset + msg_len + hdr_len:
+            return None
 
-                offset = ret
+        log_desc = struct.unpack_from(self.fmt_msg_hdr, logdata, offset + msg_len)[0]
+        pkg_len = (log_desc >> 6) & int(math.pow(2, 10) - 1)
+        data_len = (log_desc >> 16) & int(math.pow(2, 12) - 1)
 
-            else:
-                logger.error("------ Unknown message type: %s", msg_type)
+        return msg_len + hdr_len + pkg_len + data_len
+
+
+    def parse_one_msg(self, logdata, offset):
+        """Parse the message at offset and return the offset of the next
+        one, or None on error"""
+        # Get message type
+        msg_type = struct.unpack_from(self.fmt_msg_type, logdata, offset)[0]
+        offset += struct.calcsize(self.fmt_msg_type)
+
+        if msg_type == MSG_TYPE_DROPPED:
+            num_dropped = struct.unpack_from(self.fmt_dropped_cnt, logdata, offset)
+            offset += struct.calcsize(self.fmt_dropped_cnt)
+
+            print("--- %d messages dropped ---" % num_dropped)
+
+            return offset
+
+        if msg_type == MSG_TYPE_NORMAL:
+            return self.parse_one_normal_msg(logdata, offset)
+
+        logger.error("------ Unknown message type: %s", msg_type)
+        return None
+
+
+    def parse_frames(self):
+        """Parse the complete frames of pending data, skipping over data
+        that is not a valid frame"""
+        hdr_len = len(FRAME_SYNC) + struct.calcsize(self.fmt_frame_len)
+
+        while True:
+            idx = self.pending.find(FRAME_SYNC)
+            if idx < 0:
+                # Keep a byte that may start the next sync sequence
+                if len(self.pending) > 1:
+                    logger.debug("------ Skipped %d bytes", len(self.pending) - 1)
+                self.pending = self.pending[-1:]
+                return
+
+            if idx > 0:
+                logger.debug("------ Skipped %d bytes", idx)
+                self.pending = self.pending[idx:]
+
+            if len(self.pending) < hdr_len:
+                return
+
+            msg_len = struct.unpack_from(self.fmt_frame_len, self.pending, len(FRAME_SYNC))[0]
+            if msg_len > FRAME_MAX_LEN:
+                self.pending = self.pending[1:]
+                continue
+
+            if len(self.pending) < hdr_len + msg_len + FRAME_CRC_LEN:
+                return
+
+            msg = self.pending[hdr_len:(hdr_len + msg_len)]
+            crc = self.pending[hdr_len + msg_len]
+
+            if crc != crc8_ccitt(msg) or self.get_msg_len(msg, 0) != msg_len:
+                # Not a frame, look for the next sync sequence
+                self.pending = self.pending[1:]
+                continue
+
+            self.pending = self.pending[(hdr_len + msg_len + FRAME_CRC_LEN):]
+
+            if self.parse_one_msg(msg, 0) is None:
+                logger.error("------ Error parsing message, skipped")
+
+
+    def parse_stream(self, logdata, debug=False):
+        """Parse a chunk of a binary log data stream and print the encoded
+        log messages. A message split between chunks is printed once
+        complete. Returns False on error."""
+        self.pending += logdata
+
+        if self.framed:
+            self.parse_frames()
+            return True
+
+        # Without framing, the stream cannot be resynchronized
+        while True:
+            msg_len = self.get_msg_len(self.pending, 0)
+            if msg_len is None or len(self.pending) < msg_len:
+                return True
+
+            if msg_len < 0 or self.parse_one_msg(self.pending, 0) is None:
+                if msg_len < 0:
+                    logger.error("------ Unknown message type: %s", self.pending[0])
+                self.pending = b''
                 return False
 
-        return True
+            self.pending = self.pending[msg_len:]
+
+
+    def parse_log_data(self, logdata, debug=False):
+        """Parse binary log data and print the encoded log messages"""
+        self.pending = b''
+
+        ret = self.parse_stream(logdata, debug=debug)
+
+        if self.pending and not self.framed:
+            logger.error("------ Incomplete message at end of log data")
+            ret = False
+
+        return ret
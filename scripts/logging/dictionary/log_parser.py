@@ -14,6 +14,7 @@ log data and print the log messages.
 import argparse
 import binascii
 import logging
+import socket
 import sys
 
 import dictionary_parser
@@ -31,15 +32,91 @@ def parse_args():
     argparser = argparse.ArgumentParser()
 
     argparser.add_argument("dbfile", help="Dictionary Logging Database file")
-    argparser.add_argument("logfile", help="Log Data file")
+    argparser.add_argument("logfile", nargs="?",
+                           help="Log Data file, - to read a live stream from stdin")
     argparser.add_argument("--hex", action="store_true",
                            help="Log Data file is in hexadecimal strings")
     argparser.add_argument("--rawhex", action="store_true",
                            help="Log file only contains hexadecimal log data")
+    argparser.add_argument("--serial",
+                           help="Read a live stream of binary log data from this serial port")
+    argparser.add_argument("--baudrate", type=int, default=115200,
+                           help="Baud rate of the serial port (default: 115200)")
+    argparser.add_argument("--udp", metavar="[ADDR:]PORT",
+                           help="Receive binary log data from the networking backend "
+                                "on this UDP port")
     argparser.add_argument("--debug", action="store_true",
                            help="Print extra debugging information")
 
-    return argparser.parse_args()
+    args = argparser.parse_args()
+
+    sources = [src for src in (args.logfile, args.serial, args.udp) if src is not None]
+    if len(sources) != 1:
+        argparser.error("exactly one of logfile, --serial or --udp is required")
+
+    if args.hex and (args.serial or args.udp or args.logfile == "-"):
+        argparser.error("--hex is only supported for log data files")
+
+    return args
+
+
+def read_serial(args):
+    """Yield chunks of data received from the serial port"""
+    import serial # pylint: disable=import-outside-toplevel
+
+    with serial.Serial(args.serial, args.baudrate, timeout=0.1) as port:
+        while True:
+            data = port.read(max(1, port.in_waiting))
+            if data:
+                yield data
+
+
+def read_udp(args):
+    """Yield the datagrams received on the UDP port"""
+    addr, _, port = args.udp.rpartition(":")
+
+    family = socket.AF_INET6 if ":" in addr else socket.AF_INET
+    with socket.socket(family, socket.SOCK_DGRAM) as sock:
+        sock.bind((addr.strip("[]"), int(port)))
+
+        while True:
+            data, _ = sock.recvfrom(65535)
+            yield data
+
+
+def read_stdin():
+    """Yield chunks of data as they come on stdin"""
+    while True:
+        data = sys.stdin.buffer.read1(4096)
+        if not data:
+            return
+        yield data
+
+
+def parse_live_stream(args, log_parser):
+    """Parse log data as it is received, until interrupted"""
+    if log_parser.framed:
+        logger.debug("# Framed log data")
+    else:
+        logger.warning("WARNING: log data is not framed "
+                       "(CONFIG_LOG_DICTIONARY_FRAMING), the stream must "
+                       "be read from its start")
+
+    if args.serial:
+        stream = read_serial(args)
+    elif args.udp:
+        stream = read_udp(args)
+    else:
+        stream = read_stdin()
+
+    try:
+        for data in stream:
+            if not log_parser.parse_stream(data, debug=args.debug):
+                return False
+    except KeyboardInterrupt:
+        pass
+
+    return True
 
 
 def main():
@@ -59,8 +136,13 @@ def main():
         logger.error("ERROR: Cannot open database file: %s, exiting...", args.dbfile)
         sys.exit(1)
 
+    logdata = None
+
     # Open log data file for reading
-    if args.hex:
+    if args.serial or args.udp or args.logfile == "-":
+        # Live stream, parsed as it is received
+        pass
+    elif args.hex:
         if args.rawhex:
             # Simply log file with only hexadecimal data
             logdata = dictionary_parser.utils.convert_hex_file_to_bin(args.logfile)
@@ -118,7 +200,10 @@ def main():
         else:
             logger.debug("# Endianness: Big")
 
-        ret = log_parser.parse_log_data(logdata, debug=args.debug)
+        if logdata is None:
+            ret = parse_live_stream(args, log_parser)
+        else:
+            ret = log_parser.parse_log_data(logdata, debug=args.debug)
         if not ret:
             logger.error("ERROR: there were error(s) parsing log data")
             sys.exit(1)
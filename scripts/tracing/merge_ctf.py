@@ -0,0 +1,311 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2021 Intel Corporation.
+#
+# SPDX-License-Identifier: Apache-2.0
+"""
+Script to convert CTF data captured with per-CPU tracing buffers
+(CONFIG_TRACING_PER_CPU_BUFFERS) to a CTF trace which can be read by
+babeltrace, Trace Compass or parse_ctf.py.
+
+The captured data is made of chunks of the buffers of the CPUs. They are
+split into one stream per CPU, with a packet context giving the CPU id,
+and the events get 64-bit timestamps. With the compact encoding
+(CONFIG_TRACING_CTF_COMPACT), events are expanded to the layout of the
+metadata and thread names are filled in from the events which set them.
+
+    ./scripts/tracing/merge_ctf.py -o ctf channel0_0
+    ./scripts/tracing/parse_ctf.py -t ctf
+
+The compact encoding timestamps events with hardware cycles: pass the
+cycle frequency of the target, CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC, with
+--compact. Events of a CPU must be less than 2^32 cycles apart.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+CHUNK_MAGIC = 0xCF
+CHUNK_HDR = struct.Struct("<BBH")
+
+DEFAULT_METADATA = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                "..", "..", "subsys", "tracing", "ctf", "tsdl",
+                                "metadata")
+
+# Fields of the output metadata, replacing the event header of the
+# target one
+OUTPUT_DECLS = """
+clock {{
+	name = zephyr_clock;
+	freq = {freq};
+	offset = 0;
+}};
+
+typealias integer {{ size = 64; align = 8; signed = false; map = clock.zephyr_clock.value; }} := clock_uint64_t;
+
+struct packet_context {{
+	clock_uint64_t timestamp_begin;
+	clock_uint64_t timestamp_end;
+	uint64_t content_size;
+	uint64_t packet_size;
+	uint32_t cpu_id;
+}};
+
+struct event_header {{
+	clock_uint64_t timestamp;
+	uint8_t id;
+}};
+
+stream {{
+	packet.context := struct packet_context;
+	event.header := struct event_header;
+}};
+"""
+
+PACKET_CONTEXT = struct.Struct("<QQQQI")
+EVENT_HEADER = struct.Struct("<QB")
+
+
+class Field:
+    """Field of an event, as declared in the metadata"""
+    def __init__(self, ftype, name, size, signed, count):
+        self.type = ftype
+        self.name = name
+        self.size = size
+        self.signed = signed
+        self.count = count
+
+    def is_string(self):
+        return self.count is not None
+
+
+def parse_metadata(text):
+    """Get the integer types and the events declared in the metadata"""
+    types = {}
+    for size, attrs, name in re.findall(
+            r"typealias integer \{\s*size = (\d+);([^}]*)\} := (\w+);", text):
+        types[name] = (int(size) // 8, "signed = true" in attrs)
+
+    for base, name in re.findall(
+            r"typealias enum : (\w+) \{[^}]*\} := (\w+);", text):
+        types[name] = types[base]
+
+    events = {}
+    for body in re.findall(r"^event \{(.*?)^\};", text, re.M | re.S):
+        name = re.search(r"name = (\w+);", body).group(1)
+        event_id = int(re.search(r"id = (\w+);", body).group(1), 0)
+        fields = []
+
+        decls = re.search(r"fields := struct \{(.*?)\};", body, re.S)
+        for ftype, fname, count in re.findall(r"(\w+) (\w+)(?:\[(\d+)\])?;",
+                                              decls.group(1) if decls else ""):
+            size, signed = types[ftype]
+            fields.append(Field(ftype, fname, size, signed,
+                                int(count) if count else None))
+
+        events[event_id] = (name, fields)
+
+    return events
+
+
+def output_metadata(text, freq):
+    """Metadata of the output: the target one with 64-bit timestamps,
+    a clock and a packet context"""
+    text = re.sub(r"struct event_header \{.*?\};\n*", "", text, flags=re.S)
+    text = re.sub(r"stream \{.*?\};\n*", "", text, flags=re.S)
+
+    trace = re.search(r"trace \{.*?\};\n", text, re.S)
+    return (text[:trace.end()] + OUTPUT_DECLS.format(freq=freq) +
+            text[trace.end():])
+
+
+def split_chunks(data):
+    """Split the captured data into the streams of the CPUs"""
+    streams = {}
+    offset = 0
+
+    while offset + CHUNK_HDR.size <= len(data):
+        magic, cpu, length = CHUNK_HDR.unpack_from(data, offset)
+        if magic != CHUNK_MAGIC:
+            sys.exit(f"Bad chunk header at offset {offset}, "
+                     "was the trace captured with per-CPU buffers?")
+
+        offset += CHUNK_HDR.size
+        streams.setdefault(cpu, bytearray()).extend(data[offset:offset + length])
+        offset += length
+
+    if offset != len(data):
+        print(f"Incomplete chunk at offset {offset} ignored", file=sys.stderr)
+
+    return streams
+
+
+def read_varint(data, offset):
+    value = 0
+    shift = 0
+
+    while True:
+        byte = data[offset]
+        offset += 1
+        value |= (byte & 0x7f) << shift
+        shift += 7
+        if byte < 0x80:
+            return value, offset
+
+
+def decode_events(data, events, compact):
+    """Decode the events of a CPU stream into (timestamp, id, values)
+    tuples, values being ints and bytes"""
+    decoded = []
+    offset = 0
+    timestamp = 0
+
+    try:
+        while offset < len(data):
+            if compact:
+                delta, offset = read_varint(data, offset)
+                timestamp += delta
+            else:
+                # Nanoseconds, wrapping at 32 bits, which may go back a
+                # little when an interrupt got its events in first
+                low = struct.unpack_from("<I", data, offset)[0]
+                offset += 4
+                delta = (low - timestamp) & 0xffffffff
+                timestamp += delta - (1 << 32 if delta >= 1 << 31 else 0)
+
+            event_id = data[offset]
+            offset += 1
+
+            if event_id not in events:
+                print(f"Unknown event id {event_id:#x}, rest of the stream "
+                      "ignored", file=sys.stderr)
+                break
+
+            values = []
+            for field in events[event_id][1]:
+                if field.is_string():
+                    if compact:
+                        length = data[offset]
+                        offset += 1
+                    else:
+                        length = field.count
+                    value = bytes(data[offset:offset + length]).split(b"\0")[0]
+                    if len(data) < offset + length:
+                        raise IndexError
+                    offset += length
+                elif compact and field.size == 4:
+                    value, offset = read_varint(data, offset)
+                    if field.signed:
+                        value = (value >> 1) ^ -(value & 1)
+                else:
+                    value = int.from_bytes(data[offset:offset + field.size],
+                                           "little", signed=field.signed)
+                    if len(data) < offset + field.size:
+                        raise IndexError
+                    offset += field.size
+
+                values.append(value)
+
+            decoded.append((timestamp, event_id, values))
+    except IndexError:
+        print("Truncated event at the end of a stream ignored", file=sys.stderr)
+
+    return decoded
+
+
+def fill_thread_names(streams, events):
+    """Give the name of their thread to the events sent without it, going
+    through the events of all the CPUs in time order"""
+    names = {}
+    merged = sorted((event for stream in streams.values() for event in stream),
+                    key=lambda event: event[0])
+
+    for _, event_id, values in merged:
+        fields = [field.name for field in events[event_id][1]]
+        if "thread_id" not in fields or "name" not in fields:
+            continue
+
+        thread_id = values[fields.index("thread_id")]
+        name_idx = fields.index("name")
+
+        if values[name_idx]:
+            names[thread_id] = values[name_idx]
+        else:
+            values[name_idx] = names.get(thread_id, b"%#x" % thread_id)
+
+
+def encode_events(stream, events):
+    out = bytearray()
+
+    for timestamp, event_id, values in stream:
+        out += EVENT_HEADER.pack(timestamp, event_id)
+
+        for field, value in zip(events[event_id][1], values):
+            if field.is_string():
+                out += value[:field.count - 1].ljust(field.count, b"\0")
+            else:
+                out += value.to_bytes(field.size, "little", signed=field.signed)
+
+    return out
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+            description=__doc__,
+            formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("capture", help="captured tracing data")
+    parser.add_argument("-o", "--output", required=True,
+                        help="output trace directory")
+    parser.add_argument("-m", "--metadata", default=DEFAULT_METADATA,
+                        help="metadata of the target (default: %(default)s)")
+    parser.add_argument("--compact", type=int, metavar="FREQ",
+                        help="data is in the compact encoding, timestamped "
+                             "with a clock of FREQ Hz")
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+
+    with open(args.metadata, "r") as f:
+        metadata = f.read()
+    with open(args.capture, "rb") as f:
+        data = f.read()
+
+    events = parse_metadata(metadata)
+    compact = args.compact is not None
+
+    streams = {cpu: decode_events(chunks, events, compact)
+               for cpu, chunks in split_chunks(data).items()}
+
+    if compact:
+        fill_thread_names(streams, events)
+
+    os.makedirs(args.output, exist_ok=True)
+
+    with open(os.path.join(args.output, "metadata"), "w") as f:
+        f.write(output_metadata(metadata, args.compact if compact else 1000000000))
+
+    for cpu, stream in sorted(streams.items()):
+        # Events of a CPU are in time order with the compact encoding.
+        # Otherwise they are timestamped before being buffered, an
+        # interrupt may get its events in first.
+        stream.sort(key=lambda event: event[0])
+
+        content = encode_events(stream, events)
+        size = (PACKET_CONTEXT.size + len(content)) * 8
+        begin = stream[0][0] if stream else 0
+        end = stream[-1][0] if stream else 0
+
+        with open(os.path.join(args.output, f"channel0_{cpu}"), "wb") as f:
+            f.write(PACKET_CONTEXT.pack(begin, end, size, size, cpu))
+            f.write(content)
+
+        print(f"cpu {cpu}: {len(stream)} events")
+
+
+if __name__ == "__main__":
+    main()
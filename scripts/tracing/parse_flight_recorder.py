@@ -0,0 +1,137 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2021 Intel Corporation.
+#
+# SPDX-License-Identifier: Apache-2.0
+"""
+Script to extract the content of the tracing flight recorder
+(CONFIG_TRACING_BACKEND_FLIGHT_RECORDER) into a CTF trace directory which
+can be read by babeltrace, Trace Compass or parse_ctf.py.
+
+The content is read either from a console log, where it is printed on
+fatal errors or by the "flight_recorder dump" shell command:
+
+    ./scripts/tracing/parse_flight_recorder.py -o ctf console.log
+
+or from a memory image holding the recorder, such as a RAM dump taken
+with a debugger:
+
+    ./scripts/tracing/parse_flight_recorder.py --raw -o ctf ram.bin
+"""
+
+import argparse
+import os
+import re
+import shutil
+import struct
+import sys
+
+RECORDER_MAGIC = 0x52465A54
+RECORDER_HDR = struct.Struct("<IIII")
+RECORD_HDR = struct.Struct("<H")
+
+DEFAULT_METADATA = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                "..", "..", "subsys", "tracing", "ctf", "tsdl",
+                                "metadata")
+
+LOG_LINE = re.compile(r"#TR:(BEGIN#|END#|[0-9a-fA-F]+)")
+
+
+def parse_log(text):
+    """Get the data of the last complete dump found in a console log"""
+    dumps = []
+    data = None
+
+    for line in text.splitlines():
+        match = LOG_LINE.search(line)
+        if not match:
+            continue
+
+        value = match.group(1)
+        if value == "BEGIN#":
+            data = bytearray()
+        elif value == "END#":
+            if data is not None:
+                dumps.append(bytes(data))
+            data = None
+        elif data is not None:
+            data += bytes.fromhex(value)
+
+    if not dumps:
+        sys.exit("No flight recorder dump found in the log")
+
+    if len(dumps) > 1:
+        print(f"{len(dumps)} dumps found, using the last one", file=sys.stderr)
+
+    return dumps[-1]
+
+
+def parse_raw(image):
+    """Get the data of the recorder found in a memory image"""
+    magic = struct.pack("<I", RECORDER_MAGIC)
+    offset = image.rfind(magic)
+
+    while offset >= 0:
+        _, size, head, used = RECORDER_HDR.unpack_from(image, offset)
+        ring = image[offset + RECORDER_HDR.size:
+                     offset + RECORDER_HDR.size + size]
+
+        if len(ring) == size and head < size and used <= size:
+            break
+
+        offset = image.rfind(magic, 0, offset)
+    else:
+        sys.exit("No flight recorder found in the image")
+
+    # Unwrap the ring, then walk the records oldest first
+    ring = ring[head:] + ring[:head]
+    data = bytearray()
+    pos = 0
+
+    while pos < used:
+        length = RECORD_HDR.unpack_from(ring, pos)[0]
+        pos += RECORD_HDR.size
+        if pos + length > used:
+            sys.exit(f"Corrupted record at offset {pos}")
+
+        data += ring[pos:pos + length]
+        pos += length
+
+    return bytes(data)
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+            description=__doc__,
+            formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", help="console log, or memory image with --raw")
+    parser.add_argument("-o", "--output", required=True,
+                        help="output trace directory")
+    parser.add_argument("-m", "--metadata", default=DEFAULT_METADATA,
+                        help="metadata of the target (default: %(default)s)")
+    parser.add_argument("--raw", action="store_true",
+                        help="input is a memory image holding the recorder")
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+
+    if args.raw:
+        with open(args.input, "rb") as f:
+            data = parse_raw(f.read())
+    else:
+        with open(args.input, "r", errors="replace") as f:
+            data = parse_log(f.read())
+
+    os.makedirs(args.output, exist_ok=True)
+    shutil.copy(args.metadata, os.path.join(args.output, "metadata"))
+
+    with open(os.path.join(args.output, "channel0_0"), "wb") as f:
+        f.write(data)
+
+    print(f"{len(data)} bytes of tracing data written to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
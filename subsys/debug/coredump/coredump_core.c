@@ -10,6 +10,7 @@
 #include <debug/coredump.h>
 #include <sys/byteorder.h>
 #include <sys/util.h>
+#include <tracing/flight_recorder.h>
 
 #include "coredump_internal.h"
 
@@ -108,6 +109,8 @@ void coredump(unsigned int reason, const z_arch_esf_t *esf,
 
 	process_memory_region_list();
 
+	z_tracing_flight_recorder_coredump();
+
 	z_coredump_end();
 }
 
@@ -0,0 +1,443 @@
+/*
+ * Copyright (c) 2021 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/types.h>
+#include <sys/util.h>
+#include <sys/dlist.h>
+#include <kernel.h>
+#include <errno.h>
+
+#include "disk_cache.h"
+
+#define LOG_LEVEL CONFIG_DISK_LOG_LEVEL
+#include <logging/log.h>
+LOG_MODULE_DECLARE(disk);
+
+/*
+ * Write-back LRU cache of disk sectors, shared by all disks with
+ * CONFIG_DISK_CACHE_SECTOR_SIZE sectors.
+ *
+ * Requests of up to CONFIG_DISK_CACHE_MAX_IO sectors, which are the
+ * single sector FAT and directory accesses of file systems, go through
+ * the cache. Missing sectors are read in one driver call, together with
+ * the sectors following them when the disk is read sequentially. Writes
+ * only update the cache, dirty sectors are written back sorted and in
+ * runs of consecutive sectors on DISK_IOCTL_CTRL_SYNC, on eviction and
+ * CONFIG_DISK_CACHE_FLUSH_DELAY ms after a write.
+ *
+ * Larger requests go straight to the driver, so that reading or writing
+ * a file does not evict the metadata.
+ */
+
+#define SECTOR_SIZE CONFIG_DISK_CACHE_SECTOR_SIZE
+#define MAX_IO MIN(CONFIG_DISK_CACHE_MAX_IO, CONFIG_DISK_CACHE_BLOCKS)
+
+struct disk_cache_block {
+	/* Position in the LRU list */
+	sys_dnode_t node;
+	/* Disk the sector belongs to, NULL if the block is unused */
+	struct disk_info *disk;
+	uint32_t sector;
+	bool dirty;
+	uint8_t *data;
+};
+
+static struct disk_cache_block blocks[CONFIG_DISK_CACHE_BLOCKS];
+static uint8_t block_data[CONFIG_DISK_CACHE_BLOCKS][SECTOR_SIZE] __aligned(4);
+
+/* Bounce buffer for multi-sector driver calls */
+static uint8_t io_buf[MAX_IO * SECTOR_SIZE] __aligned(4);
+/* Blocks being written back, and being read */
+static struct disk_cache_block *io_blocks[CONFIG_DISK_CACHE_BLOCKS];
+static struct disk_cache_block *fill_blocks[MAX_IO];
+
+/* Most recently used block first, unused blocks at the end */
+static sys_dlist_t lru;
+
+static K_MUTEX_DEFINE(cache_lock);
+
+#if CONFIG_DISK_CACHE_FLUSH_DELAY > 0
+static void flush_work_handler(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(flush_work, flush_work_handler);
+#endif
+
+static struct disk_cache_block *block_find(struct disk_info *disk,
+					   uint32_t sector)
+{
+	struct disk_cache_block *blk;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&lru, blk, node) {
+		if (blk->disk == NULL) {
+			/* Only unused blocks follow */
+			break;
+		}
+
+		if (blk->disk == disk && blk->sector == sector) {
+			return blk;
+		}
+	}
+
+	return NULL;
+}
+
+static void block_touch(struct disk_cache_block *blk)
+{
+	sys_dlist_remove(&blk->node);
+	sys_dlist_prepend(&lru, &blk->node);
+}
+
+static void block_drop(struct disk_cache_block *blk)
+{
+	blk->disk = NULL;
+	blk->dirty = false;
+	sys_dlist_remove(&blk->node);
+	sys_dlist_append(&lru, &blk->node);
+}
+
+/* Write back the dirty sectors of a disk, in runs of consecutive sectors */
+static int flush_disk(struct disk_info *disk)
+{
+	int count = 0;
+	int rc = 0;
+	int i, j;
+
+	for (i = 0; i < ARRAY_SIZE(blocks); i++) {
+		if (blocks[i].disk != disk || !blocks[i].dirty) {
+			continue;
+		}
+
+		/* Insertion sort by sector */
+		for (j = count; j > 0 &&
+		     io_blocks[j - 1]->sector > blocks[i].sector; j--) {
+			io_blocks[j] = io_blocks[j - 1];
+		}
+		io_blocks[j] = &blocks[i];
+		count++;
+	}
+
+	for (i = 0; i < count; i = j) {
+		for (j = i + 1; j < count && j - i < MAX_IO &&
+		     io_blocks[j]->sector == io_blocks[j - 1]->sector + 1; j++) {
+		}
+
+		if (j - i == 1) {
+			rc = disk->ops->write(disk, io_blocks[i]->data,
+					      io_blocks[i]->sector, 1);
+		} else {
+			for (int k = i; k < j; k++) {
+				memcpy(&io_buf[(k - i) * SECTOR_SIZE],
+				       io_blocks[k]->data, SECTOR_SIZE);
+			}
+
+			rc = disk->ops->write(disk, io_buf,
+					      io_blocks[i]->sector, j - i);
+		}
+
+		if (rc != 0) {
+			LOG_ERR("write back of %s failed (%d)", disk->name, rc);
+			return rc;
+		}
+
+		for (int k = i; k < j; k++) {
+			io_blocks[k]->dirty = false;
+		}
+	}
+
+	return 0;
+}
+
+/* Take the least recently used block for a sector, NULL on write error */
+static struct disk_cache_block *block_alloc(struct disk_info *disk,
+					    uint32_t sector)
+{
+	struct disk_cache_block *blk;
+
+	blk = CONTAINER_OF(sys_dlist_peek_tail(&lru),
+			   struct disk_cache_block, node);
+
+	if (blk->dirty && flush_disk(blk->disk) != 0) {
+		return NULL;
+	}
+
+	blk->disk = disk;
+	blk->sector = sector;
+	blk->dirty = false;
+	block_touch(blk);
+
+	return blk;
+}
+
+/* Read count sectors that are not cached into the cache */
+static int block_fill(struct disk_info *disk, uint32_t sector, uint32_t count)
+{
+	int rc;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		fill_blocks[i] = block_alloc(disk, sector + i);
+		if (fill_blocks[i] == NULL) {
+			rc = -EIO;
+			goto err;
+		}
+	}
+
+	rc = disk->ops->read(disk, io_buf, sector, count);
+	if (rc != 0) {
+		goto err;
+	}
+
+	for (i = 0; i < count; i++) {
+		memcpy(fill_blocks[i]->data, &io_buf[i * SECTOR_SIZE],
+		       SECTOR_SIZE);
+	}
+
+	return 0;
+
+err:
+	while (i-- > 0) {
+		block_drop(fill_blocks[i]);
+	}
+
+	return rc;
+}
+
+static int read_direct(struct disk_info *disk, uint8_t *data_buf,
+		       uint32_t start_sector, uint32_t num_sector)
+{
+	int rc;
+
+	rc = disk->ops->read(disk, data_buf, start_sector, num_sector);
+	if (rc != 0) {
+		return rc;
+	}
+
+	/* The disk does not have the sectors written since the last flush */
+	for (int i = 0; i < ARRAY_SIZE(blocks); i++) {
+		if (blocks[i].disk == disk && blocks[i].dirty &&
+		    blocks[i].sector - start_sector < num_sector) {
+			memcpy(&data_buf[(blocks[i].sector - start_sector) *
+					 SECTOR_SIZE],
+			       blocks[i].data, SECTOR_SIZE);
+		}
+	}
+
+	return 0;
+}
+
+int disk_cache_read(struct disk_info *disk, uint8_t *data_buf,
+		    uint32_t start_sector, uint32_t num_sector)
+{
+	struct disk_cache_block *blk;
+	bool sequential;
+	uint32_t i, count, limit;
+	int rc = 0;
+
+	if (disk->cache_sector_count == 0U) {
+		return disk->ops->read(disk, data_buf, start_sector,
+				       num_sector);
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	sequential = start_sector == disk->cache_next_sector;
+	disk->cache_next_sector = start_sector + num_sector;
+
+	if (num_sector > MAX_IO ||
+	    start_sector + num_sector > disk->cache_sector_count) {
+		rc = read_direct(disk, data_buf, start_sector, num_sector);
+		goto out;
+	}
+
+	for (i = 0; i < num_sector; ) {
+		blk = block_find(disk, start_sector + i);
+		if (blk != NULL) {
+			memcpy(&data_buf[i * SECTOR_SIZE], blk->data,
+			       SECTOR_SIZE);
+			block_touch(blk);
+			i++;
+			continue;
+		}
+
+		/* Read the missing run at once, and ahead of the request
+		 * when the disk is read sequentially.
+		 */
+		limit = sequential ? MAX_IO : num_sector - i;
+		limit = MIN(limit, disk->cache_sector_count -
+			    (start_sector + i));
+
+		for (count = 1; count < limit &&
+		     block_find(disk, start_sector + i + count) == NULL;
+		     count++) {
+		}
+
+		rc = block_fill(disk, start_sector + i, count);
+		if (rc != 0) {
+			break;
+		}
+	}
+
+out:
+	k_mutex_unlock(&cache_lock);
+
+	return rc;
+}
+
+int disk_cache_write(struct disk_info *disk, const uint8_t *data_buf,
+		     uint32_t start_sector, uint32_t num_sector)
+{
+	struct disk_cache_block *blk;
+	int rc = 0;
+
+	if (disk->cache_sector_count == 0U) {
+		return disk->ops->write(disk, data_buf, start_sector,
+					num_sector);
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	if (num_sector > MAX_IO ||
+	    start_sector + num_sector > disk->cache_sector_count) {
+		rc = disk->ops->write(disk, data_buf, start_sector, num_sector);
+		if (rc == 0) {
+			/* Cached copies, dirty or not, are outdated now */
+			for (int i = 0; i < ARRAY_SIZE(blocks); i++) {
+				if (blocks[i].disk == disk &&
+				    blocks[i].sector - start_sector <
+				    num_sector) {
+					block_drop(&blocks[i]);
+				}
+			}
+		}
+		goto out;
+	}
+
+	for (uint32_t i = 0; i < num_sector; i++) {
+		blk = block_find(disk, start_sector + i);
+		if (blk == NULL) {
+			blk = block_alloc(disk, start_sector + i);
+			if (blk == NULL) {
+				rc = -EIO;
+				break;
+			}
+		} else {
+			block_touch(blk);
+		}
+
+		memcpy(blk->data, &data_buf[i * SECTOR_SIZE], SECTOR_SIZE);
+		blk->dirty = true;
+	}
+
+#if CONFIG_DISK_CACHE_FLUSH_DELAY > 0
+	/* Does nothing if a flush is already scheduled */
+	k_work_schedule(&flush_work, K_MSEC(CONFIG_DISK_CACHE_FLUSH_DELAY));
+#endif
+
+out:
+	k_mutex_unlock(&cache_lock);
+
+	return rc;
+}
+
+int disk_cache_sync(struct disk_info *disk)
+{
+	int rc;
+
+	if (disk->cache_sector_count == 0U) {
+		return 0;
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	rc = flush_disk(disk);
+	k_mutex_unlock(&cache_lock);
+
+	return rc;
+}
+
+#if CONFIG_DISK_CACHE_FLUSH_DELAY > 0
+static void flush_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	for (int i = 0; i < ARRAY_SIZE(blocks); i++) {
+		/* On error the sectors stay dirty, for the next flush */
+		if (blocks[i].dirty && flush_disk(blocks[i].disk) != 0) {
+			break;
+		}
+	}
+
+	k_mutex_unlock(&cache_lock);
+}
+#endif
+
+/* Write back and forget the cached sectors of a disk */
+static void release_disk(struct disk_info *disk)
+{
+	(void)flush_disk(disk);
+
+	for (int i = 0; i < ARRAY_SIZE(blocks); i++) {
+		if (blocks[i].disk == disk) {
+			block_drop(&blocks[i]);
+		}
+	}
+}
+
+void disk_cache_attach(struct disk_info *disk)
+{
+	uint32_t sector_size = 0U;
+	uint32_t sector_count = 0U;
+
+	if (disk->ops->ioctl == NULL ||
+	    disk->ops->ioctl(disk, DISK_IOCTL_GET_SECTOR_SIZE,
+			     &sector_size) != 0 ||
+	    disk->ops->ioctl(disk, DISK_IOCTL_GET_SECTOR_COUNT,
+			     &sector_count) != 0) {
+		sector_count = 0U;
+	}
+
+	if (sector_size != SECTOR_SIZE) {
+		LOG_DBG("%s not cached, sector size %u", disk->name,
+			sector_size);
+		sector_count = 0U;
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	/* The media may have changed since the last init */
+	if (disk->cache_sector_count != 0U) {
+		release_disk(disk);
+	}
+
+	disk->cache_sector_count = sector_count;
+	disk->cache_next_sector = 0U;
+
+	k_mutex_unlock(&cache_lock);
+}
+
+void disk_cache_detach(struct disk_info *disk)
+{
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	if (disk->cache_sector_count != 0U) {
+		release_disk(disk);
+		disk->cache_sector_count = 0U;
+	}
+
+	k_mutex_unlock(&cache_lock);
+}
+
+void disk_cache_setup(void)
+{
+	sys_dlist_init(&lru);
+
+	for (int i = 0; i < ARRAY_SIZE(blocks); i++) {
+		blocks[i].data = block_data[i];
+		sys_dlist_append(&lru, &blocks[i].node);
+	}
+}
@@ -15,6 +15,48 @@
 #include <device.h>
 #include <drivers/flash.h>
 
+#ifdef CONFIG_FCB_LATENCY_STATS
+STATS_SECT_DECL(fcb_latency) fcb_latency;
+STATS_NAME_START(fcb_latency)
+STATS_NAME(fcb_latency, append_le_64us)
+STATS_NAME(fcb_latency, append_le_256us)
+STATS_NAME(fcb_latency, append_le_1ms)
+STATS_NAME(fcb_latency, append_le_4ms)
+STATS_NAME(fcb_latency, append_le_16ms)
+STATS_NAME(fcb_latency, append_le_64ms)
+STATS_NAME(fcb_latency, append_gt_64ms)
+STATS_NAME(fcb_latency, rotate_le_64us)
+STATS_NAME(fcb_latency, rotate_le_256us)
+STATS_NAME(fcb_latency, rotate_le_1ms)
+STATS_NAME(fcb_latency, rotate_le_4ms)
+STATS_NAME(fcb_latency, rotate_le_16ms)
+STATS_NAME(fcb_latency, rotate_le_64ms)
+STATS_NAME(fcb_latency, rotate_gt_64ms)
+STATS_NAME_END(fcb_latency);
+
+static bool fcb_latency_registered;
+
+/* hist points to the first of the FCB_LATENCY_BUCKETS entries of one
+ * histogram, entries of a stats group are laid out in declaration order.
+ */
+void
+fcb_latency_record(uint32_t *hist, uint32_t start)
+{
+	static const uint32_t bounds[FCB_LATENCY_BUCKETS - 1] = {
+		64U, 256U, 1000U, 4000U, 16000U, 64000U
+	};
+	uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(bounds); i++) {
+		if (us <= bounds[i]) {
+			break;
+		}
+	}
+	hist[i]++;
+}
+#endif
+
 uint8_t
 fcb_get_align(const struct fcb *fcb)
 {
@@ -91,6 +133,37 @@ fcb_erase_sector(const struct fcb *fcb, const struct flash_sector *sector)
 	return 0;
 }
 
+#ifdef CONFIG_FCB_BACKGROUND_ERASE
+/*
+ * Erase the sector rotated out last, unless the work queue did already.
+ */
+int
+fcb_erase_pending_finish(struct fcb *fcb)
+{
+	int rc = 0;
+
+	k_mutex_lock(&fcb->f_erase_mtx, K_FOREVER);
+	if (fcb->f_erase_pending) {
+		rc = fcb_erase_sector(fcb, fcb->f_erase_pending);
+		if (!rc) {
+			fcb->f_erase_pending = NULL;
+		}
+	}
+	k_mutex_unlock(&fcb->f_erase_mtx);
+
+	return rc;
+}
+
+static void
+fcb_erase_work_handler(struct k_work *work)
+{
+	struct fcb *fcb = CONTAINER_OF(work, struct fcb, f_erase_work);
+
+	/* On failure the erase is retried when the sector is needed */
+	(void)fcb_erase_pending_finish(fcb);
+}
+#endif
+
 int
 fcb_init(int f_area_id, struct fcb *fcb)
 {
@@ -117,6 +190,32 @@ fcb_init(int f_area_id, struct fcb *fcb)
 	fparam = flash_get_parameters(dev);
 	fcb->f_erase_value = fparam->erase_value;
 
+#ifdef CONFIG_FCB_BACKGROUND_ERASE
+	/*
+	 * The work item may still be queued from an earlier init, only
+	 * initialize it once and finish its erase before scanning.
+	 */
+	if (!fcb->f_erase_init) {
+		k_mutex_init(&fcb->f_erase_mtx);
+		k_work_init(&fcb->f_erase_work, fcb_erase_work_handler);
+		fcb->f_erase_pending = NULL;
+		fcb->f_erase_init = true;
+	} else {
+		rc = fcb_erase_pending_finish(fcb);
+		if (rc) {
+			return rc;
+		}
+	}
+#endif
+
+#ifdef CONFIG_FCB_LATENCY_STATS
+	if (!fcb_latency_registered) {
+		(void)STATS_INIT_AND_REG(fcb_latency, STATS_SIZE_32,
+					 "fcb_latency");
+		fcb_latency_registered = true;
+	}
+#endif
+
 	align = fcb_get_align(fcb);
 	if (align == 0U) {
 		return -EINVAL;
@@ -269,6 +368,16 @@ fcb_sector_hdr_init(struct fcb *fcb, struct flash_sector *sector, uint16_t id)
 	fda._pad = fcb->f_erase_value;
 	fda.fd_id = id;
 
+#ifdef CONFIG_FCB_BACKGROUND_ERASE
+	/* The sector may be taken into use before the work queue ran */
+	if (fcb->f_erase_pending == sector) {
+		rc = fcb_erase_pending_finish(fcb);
+		if (rc != 0) {
+			return -EIO;
+		}
+	}
+#endif
+
 	rc = fcb_flash_write(fcb, sector, 0, &fda, sizeof(fda));
 	if (rc != 0) {
 		return -EIO;
@@ -64,6 +64,9 @@ fcb_append(struct fcb *fcb, uint16_t len, struct fcb_entry *append_loc)
 	int cnt;
 	int rc;
 	uint8_t tmp_str[8];
+#ifdef CONFIG_FCB_LATENCY_STATS
+	uint32_t start = k_cycle_get_32();
+#endif
 
 	cnt = fcb_put_len(fcb, tmp_str, len);
 	if (cnt < 0) {
@@ -105,12 +108,12 @@ fcb_append(struct fcb *fcb, uint16_t len, struct fcb_entry *append_loc)
 	append_loc->fe_data_off = active->fe_elem_off + cnt;
 
 	active->fe_elem_off = append_loc->fe_data_off + len;
-
-	k_mutex_unlock(&fcb->f_mtx);
-
-	return 0;
+	rc = 0;
 err:
 	k_mutex_unlock(&fcb->f_mtx);
+#ifdef CONFIG_FCB_LATENCY_STATS
+	fcb_latency_record(&fcb_latency.append_le_64us, start);
+#endif
 	return rc;
 }
 
@@ -73,6 +73,40 @@ int fcb_elem_info(struct fcb *fcb, struct fcb_entry *loc);
 int fcb_elem_crc8(struct fcb *fcb, struct fcb_entry *loc, uint8_t *crc8p);
 
 int fcb_sector_hdr_init(struct fcb *fcb, struct flash_sector *sector, uint16_t id);
+
+#ifdef CONFIG_FCB_BACKGROUND_ERASE
+int fcb_erase_pending_finish(struct fcb *fcb);
+#endif
+
+#ifdef CONFIG_FCB_LATENCY_STATS
+#include <stats/stats.h>
+
+/* Histograms of the fcb_append() and fcb_rotate() duration, with bounds
+ * in microseconds. Each histogram is a run of FCB_LATENCY_BUCKETS entries.
+ */
+#define FCB_LATENCY_BUCKETS 7
+
+STATS_SECT_START(fcb_latency)
+STATS_SECT_ENTRY32(append_le_64us)
+STATS_SECT_ENTRY32(append_le_256us)
+STATS_SECT_ENTRY32(append_le_1ms)
+STATS_SECT_ENTRY32(append_le_4ms)
+STATS_SECT_ENTRY32(append_le_16ms)
+STATS_SECT_ENTRY32(append_le_64ms)
+STATS_SECT_ENTRY32(append_gt_64ms)
+STATS_SECT_ENTRY32(rotate_le_64us)
+STATS_SECT_ENTRY32(rotate_le_256us)
+STATS_SECT_ENTRY32(rotate_le_1ms)
+STATS_SECT_ENTRY32(rotate_le_4ms)
+STATS_SECT_ENTRY32(rotate_le_16ms)
+STATS_SECT_ENTRY32(rotate_le_64ms)
+STATS_SECT_ENTRY32(rotate_gt_64ms)
+STATS_SECT_END;
+
+extern STATS_SECT_DECL(fcb_latency) fcb_latency;
+
+void fcb_latency_record(uint32_t *hist, uint32_t start);
+#endif
 int fcb_sector_hdr_read(struct fcb *fcb, struct flash_sector *sector,
 			struct fcb_disk_area *fdap);
 
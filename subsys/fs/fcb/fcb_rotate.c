@@ -13,17 +13,40 @@ fcb_rotate(struct fcb *fcb)
 {
 	struct flash_sector *sector;
 	int rc = 0;
+#ifdef CONFIG_FCB_LATENCY_STATS
+	uint32_t start = k_cycle_get_32();
+#endif
 
 	rc = k_mutex_lock(&fcb->f_mtx, K_FOREVER);
 	if (rc) {
 		return -EINVAL;
 	}
 
+#ifdef CONFIG_FCB_BACKGROUND_ERASE
+	/*
+	 * Only one sector is pending erase at a time, the previous one is
+	 * normally done by now.
+	 */
+	rc = fcb_erase_pending_finish(fcb);
+	if (rc) {
+		rc = -EIO;
+		goto out;
+	}
+
+	/*
+	 * The oldest sector is not walked once f_oldest moves past it,
+	 * leave its erase to the work queue.
+	 */
+	k_mutex_lock(&fcb->f_erase_mtx, K_FOREVER);
+	fcb->f_erase_pending = fcb->f_oldest;
+	k_mutex_unlock(&fcb->f_erase_mtx);
+#else
 	rc = fcb_erase_sector(fcb, fcb->f_oldest);
 	if (rc) {
 		rc = -EIO;
 		goto out;
 	}
+#endif
 	if (fcb->f_oldest == fcb->f_active.fe_sector) {
 		/*
 		 * Need to create a new active area, as we're wiping
@@ -39,7 +62,13 @@ fcb_rotate(struct fcb *fcb)
 		fcb->f_active_id++;
 	}
 	fcb->f_oldest = fcb_getnext_sector(fcb, fcb->f_oldest);
+#ifdef CONFIG_FCB_BACKGROUND_ERASE
+	k_work_submit(&fcb->f_erase_work);
+#endif
 out:
 	k_mutex_unlock(&fcb->f_mtx);
+#ifdef CONFIG_FCB_LATENCY_STATS
+	fcb_latency_record(&fcb_latency.rotate_le_64us, start);
+#endif
 	return rc;
 }
@@ -16,6 +16,9 @@
 #include <sys/check.h>
 #include <sys/stat.h>
 
+#ifdef CONFIG_FILE_SYSTEM_ASYNC
+#include "fs_async.h"
+#endif
 
 #define LOG_LEVEL CONFIG_FS_LOG_LEVEL
 #include <logging/log.h>
@@ -704,6 +707,9 @@ int fs_mount(struct fs_mount_t *mp)
 	/* Update mount point data and append it to the list */
 	mp->mountp_len = len;
 	mp->fs = fs;
+#ifdef CONFIG_FILE_SYSTEM_ASYNC
+	fs_async_mount_init(mp);
+#endif
 
 	sys_dlist_append(&fs_mnt_list, &mp->node);
 	LOG_DBG("fs mounted at %s", log_strdup(mp->mnt_point));
@@ -735,6 +741,14 @@ int fs_unmount(struct fs_mount_t *mp)
 		goto unmount_err;
 	}
 
+#ifdef CONFIG_FILE_SYSTEM_ASYNC
+	if (fs_async_busy(mp)) {
+		LOG_ERR("fs has pending requests");
+		rc = -EBUSY;
+		goto unmount_err;
+	}
+#endif
+
 	rc = mp->fs->unmount(mp);
 	if (rc < 0) {
 		LOG_ERR("fs unmount error (%d)", rc);
@@ -830,6 +844,9 @@ static int fs_init(const struct device *dev)
 {
 	k_mutex_init(&mutex);
 	sys_dlist_init(&fs_mnt_list);
+#ifdef CONFIG_FILE_SYSTEM_ASYNC
+	fs_async_init();
+#endif
 	return 0;
 }
 
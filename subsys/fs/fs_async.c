@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2021 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <kernel.h>
+#include <errno.h>
+#include <fs/fs.h>
+#include <fs/fs_sys.h>
+#include <sys/check.h>
+
+#include "fs_async.h"
+
+#define LOG_LEVEL CONFIG_FS_LOG_LEVEL
+#include <logging/log.h>
+LOG_MODULE_DECLARE(fs);
+
+/*
+ * Asynchronous requests are queued per mount point. A mount point with
+ * requests waits in a ready list until one of the workers takes it, the
+ * worker then services its requests in order, so requests of a mount
+ * point never run concurrently while different mount points are
+ * serviced in parallel.
+ */
+
+enum {
+	FS_ASYNC_READ,
+	FS_ASYNC_WRITE,
+	FS_ASYNC_SYNC,
+};
+
+#define MERGE_SIZE CONFIG_FILE_SYSTEM_ASYNC_MERGE_SIZE
+
+static sys_slist_t ready_mounts;
+static struct k_spinlock lock;
+static K_SEM_DEFINE(ready_sem, 0, K_SEM_MAX_LIMIT);
+
+static K_THREAD_STACK_ARRAY_DEFINE(worker_stacks,
+				   CONFIG_FILE_SYSTEM_ASYNC_WORKERS,
+				   CONFIG_FILE_SYSTEM_ASYNC_STACK_SIZE);
+static struct k_thread workers[CONFIG_FILE_SYSTEM_ASYNC_WORKERS];
+
+#if MERGE_SIZE > 0
+static uint8_t merge_bufs[CONFIG_FILE_SYSTEM_ASYNC_WORKERS][MERGE_SIZE];
+#endif
+
+static int submit(struct fs_file_t *zfp, struct fs_async_req *req)
+{
+	/* Only the request queue of the mount point is modified */
+	struct fs_mount_t *mp = (struct fs_mount_t *)zfp->mp;
+	k_spinlock_key_t key;
+
+	req->zfp = zfp;
+
+	key = k_spin_lock(&lock);
+
+	sys_slist_append(&mp->async_reqs, &req->node);
+
+	/* The worker servicing the mount point will get to it */
+	if (!mp->async_busy && sys_slist_peek_head(&mp->async_reqs) ==
+	    &req->node) {
+		sys_slist_append(&ready_mounts, &mp->async_node);
+		k_sem_give(&ready_sem);
+	}
+
+	k_spin_unlock(&lock, key);
+
+	return 0;
+}
+
+int fs_read_async(struct fs_file_t *zfp, void *ptr, size_t size,
+		  off_t offset, struct fs_async_req *req)
+{
+	if (zfp->mp == NULL) {
+		return -EBADF;
+	}
+
+	CHECKIF(zfp->mp->fs->read == NULL || zfp->mp->fs->lseek == NULL) {
+		return -ENOTSUP;
+	}
+
+	req->op = FS_ASYNC_READ;
+	req->ptr = ptr;
+	req->size = size;
+	req->offset = offset;
+
+	return submit(zfp, req);
+}
+
+int fs_write_async(struct fs_file_t *zfp, const void *ptr, size_t size,
+		   off_t offset, struct fs_async_req *req)
+{
+	if (zfp->mp == NULL) {
+		return -EBADF;
+	}
+
+	CHECKIF(zfp->mp->fs->write == NULL || zfp->mp->fs->lseek == NULL) {
+		return -ENOTSUP;
+	}
+
+	req->op = FS_ASYNC_WRITE;
+	req->ptr = (void *)ptr;
+	req->size = size;
+	req->offset = offset;
+
+	return submit(zfp, req);
+}
+
+int fs_sync_async(struct fs_file_t *zfp, struct fs_async_req *req)
+{
+	if (zfp->mp == NULL) {
+		return -EBADF;
+	}
+
+	CHECKIF(zfp->mp->fs->sync == NULL) {
+		return -ENOTSUP;
+	}
+
+	req->op = FS_ASYNC_SYNC;
+	req->ptr = NULL;
+	req->size = 0;
+	req->offset = 0;
+
+	return submit(zfp, req);
+}
+
+static void complete(struct fs_async_req *req, ssize_t result)
+{
+	struct k_poll_signal *signal = req->signal;
+
+	req->result = result;
+
+	if (req->cb != NULL) {
+		req->cb(req, result);
+	}
+
+	/* The request may be reused as soon as the signal is raised */
+	if (signal != NULL) {
+		k_poll_signal_raise(signal, result);
+	}
+}
+
+/* Whether next can be done together with the requests from first, which
+ * add up to size bytes.
+ */
+static bool mergeable(struct fs_async_req *first, size_t size,
+		      struct fs_async_req *next)
+{
+	if (next->zfp != first->zfp || next->op != first->op) {
+		return false;
+	}
+
+	if (first->op == FS_ASYNC_SYNC) {
+		return true;
+	}
+
+	return next->offset == first->offset + size &&
+	       size + next->size <= MERGE_SIZE;
+}
+
+static ssize_t do_io(struct fs_async_req *req, void *ptr, size_t size)
+{
+	struct fs_file_t *zfp = req->zfp;
+	int rc;
+
+	if (zfp->mp == NULL) {
+		return -EBADF;
+	}
+
+	if (req->op == FS_ASYNC_SYNC) {
+		return zfp->mp->fs->sync(zfp);
+	}
+
+	rc = zfp->mp->fs->lseek(zfp, req->offset, FS_SEEK_SET);
+	if (rc < 0) {
+		return rc;
+	}
+
+	if (req->op == FS_ASYNC_READ) {
+		return zfp->mp->fs->read(zfp, ptr, size);
+	}
+
+	return zfp->mp->fs->write(zfp, ptr, size);
+}
+
+/* Service the first request of a mount point, together with the ones
+ * following it that can be merged with it.
+ */
+static void service(struct fs_mount_t *mp, uint8_t *buf)
+{
+	struct fs_async_req *first, *req;
+	sys_slist_t batch;
+	k_spinlock_key_t key;
+	size_t size, done;
+	ssize_t rc;
+
+	sys_slist_init(&batch);
+
+	key = k_spin_lock(&lock);
+
+	first = SYS_SLIST_CONTAINER(sys_slist_get_not_empty(&mp->async_reqs),
+				    first, node);
+	sys_slist_append(&batch, &first->node);
+	size = first->size;
+
+	while (buf != NULL || first->op == FS_ASYNC_SYNC) {
+		req = SYS_SLIST_PEEK_HEAD_CONTAINER(&mp->async_reqs, req, node);
+		if (req == NULL || !mergeable(first, size, req)) {
+			break;
+		}
+
+		sys_slist_get_not_empty(&mp->async_reqs);
+		sys_slist_append(&batch, &req->node);
+		size += req->size;
+	}
+
+	k_spin_unlock(&lock, key);
+
+	if (sys_slist_peek_head(&batch) == sys_slist_peek_tail(&batch)) {
+		rc = do_io(first, first->ptr, first->size);
+	} else if (first->op == FS_ASYNC_SYNC) {
+		rc = do_io(first, NULL, 0);
+	} else {
+		LOG_DBG("merged %zu bytes at %ld", size, (long)first->offset);
+
+		if (first->op == FS_ASYNC_WRITE) {
+			done = 0;
+			SYS_SLIST_FOR_EACH_CONTAINER(&batch, req, node) {
+				memcpy(&buf[done], req->ptr, req->size);
+				done += req->size;
+			}
+		}
+
+		rc = do_io(first, buf, size);
+
+		if (first->op == FS_ASYNC_READ && rc > 0) {
+			done = 0;
+			SYS_SLIST_FOR_EACH_CONTAINER(&batch, req, node) {
+				memcpy(req->ptr, &buf[done],
+				       MIN(req->size, rc - done));
+				done += MIN(req->size, rc - done);
+			}
+		}
+	}
+
+	/* Split a short transfer over the requests in order */
+	done = 0;
+	while ((req = SYS_SLIST_CONTAINER(sys_slist_get(&batch),
+					  req, node)) != NULL) {
+		if (rc < 0 || req->op == FS_ASYNC_SYNC) {
+			complete(req, rc);
+		} else {
+			complete(req, MIN(req->size, rc - done));
+			done += MIN(req->size, rc - done);
+		}
+	}
+}
+
+static void worker(void *p1, void *p2, void *p3)
+{
+	uint8_t *buf = p1;
+	struct fs_mount_t *mp;
+	k_spinlock_key_t key;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		k_sem_take(&ready_sem, K_FOREVER);
+
+		key = k_spin_lock(&lock);
+		mp = SYS_SLIST_CONTAINER(sys_slist_get_not_empty(&ready_mounts),
+					 mp, async_node);
+		mp->async_busy = true;
+		k_spin_unlock(&lock, key);
+
+		do {
+			service(mp, buf);
+
+			key = k_spin_lock(&lock);
+			if (sys_slist_is_empty(&mp->async_reqs)) {
+				mp->async_busy = false;
+			}
+			k_spin_unlock(&lock, key);
+		} while (mp->async_busy);
+	}
+}
+
+bool fs_async_busy(struct fs_mount_t *mp)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	bool busy = mp->async_busy || !sys_slist_is_empty(&mp->async_reqs);
+
+	k_spin_unlock(&lock, key);
+
+	return busy;
+}
+
+void fs_async_mount_init(struct fs_mount_t *mp)
+{
+	sys_slist_init(&mp->async_reqs);
+	mp->async_busy = false;
+}
+
+void fs_async_init(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(workers); i++) {
+		void *buf = NULL;
+
+#if MERGE_SIZE > 0
+		buf = merge_bufs[i];
+#endif
+		k_thread_create(&workers[i], worker_stacks[i],
+				K_THREAD_STACK_SIZEOF(worker_stacks[i]),
+				worker, buf, NULL, NULL,
+				CONFIG_FILE_SYSTEM_ASYNC_PRIORITY, 0, K_NO_WAIT);
+		k_thread_name_set(&workers[i], "fs_async");
+	}
+}
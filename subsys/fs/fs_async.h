@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2021 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Asynchronous request workers, used by the file system core. */
+
+#ifndef ZEPHYR_SUBSYS_FS_FS_ASYNC_H_
+#define ZEPHYR_SUBSYS_FS_FS_ASYNC_H_
+
+#include <fs/fs.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void fs_async_init(void);
+void fs_async_mount_init(struct fs_mount_t *mp);
+bool fs_async_busy(struct fs_mount_t *mp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_SUBSYS_FS_FS_ASYNC_H_ */
@@ -149,13 +149,246 @@ static int errno_to_lfs(int error)
 }
 
 
+#ifdef CONFIG_FS_LITTLEFS_STATS
+STATS_NAME_START(littlefs_stats)
+STATS_NAME(littlefs_stats, reads)
+STATS_NAME(littlefs_stats, progs)
+STATS_NAME(littlefs_stats, erases)
+STATS_NAME(littlefs_stats, cache_hits)
+STATS_NAME(littlefs_stats, cache_misses)
+STATS_NAME_END(littlefs_stats);
+
+#define FS_STATS_INC(fs, var) STATS_INC((fs)->stats, var)
+#else
+#define FS_STATS_INC(fs, var)
+#endif
+
+static inline struct fs_littlefs *fs_from_config(const struct lfs_config *c)
+{
+	return CONTAINER_OF(c, struct fs_littlefs, cfg);
+}
+
+static int flash_read_block(struct fs_littlefs *fs, lfs_block_t block,
+			    lfs_off_t off, void *buffer, lfs_size_t size)
+{
+	size_t offset = block * fs->cfg.block_size + off;
+
+	FS_STATS_INC(fs, reads);
+
+	return flash_area_read(fs->area, offset, buffer, size);
+}
+
+#ifdef CONFIG_FS_LITTLEFS_BLOCK_CACHE
+
+/* The mount-wide block cache holds cache_size bytes aligned parts of
+ * blocks. Its entries are kept in a list from the most to the least
+ * recently used, with the unused entries at the end, and are looked up
+ * linearly as there are few of them.
+ */
+struct block_cache_entry {
+	sys_dnode_t node;
+	lfs_block_t block;
+	lfs_off_t off;
+	uint8_t data[];
+};
+
+#define BLOCK_CACHE_UNUSED ((lfs_block_t)-1)
+
+#if (CONFIG_FS_LITTLEFS_BLOCK_CACHE_HEAP_SIZE - 0) <= 0
+#undef CONFIG_FS_LITTLEFS_BLOCK_CACHE_HEAP_SIZE
+#define CONFIG_FS_LITTLEFS_BLOCK_CACHE_HEAP_SIZE				\
+	((ROUND_UP(sizeof(struct block_cache_entry) +				\
+		   CONFIG_FS_LITTLEFS_CACHE_SIZE, sizeof(void *)) *		\
+	  CONFIG_FS_LITTLEFS_BLOCK_CACHE_ENTRIES +				\
+	  FC_HEAP_PER_ALLOC_OVERHEAD) *						\
+	 MAX(DT_NUM_INST_STATUS_OKAY(zephyr_fstab_littlefs), 1))
+#endif /* CONFIG_FS_LITTLEFS_BLOCK_CACHE_HEAP_SIZE */
+
+static K_HEAP_DEFINE(block_cache_heap, CONFIG_FS_LITTLEFS_BLOCK_CACHE_HEAP_SIZE);
+
+static void block_cache_init(struct fs_littlefs *fs)
+{
+	size_t stride = ROUND_UP(sizeof(struct block_cache_entry) +
+				 fs->cfg.cache_size, sizeof(void *));
+	uint8_t *mem;
+
+	sys_dlist_init(&fs->block_cache);
+
+	mem = k_heap_alloc(&block_cache_heap,
+			   stride * CONFIG_FS_LITTLEFS_BLOCK_CACHE_ENTRIES,
+			   K_NO_WAIT);
+	fs->block_cache_mem = mem;
+	if (mem == NULL) {
+		LOG_WRN("no memory for block cache");
+		return;
+	}
+
+	for (int i = 0; i < CONFIG_FS_LITTLEFS_BLOCK_CACHE_ENTRIES; i++) {
+		struct block_cache_entry *e = (void *)&mem[i * stride];
+
+		e->block = BLOCK_CACHE_UNUSED;
+		sys_dlist_append(&fs->block_cache, &e->node);
+	}
+}
+
+static void block_cache_release(struct fs_littlefs *fs)
+{
+	if (fs->block_cache_mem != NULL) {
+		k_heap_free(&block_cache_heap, fs->block_cache_mem);
+		fs->block_cache_mem = NULL;
+	}
+}
+
+static struct block_cache_entry *block_cache_find(struct fs_littlefs *fs,
+						  lfs_block_t block,
+						  lfs_off_t off)
+{
+	struct block_cache_entry *e;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&fs->block_cache, e, node) {
+		if (e->block == BLOCK_CACHE_UNUSED) {
+			break;
+		}
+
+		if (e->block == block && e->off == off) {
+			return e;
+		}
+	}
+
+	return NULL;
+}
+
+static void block_cache_use(struct fs_littlefs *fs,
+			    struct block_cache_entry *e)
+{
+	sys_dlist_remove(&e->node);
+	sys_dlist_prepend(&fs->block_cache, &e->node);
+}
+
+static void block_cache_drop(struct fs_littlefs *fs,
+			     struct block_cache_entry *e)
+{
+	e->block = BLOCK_CACHE_UNUSED;
+	sys_dlist_remove(&e->node);
+	sys_dlist_append(&fs->block_cache, &e->node);
+}
+
+/* Update the entries overlapping a program of the block with its data,
+ * or drop them when data is NULL after an erase or a failed program.
+ */
+static void block_cache_update(struct fs_littlefs *fs, lfs_block_t block,
+			       lfs_off_t off, const uint8_t *data,
+			       lfs_size_t size)
+{
+	lfs_size_t line = fs->cfg.cache_size;
+	struct block_cache_entry *e, *next;
+
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&fs->block_cache, e, next, node) {
+		if (e->block == BLOCK_CACHE_UNUSED) {
+			break;
+		}
+
+		if (e->block != block || e->off >= off + size ||
+		    off >= e->off + line) {
+			continue;
+		}
+
+		if (data == NULL) {
+			block_cache_drop(fs, e);
+		} else {
+			lfs_off_t start = MAX(e->off, off);
+			lfs_off_t end = MIN(e->off + line, off + size);
+
+			memcpy(&e->data[start - e->off], &data[start - off],
+			       end - start);
+		}
+	}
+}
+
+static int block_cache_read(struct fs_littlefs *fs, lfs_block_t block,
+			    lfs_off_t off, uint8_t *buffer, lfs_size_t size)
+{
+	lfs_size_t line = fs->cfg.cache_size;
+	/* Large reads go to the flash for what is not cached already */
+	bool bypass = size > line;
+	lfs_off_t run_off = off;
+	uint8_t *run_buf = buffer;
+	lfs_size_t run_size = 0;
+	int rc;
+
+	while (size > 0) {
+		lfs_off_t line_off = off - (off % line);
+		lfs_size_t n = MIN(size, line_off + line - off);
+		struct block_cache_entry *e;
+
+		e = block_cache_find(fs, block, line_off);
+		if (e != NULL) {
+			FS_STATS_INC(fs, cache_hits);
+
+			memcpy(buffer, &e->data[off - line_off], n);
+			block_cache_use(fs, e);
+		} else if (bypass) {
+			FS_STATS_INC(fs, cache_misses);
+
+			/* Read consecutive misses at once */
+			if (run_size == 0) {
+				run_off = off;
+				run_buf = buffer;
+			}
+			run_size += n;
+		} else {
+			FS_STATS_INC(fs, cache_misses);
+
+			e = SYS_DLIST_CONTAINER(sys_dlist_peek_tail(
+							&fs->block_cache),
+						e, node);
+			rc = flash_read_block(fs, block, line_off, e->data,
+					      line);
+			if (rc < 0) {
+				block_cache_drop(fs, e);
+				return rc;
+			}
+
+			e->block = block;
+			e->off = line_off;
+			memcpy(buffer, &e->data[off - line_off], n);
+			block_cache_use(fs, e);
+		}
+
+		if (run_size > 0 && (e != NULL || n == size)) {
+			rc = flash_read_block(fs, block, run_off, run_buf,
+					      run_size);
+			if (rc < 0) {
+				return rc;
+			}
+
+			run_size = 0;
+		}
+
+		off += n;
+		buffer += n;
+		size -= n;
+	}
+
+	return 0;
+}
+
+#endif /* CONFIG_FS_LITTLEFS_BLOCK_CACHE */
+
 static int lfs_api_read(const struct lfs_config *c, lfs_block_t block,
 			lfs_off_t off, void *buffer, lfs_size_t size)
 {
-	const struct flash_area *fa = c->context;
-	size_t offset = block * c->block_size + off;
-
-	int rc = flash_area_read(fa, offset, buffer, size);
+	struct fs_littlefs *fs = fs_from_config(c);
+	int rc;
+
+#ifdef CONFIG_FS_LITTLEFS_BLOCK_CACHE
+	if (fs->block_cache_mem != NULL) {
+		rc = block_cache_read(fs, block, off, buffer, size);
+	} else
+#endif
+	{
+		rc = flash_read_block(fs, block, off, buffer, size);
+	}
 
 	return errno_to_lfs(rc);
 }
@@ -163,20 +396,37 @@ static int lfs_api_read(const struct lfs_config *c, lfs_block_t block,
 static int lfs_api_prog(const struct lfs_config *c, lfs_block_t block,
 			lfs_off_t off, const void *buffer, lfs_size_t size)
 {
-	const struct flash_area *fa = c->context;
+	struct fs_littlefs *fs = fs_from_config(c);
 	size_t offset = block * c->block_size + off;
 
-	int rc = flash_area_write(fa, offset, buffer, size);
+	FS_STATS_INC(fs, progs);
+
+	int rc = flash_area_write(fs->area, offset, buffer, size);
+
+#ifdef CONFIG_FS_LITTLEFS_BLOCK_CACHE
+	if (fs->block_cache_mem != NULL) {
+		block_cache_update(fs, block, off, rc == 0 ? buffer : NULL,
+				   size);
+	}
+#endif
 
 	return errno_to_lfs(rc);
 }
 
 static int lfs_api_erase(const struct lfs_config *c, lfs_block_t block)
 {
-	const struct flash_area *fa = c->context;
+	struct fs_littlefs *fs = fs_from_config(c);
 	size_t offset = block * c->block_size;
 
-	int rc = flash_area_erase(fa, offset, c->block_size);
+	FS_STATS_INC(fs, erases);
+
+	int rc = flash_area_erase(fs->area, offset, c->block_size);
+
+#ifdef CONFIG_FS_LITTLEFS_BLOCK_CACHE
+	if (fs->block_cache_mem != NULL) {
+		block_cache_update(fs, block, 0, NULL, c->block_size);
+	}
+#endif
 
 	return errno_to_lfs(rc);
 }
@@ -690,6 +940,21 @@ static int littlefs_mount(struct fs_mount_t *mountp)
 	lcp->cache_size = cache_size;
 	lcp->lookahead_size = lookahead_size;
 
+#ifdef CONFIG_FS_LITTLEFS_STATS
+	/* Counts go on across remounts of the same mount point */
+	if (stats_group_find(mountp->mnt_point) == NULL) {
+		stats_init(&fs->stats.s_hdr, STATS_SIZE_32,
+			   (sizeof(fs->stats) - sizeof(struct stats_hdr)) /
+			   STATS_SIZE_32,
+			   STATS_NAME_INIT_PARMS(littlefs_stats));
+		(void)stats_register(mountp->mnt_point, &fs->stats.s_hdr);
+	}
+#endif
+
+#ifdef CONFIG_FS_LITTLEFS_BLOCK_CACHE
+	block_cache_init(fs);
+#endif
+
 	/* Mount it, formatting if needed. */
 	ret = lfs_mount(&fs->lfs, &fs->cfg);
 	if (ret < 0 &&
@@ -721,6 +986,9 @@ static int littlefs_mount(struct fs_mount_t *mountp)
 out:
 	if (ret < 0) {
 		fs->area = NULL;
+#ifdef CONFIG_FS_LITTLEFS_BLOCK_CACHE
+		block_cache_release(fs);
+#endif
 	}
 
 	fs_unlock(fs);
@@ -738,6 +1006,10 @@ static int littlefs_unmount(struct fs_mount_t *mountp)
 	flash_area_close(fs->area);
 	fs->area = NULL;
 
+#ifdef CONFIG_FS_LITTLEFS_BLOCK_CACHE
+	block_cache_release(fs);
+#endif
+
 	fs_unlock(fs);
 
 	LOG_INF("%s unmounted", log_strdup(mountp->mnt_point));
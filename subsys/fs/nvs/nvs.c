@@ -11,11 +11,59 @@
 #include <inttypes.h>
 #include <fs/nvs.h>
 #include <sys/crc.h>
+#include <stats/stats.h>
 #include "nvs_priv.h"
 
 #include <logging/log.h>
 LOG_MODULE_REGISTER(fs_nvs, CONFIG_NVS_LOG_LEVEL);
 
+#ifdef CONFIG_NVS_WRITE_LATENCY_STATS
+/* Histogram of the nvs_write() duration, with bounds in microseconds */
+STATS_SECT_START(nvs_write_latency)
+STATS_SECT_ENTRY32(le_64us)
+STATS_SECT_ENTRY32(le_256us)
+STATS_SECT_ENTRY32(le_1ms)
+STATS_SECT_ENTRY32(le_4ms)
+STATS_SECT_ENTRY32(le_16ms)
+STATS_SECT_ENTRY32(le_64ms)
+STATS_SECT_ENTRY32(gt_64ms)
+STATS_SECT_END;
+
+STATS_SECT_DECL(nvs_write_latency) nvs_write_latency;
+STATS_NAME_START(nvs_write_latency)
+STATS_NAME(nvs_write_latency, le_64us)
+STATS_NAME(nvs_write_latency, le_256us)
+STATS_NAME(nvs_write_latency, le_1ms)
+STATS_NAME(nvs_write_latency, le_4ms)
+STATS_NAME(nvs_write_latency, le_16ms)
+STATS_NAME(nvs_write_latency, le_64ms)
+STATS_NAME(nvs_write_latency, gt_64ms)
+STATS_NAME_END(nvs_write_latency);
+
+static bool nvs_write_latency_registered;
+
+static void nvs_write_latency_record(uint32_t start)
+{
+	uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+	if (us <= 64U) {
+		STATS_INC(nvs_write_latency, le_64us);
+	} else if (us <= 256U) {
+		STATS_INC(nvs_write_latency, le_256us);
+	} else if (us <= 1000U) {
+		STATS_INC(nvs_write_latency, le_1ms);
+	} else if (us <= 4000U) {
+		STATS_INC(nvs_write_latency, le_4ms);
+	} else if (us <= 16000U) {
+		STATS_INC(nvs_write_latency, le_16ms);
+	} else if (us <= 64000U) {
+		STATS_INC(nvs_write_latency, le_64ms);
+	} else {
+		STATS_INC(nvs_write_latency, gt_64ms);
+	}
+}
+#endif
+
 /* basic routines */
 /* nvs_al_size returns size aligned to fs->write_block_size */
 static inline size_t nvs_al_size(struct nvs_fs *fs, size_t len)
@@ -27,6 +75,24 @@ static inline size_t nvs_al_size(struct nvs_fs *fs, size_t len)
 	}
 	return (len + (write_block_size - 1U)) & ~(write_block_size - 1U);
 }
+
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+static inline size_t nvs_lookup_cache_pos(uint16_t id)
+{
+	uint16_t hash;
+
+	/* CRC of the ID spreads both consecutive IDs and IDs that differ in
+	 * their upper bits (as used by the settings backend) over the cache
+	 */
+#if CONFIG_NVS_LOOKUP_CACHE_SIZE <= UINT8_MAX + 1
+	hash = crc8_ccitt(0xff, &id, sizeof(id));
+#else
+	hash = crc16_ccitt(0xffff, (const uint8_t *)&id, sizeof(id));
+#endif
+
+	return hash % CONFIG_NVS_LOOKUP_CACHE_SIZE;
+}
+#endif
 /* end basic routines */
 
 /* flash routines */
@@ -96,6 +162,12 @@ static int nvs_flash_ate_wrt(struct nvs_fs *fs, const struct nvs_ate *entry)
 
 	rc = nvs_flash_al_wrt(fs, fs->ate_wra, entry,
 			       sizeof(struct nvs_ate));
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	/* 0xFFFF is used by the close and gc done ate, keep it out */
+	if (entry->id != 0xFFFF) {
+		fs->lookup_cache[nvs_lookup_cache_pos(entry->id)] = fs->ate_wra;
+	}
+#endif
 	fs->ate_wra -= nvs_al_size(fs, sizeof(struct nvs_ate));
 
 	return rc;
@@ -239,6 +311,37 @@ static int nvs_flash_erase_sector(struct nvs_fs *fs, uint32_t addr)
 	return rc;
 }
 
+#ifdef CONFIG_NVS_BACKGROUND_ERASE
+/* erase the sector left by gc if the work queue did not do it yet.
+ * return 0 if OK, errorcode on error.
+ */
+static int nvs_erase_pending_finish(struct nvs_fs *fs)
+{
+	int rc = 0;
+
+	k_mutex_lock(&fs->erase_lock, K_FOREVER);
+	if (fs->erase_pending) {
+		rc = nvs_flash_erase_sector(fs, fs->erase_addr);
+		if (!rc) {
+			fs->erase_pending = false;
+		}
+	}
+	k_mutex_unlock(&fs->erase_lock);
+
+	return rc;
+}
+
+static void nvs_erase_work_handler(struct k_work *work)
+{
+	struct nvs_fs *fs = CONTAINER_OF(work, struct nvs_fs, erase_work);
+
+	/* on error the erase is retried before the sector is used */
+	if (nvs_erase_pending_finish(fs)) {
+		LOG_ERR("Background erase failed");
+	}
+}
+#endif
+
 /* crc update on allocation entry */
 static void nvs_ate_crc8_update(struct nvs_ate *entry)
 {
@@ -419,6 +522,18 @@ static int nvs_prev_ate(struct nvs_fs *fs, uint32_t *addr, struct nvs_ate *ate)
 		*addr -= (1 << ADDR_SECT_SHIFT);
 	}
 
+#ifdef CONFIG_NVS_BACKGROUND_ERASE
+	/* the sector pending erase has been gc'ed, it is not part of the
+	 * filesystem anymore
+	 */
+	if (fs->erase_pending &&
+	    (((*addr) >> ADDR_SECT_SHIFT) ==
+	     (fs->erase_addr >> ADDR_SECT_SHIFT))) {
+		*addr = fs->ate_wra;
+		return 0;
+	}
+#endif
+
 	rc = nvs_flash_ate_rd(fs, *addr, &close_ate);
 	if (rc) {
 		return rc;
@@ -449,6 +564,55 @@ static int nvs_prev_ate(struct nvs_fs *fs, uint32_t *addr, struct nvs_ate *ate)
 	return nvs_recover_last_ate(fs, addr);
 }
 
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+/* Fill the lookup cache with the newest valid ate of each position by
+ * walking all ate's once, from newest to oldest.
+ */
+static int nvs_lookup_cache_rebuild(struct nvs_fs *fs)
+{
+	int rc;
+	uint32_t addr, ate_addr;
+	uint32_t *cache_entry;
+	struct nvs_ate ate;
+
+	(void)memset(fs->lookup_cache, 0xff, sizeof(fs->lookup_cache));
+	addr = fs->ate_wra;
+
+	while (1) {
+		/* nvs_prev_ate() moves addr to the previous ate */
+		ate_addr = addr;
+		rc = nvs_prev_ate(fs, &addr, &ate);
+		if (rc) {
+			return rc;
+		}
+
+		cache_entry = &fs->lookup_cache[nvs_lookup_cache_pos(ate.id)];
+
+		if ((ate.id != 0xFFFF) &&
+		    (*cache_entry == NVS_LOOKUP_CACHE_NO_ADDR) &&
+		    nvs_ate_valid(fs, &ate)) {
+			*cache_entry = ate_addr;
+		}
+
+		if (addr == fs->ate_wra) {
+			break;
+		}
+	}
+
+	return 0;
+}
+
+/* Drop the cache entries pointing to a sector that is about to be erased */
+static void nvs_lookup_cache_invalidate(struct nvs_fs *fs, uint32_t sector)
+{
+	for (size_t i = 0; i < CONFIG_NVS_LOOKUP_CACHE_SIZE; i++) {
+		if ((fs->lookup_cache[i] >> ADDR_SECT_SHIFT) == sector) {
+			fs->lookup_cache[i] = NVS_LOOKUP_CACHE_NO_ADDR;
+		}
+	}
+}
+#endif
+
 static void nvs_sector_advance(struct nvs_fs *fs, uint32_t *addr)
 {
 	*addr += (1 << ADDR_SECT_SHIFT);
@@ -551,7 +715,15 @@ static int nvs_gc(struct nvs_fs *fs)
 			continue;
 		}
 
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+		wlk_addr = fs->lookup_cache[nvs_lookup_cache_pos(gc_ate.id)];
+
+		if (wlk_addr == NVS_LOOKUP_CACHE_NO_ADDR) {
+			wlk_addr = fs->ate_wra;
+		}
+#else
 		wlk_addr = fs->ate_wra;
+#endif
 		do {
 			wlk_prev_addr = wlk_addr;
 			rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
@@ -609,11 +781,27 @@ gc_done:
 		}
 	}
 
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	nvs_lookup_cache_invalidate(fs, sec_addr >> ADDR_SECT_SHIFT);
+#endif
+
+#ifdef CONFIG_NVS_BACKGROUND_ERASE
+	/* The gc'ed sector is only written again after the next sector
+	 * close, leave its erase to the work queue.
+	 */
+	k_mutex_lock(&fs->erase_lock, K_FOREVER);
+	fs->erase_addr = sec_addr;
+	fs->erase_pending = true;
+	k_mutex_unlock(&fs->erase_lock);
+
+	k_work_submit(&fs->erase_work);
+#else
 	/* Erase the gc'ed sector */
 	rc = nvs_flash_erase_sector(fs, sec_addr);
 	if (rc) {
 		return rc;
 	}
+#endif
 	return 0;
 }
 
@@ -777,6 +965,10 @@ static int nvs_startup(struct nvs_fs *fs)
 		fs->ate_wra &= ADDR_SECT_MASK;
 		fs->ate_wra += (fs->sector_size - 2 * ate_size);
 		fs->data_wra = (fs->ate_wra & ADDR_SECT_MASK);
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+		/* Nothing cached yet, let gc walk all ate's */
+		(void)memset(fs->lookup_cache, 0xff, sizeof(fs->lookup_cache));
+#endif
 		rc = nvs_gc(fs);
 		goto end;
 	}
@@ -819,6 +1011,12 @@ end:
 
 		rc = nvs_add_gc_done_ate(fs);
 	}
+
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	if (!rc) {
+		rc = nvs_lookup_cache_rebuild(fs);
+	}
+#endif
 	k_mutex_unlock(&fs->nvs_lock);
 	return rc;
 }
@@ -833,6 +1031,13 @@ int nvs_clear(struct nvs_fs *fs)
 		return -EACCES;
 	}
 
+#ifdef CONFIG_NVS_BACKGROUND_ERASE
+	/* all sectors are erased here, a pending erase must not follow */
+	k_mutex_lock(&fs->erase_lock, K_FOREVER);
+	fs->erase_pending = false;
+	k_mutex_unlock(&fs->erase_lock);
+#endif
+
 	for (uint16_t i = 0; i < fs->sector_count; i++) {
 		addr = i << ADDR_SECT_SHIFT;
 		rc = nvs_flash_erase_sector(fs, addr);
@@ -856,6 +1061,14 @@ int nvs_init(struct nvs_fs *fs, const char *dev_name)
 
 	k_mutex_init(&fs->nvs_lock);
 
+#ifdef CONFIG_NVS_WRITE_LATENCY_STATS
+	if (!nvs_write_latency_registered) {
+		(void)STATS_INIT_AND_REG(nvs_write_latency, STATS_SIZE_32,
+					 "nvs_write_latency");
+		nvs_write_latency_registered = true;
+	}
+#endif
+
 	fs->flash_device = device_get_binding(dev_name);
 	if (!fs->flash_device) {
 		LOG_ERR("No valid flash device found");
@@ -893,6 +1106,23 @@ int nvs_init(struct nvs_fs *fs, const char *dev_name)
 		return -EINVAL;
 	}
 
+#ifdef CONFIG_NVS_BACKGROUND_ERASE
+	/* The work item may still be queued from an earlier mount, only
+	 * initialize it once and finish what it was to do.
+	 */
+	if (!fs->erase_init) {
+		k_mutex_init(&fs->erase_lock);
+		k_work_init(&fs->erase_work, nvs_erase_work_handler);
+		fs->erase_pending = false;
+		fs->erase_init = true;
+	} else {
+		rc = nvs_erase_pending_finish(fs);
+		if (rc) {
+			return rc;
+		}
+	}
+#endif
+
 	rc = nvs_startup(fs);
 	if (rc) {
 		return rc;
@@ -920,6 +1150,9 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 	uint32_t wlk_addr, rd_addr;
 	uint16_t required_space = 0U; /* no space, appropriate for delete ate */
 	bool prev_found = false;
+#ifdef CONFIG_NVS_WRITE_LATENCY_STATS
+	uint32_t start = k_cycle_get_32();
+#endif
 
 	if (!fs->ready) {
 		LOG_ERR("NVS not initialized");
@@ -939,7 +1172,15 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 	}
 
 	/* find latest entry with same id */
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	wlk_addr = fs->lookup_cache[nvs_lookup_cache_pos(id)];
+
+	if (wlk_addr == NVS_LOOKUP_CACHE_NO_ADDR) {
+		goto no_cached_entry;
+	}
+#else
 	wlk_addr = fs->ate_wra;
+#endif
 	rd_addr = wlk_addr;
 
 	while (1) {
@@ -957,6 +1198,9 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 		}
 	}
 
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+no_cached_entry:
+#endif
 	if (prev_found) {
 		/* previous entry found */
 		rd_addr &= ADDR_SECT_MASK;
@@ -1013,6 +1257,14 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 		}
 
 
+#ifdef CONFIG_NVS_BACKGROUND_ERASE
+		/* the sector close moves to the sector gc'ed last time */
+		rc = nvs_erase_pending_finish(fs);
+		if (rc) {
+			goto end;
+		}
+#endif
+
 		rc = nvs_sector_close(fs);
 		if (rc) {
 			goto end;
@@ -1027,6 +1279,9 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 	rc = len;
 end:
 	k_mutex_unlock(&fs->nvs_lock);
+#ifdef CONFIG_NVS_WRITE_LATENCY_STATS
+	nvs_write_latency_record(start);
+#endif
 	return rc;
 }
 
@@ -1057,7 +1312,16 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, uint16_t id, void *data, size_t len,
 
 	cnt_his = 0U;
 
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	wlk_addr = fs->lookup_cache[nvs_lookup_cache_pos(id)];
+
+	if (wlk_addr == NVS_LOOKUP_CACHE_NO_ADDR) {
+		rc = -ENOENT;
+		goto err;
+	}
+#else
 	wlk_addr = fs->ate_wra;
+#endif
 	rd_addr = wlk_addr;
 
 	while (cnt_his <= cnt) {
@@ -1100,6 +1364,74 @@ ssize_t nvs_read(struct nvs_fs *fs, uint16_t id, void *data, size_t len)
 	return rc;
 }
 
+int nvs_walk(struct nvs_fs *fs, nvs_walk_cb_t cb, void *param)
+{
+	int rc;
+	uint32_t wlk_addr, rd_addr;
+	struct nvs_ate wlk_ate;
+	struct nvs_walk_entry entry;
+
+	if (!fs->ready) {
+		LOG_ERR("NVS not initialized");
+		return -EACCES;
+	}
+
+	wlk_addr = fs->ate_wra;
+
+	while (1) {
+		rd_addr = wlk_addr;
+		rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
+		if (rc) {
+			return rc;
+		}
+
+		if ((wlk_ate.id != 0xFFFF) && nvs_ate_valid(fs, &wlk_ate)) {
+			entry.id = wlk_ate.id;
+			entry.len = wlk_ate.len;
+			entry.data_addr = (rd_addr & ADDR_SECT_MASK) +
+					  wlk_ate.offset;
+			entry.wra = fs->ate_wra;
+
+			rc = cb(fs, &entry, param);
+			if (rc) {
+				return rc;
+			}
+		}
+
+		if (wlk_addr == fs->ate_wra) {
+			break;
+		}
+	}
+
+	return 0;
+}
+
+ssize_t nvs_read_entry(struct nvs_fs *fs, const struct nvs_walk_entry *entry,
+		       void *data, size_t len)
+{
+	int rc;
+
+	if (!fs->ready) {
+		LOG_ERR("NVS not initialized");
+		return -EACCES;
+	}
+
+	/* A write may have moved the data (gc) */
+	if (entry->wra != fs->ate_wra) {
+		return -EAGAIN;
+	}
+
+	len = MIN(len, entry->len);
+	if (len) {
+		rc = nvs_flash_rd(fs, entry->data_addr, data, len);
+		if (rc) {
+			return rc;
+		}
+	}
+
+	return entry->len;
+}
+
 ssize_t nvs_calc_free_space(struct nvs_fs *fs)
 {
 
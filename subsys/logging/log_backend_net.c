@@ -10,6 +10,7 @@ LOG_MODULE_REGISTER(log_backend_net, CONFIG_LOG_DEFAULT_LEVEL);
 #include <logging/log_backend.h>
 #include <logging/log_core.h>
 #include <logging/log_output.h>
+#include <logging/log_output_dict.h>
 #include <logging/log_msg.h>
 #include <net/net_pkt.h>
 #include <net/net_context.h>
@@ -207,7 +208,22 @@ static void process(const struct log_backend *const backend,
 		net_init_done = true;
 	}
 
-	log_output_msg2_process(&log_output_net, &msg->log, flags);
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_NET_OUTPUT_DICTIONARY)) {
+		log_dict_output_msg2_process(&log_output_net, &msg->log, flags);
+	} else {
+		log_output_msg2_process(&log_output_net, &msg->log, flags);
+	}
+}
+
+static void dropped(const struct log_backend *const backend, uint32_t cnt)
+{
+	ARG_UNUSED(backend);
+
+	if (panic_mode || !net_init_done) {
+		return;
+	}
+
+	log_dict_output_dropped_process(&log_output_net, cnt);
 }
 
 static void init_net(struct log_backend const *const backend)
@@ -265,6 +281,9 @@ const struct log_backend_api log_backend_net_api = {
 	 * this can be revisited if needed.
 	 */
 	.put_sync_hexdump = NULL,
+	/* Syslog output does not report dropped messages */
+	.dropped = IS_ENABLED(CONFIG_LOG_BACKEND_NET_OUTPUT_DICTIONARY) ?
+							dropped : NULL,
 };
 
 /* Note that the backend can be activated only after we have networking
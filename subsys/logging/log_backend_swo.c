@@ -26,6 +26,7 @@
 #include <logging/log_core.h>
 #include <logging/log_msg.h>
 #include <logging/log_output.h>
+#include <logging/log_output_dict.h>
 #include <logging/log_backend_std.h>
 #include <soc.h>
 
@@ -87,7 +88,11 @@ static void log_backend_swo_process(const struct log_backend *const backend,
 {
 	uint32_t flags = log_backend_std_get_flags();
 
-	log_output_msg2_process(&log_output_swo, &msg->log, flags);
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_SWO_OUTPUT_DICTIONARY)) {
+		log_dict_output_msg2_process(&log_output_swo, &msg->log, flags);
+	} else {
+		log_output_msg2_process(&log_output_swo, &msg->log, flags);
+	}
 }
 
 static void log_backend_swo_init(struct log_backend const *const backend)
@@ -125,7 +130,11 @@ static void dropped(const struct log_backend *const backend, uint32_t cnt)
 {
 	ARG_UNUSED(backend);
 
-	log_backend_std_dropped(&log_output_swo, cnt);
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_SWO_OUTPUT_DICTIONARY)) {
+		log_dict_output_dropped_process(&log_output_swo, cnt);
+	} else {
+		log_backend_std_dropped(&log_output_swo, cnt);
+	}
 }
 
 static void log_backend_swo_sync_string(const struct log_backend *const backend,
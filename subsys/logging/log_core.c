@@ -94,22 +94,24 @@ static struct k_timer log_process_thread_timer;
 static log_timestamp_t dummy_timestamp(void);
 static log_timestamp_get_t timestamp_func = dummy_timestamp;
 
-struct mpsc_pbuf_buffer log_buffer;
+#ifdef CONFIG_LOG2_PER_CPU_BUFFERS
+#define LOG_BUFFERS CONFIG_MP_NUM_CPUS
+#else
+#define LOG_BUFFERS 1
+#endif
+
+static struct mpsc_pbuf_buffer log_buffers[LOG_BUFFERS];
 static uint32_t __aligned(Z_LOG_MSG2_ALIGNMENT)
-	buf32[CONFIG_LOG_BUFFER_SIZE / sizeof(int)];
+	buf32[LOG_BUFFERS][CONFIG_LOG_BUFFER_SIZE / sizeof(int)];
+
+#ifdef CONFIG_LOG2_PER_CPU_BUFFERS
+/* Oldest message claimed from each buffer and not processed yet. */
+static union log_msg2_generic *log_heads[LOG_BUFFERS];
+#endif
 
 static void notify_drop(const struct mpsc_pbuf_buffer *buffer,
 			const union mpsc_pbuf_generic *item);
 
-static const struct mpsc_pbuf_buffer_config mpsc_config = {
-	.buf = (uint32_t *)buf32,
-	.size = ARRAY_SIZE(buf32),
-	.notify_drop = notify_drop,
-	.get_wlen = log_msg2_generic_get_wlen,
-	.flags = IS_ENABLED(CONFIG_LOG_MODE_OVERFLOW) ?
-		MPSC_PBUF_MODE_OVERWRITE : 0
-};
-
 bool log_is_strdup(const void *buf);
 static void msg_process(union log_msgs msg, bool bypass);
 
@@ -1172,12 +1174,47 @@ void log_hexdump_from_user(struct log_msg_ids src_level, const char *metadata,
 
 void z_log_msg2_init(void)
 {
-	mpsc_pbuf_init(&log_buffer, &mpsc_config);
+	struct mpsc_pbuf_buffer_config mpsc_config = {
+		.size = ARRAY_SIZE(buf32[0]),
+		.notify_drop = notify_drop,
+		.get_wlen = log_msg2_generic_get_wlen,
+		.flags = IS_ENABLED(CONFIG_LOG_MODE_OVERFLOW) ?
+			MPSC_PBUF_MODE_OVERWRITE : 0
+	};
+
+	for (int i = 0; i < LOG_BUFFERS; i++) {
+		mpsc_config.buf = buf32[i];
+		mpsc_pbuf_init(&log_buffers[i], &mpsc_config);
+#ifdef CONFIG_LOG2_PER_CPU_BUFFERS
+		log_heads[i] = NULL;
+#endif
+	}
+}
+
+/* Buffer a message was allocated from. A thread may have migrated to
+ * another CPU since it allocated the message.
+ */
+static struct mpsc_pbuf_buffer *msg_buffer(const void *msg)
+{
+	for (int i = 1; i < LOG_BUFFERS; i++) {
+		if ((const uint32_t *)msg < buf32[i]) {
+			return &log_buffers[i - 1];
+		}
+	}
+
+	return &log_buffers[LOG_BUFFERS - 1];
 }
 
 struct log_msg2 *z_log_msg2_alloc(uint32_t wlen)
 {
-	return (struct log_msg2 *)mpsc_pbuf_alloc(&log_buffer, wlen,
+	struct mpsc_pbuf_buffer *buffer = &log_buffers[0];
+
+#ifdef CONFIG_LOG2_PER_CPU_BUFFERS
+	/* Migrating right after reading the id only costs contention */
+	buffer = &log_buffers[arch_curr_cpu()->id];
+#endif
+
+	return (struct log_msg2 *)mpsc_pbuf_alloc(buffer, wlen,
 				K_MSEC(CONFIG_LOG_BLOCK_IN_THREAD_TIMEOUT_MS));
 }
 
@@ -1195,27 +1232,87 @@ void z_log_msg2_commit(struct log_msg2 *msg)
 		return;
 	}
 
-	mpsc_pbuf_commit(&log_buffer, (union mpsc_pbuf_generic *)msg);
+	mpsc_pbuf_commit(msg_buffer(msg), (union mpsc_pbuf_generic *)msg);
 
 	if (IS_ENABLED(CONFIG_LOG2_MODE_DEFERRED)) {
 		z_log_msg_post_finalize();
 	}
 }
 
+#ifdef CONFIG_LOG2_PER_CPU_BUFFERS
+static log_timestamp_t msg_timestamp(union log_msg2_generic *msg)
+{
+	return z_log_item_is_msg(msg) ? log_msg2_get_timestamp(&msg->log) : 0;
+}
+
+/* Whether timestamp a is before b, allowing for one wrap around. */
+static bool timestamp_before(log_timestamp_t a, log_timestamp_t b)
+{
+	return (log_timestamp_t)(a - b) > ((log_timestamp_t)-1 >> 1);
+}
+
+/* Claim the oldest of the messages at the head of the CPU buffers. Each
+ * buffer head is claimed once and kept until it is the oldest.
+ */
+static union log_msg2_generic *claim_oldest(void)
+{
+	union log_msg2_generic *msg;
+	int oldest = -1;
+
+	for (int i = 0; i < LOG_BUFFERS; i++) {
+		if (log_heads[i] == NULL) {
+			log_heads[i] = (union log_msg2_generic *)
+				mpsc_pbuf_claim(&log_buffers[i]);
+		}
+
+		if (log_heads[i] != NULL &&
+		    (oldest < 0 ||
+		     timestamp_before(msg_timestamp(log_heads[i]),
+				      msg_timestamp(log_heads[oldest])))) {
+			oldest = i;
+		}
+	}
+
+	if (oldest < 0) {
+		return NULL;
+	}
+
+	msg = log_heads[oldest];
+	log_heads[oldest] = NULL;
+
+	return msg;
+}
+#endif /* CONFIG_LOG2_PER_CPU_BUFFERS */
+
 union log_msg2_generic *z_log_msg2_claim(void)
 {
-	return (union log_msg2_generic *)mpsc_pbuf_claim(&log_buffer);
+#ifdef CONFIG_LOG2_PER_CPU_BUFFERS
+	return claim_oldest();
+#else
+	return (union log_msg2_generic *)mpsc_pbuf_claim(&log_buffers[0]);
+#endif
 }
 
 void z_log_msg2_free(union log_msg2_generic *msg)
 {
-	mpsc_pbuf_free(&log_buffer, (union mpsc_pbuf_generic *)msg);
+	mpsc_pbuf_free(msg_buffer(msg), (union mpsc_pbuf_generic *)msg);
 }
 
 
 bool z_log_msg2_pending(void)
 {
-	return mpsc_pbuf_is_pending(&log_buffer);
+	for (int i = 0; i < LOG_BUFFERS; i++) {
+#ifdef CONFIG_LOG2_PER_CPU_BUFFERS
+		if (log_heads[i] != NULL) {
+			return true;
+		}
+#endif
+		if (mpsc_pbuf_is_pending(&log_buffers[i])) {
+			return true;
+		}
+	}
+
+	return false;
 }
 
 static void log_process_thread_timer_expiry_fn(struct k_timer *timer)
@@ -11,17 +11,65 @@
 #include <logging/log_output_dict.h>
 #include <sys/__assert.h>
 #include <sys/util.h>
+#include <sys/crc.h>
+#include <string.h>
 
-static void buffer_write(log_output_func_t outf, uint8_t *buf, size_t len,
-			 void *ctx)
+/* Messages are written through the output buffer, so that a message
+ * goes out with a single call of the output function when it fits in
+ * the buffer, e.g. as a single datagram.
+ */
+static void buffer_write(const struct log_output *output, const void *data,
+			 size_t len)
 {
-	int processed;
+	const uint8_t *src = data;
+
+	while (len > 0) {
+		size_t chunk;
+
+		if (output->control_block->offset == output->size) {
+			log_output_flush(output);
+		}
 
-	do {
-		processed = outf(buf, len, ctx);
-		len -= processed;
-		buf += processed;
-	} while (len != 0);
+		chunk = MIN(len, output->size - output->control_block->offset);
+		memcpy(&output->buf[output->control_block->offset], src, chunk);
+		output->control_block->offset += chunk;
+		src += chunk;
+		len -= chunk;
+	}
+}
+
+static void frame_start(const struct log_output *output, size_t len,
+			 uint8_t *crc)
+{
+	if (IS_ENABLED(CONFIG_LOG_DICTIONARY_FRAMING)) {
+		struct log_dict_output_frame_hdr_t hdr = {
+			.sync = { LOG_DICT_OUTPUT_FRAME_SYNC0,
+				  LOG_DICT_OUTPUT_FRAME_SYNC1 },
+			.len = len,
+		};
+
+		buffer_write(output, &hdr, sizeof(hdr));
+		*crc = CRC8_CCITT_INITIAL_VALUE;
+	}
+}
+
+static void frame_write(const struct log_output *output, const void *data,
+			size_t len, uint8_t *crc)
+{
+	if (IS_ENABLED(CONFIG_LOG_DICTIONARY_FRAMING)) {
+		*crc = crc8_ccitt(*crc, data, len);
+	}
+
+	buffer_write(output, data, len);
+}
+
+static void frame_end(const struct log_output *output, uint8_t crc)
+{
+	if (IS_ENABLED(CONFIG_LOG_DICTIONARY_FRAMING)) {
+		buffer_write(output, &crc, sizeof(crc));
+	}
+
+	log_output_flush(output);
 }
 
 void log_dict_output_msg2_process(const struct log_output *output,
@@ -29,6 +77,10 @@ void log_dict_output_msg2_process(const struct log_output *output,
 {
 	struct log_dict_output_normal_msg_hdr_t output_hdr;
 	void *source = (void *)log_msg2_get_source(msg);
+	size_t pkg_len, data_len;
+	uint8_t *package = log_msg2_get_package(msg, &pkg_len);
+	uint8_t *data = log_msg2_get_data(msg, &data_len);
+	uint8_t crc = 0;
 
 	/* Keep sync with header in struct log_msg2 */
 	output_hdr.type = MSG_NORMAL;
@@ -44,31 +96,30 @@ void log_dict_output_msg2_process(const struct log_output *output,
 					log_const_source_id(source)) :
 				0U;
 
-	buffer_write(output->func, (uint8_t *)&output_hdr, sizeof(output_hdr),
-		     (void *)output);
+	frame_start(output, sizeof(output_hdr) + pkg_len + data_len, &crc);
 
-	size_t len;
-	uint8_t *data = log_msg2_get_package(msg, &len);
+	frame_write(output, &output_hdr, sizeof(output_hdr), &crc);
 
-	if (len > 0U) {
-		buffer_write(output->func, data, len, (void *)output);
+	if (pkg_len > 0U) {
+		frame_write(output, package, pkg_len, &crc);
 	}
 
-	data = log_msg2_get_data(msg, &len);
-	if (len > 0U) {
-		buffer_write(output->func, data, len, (void *)output);
+	if (data_len > 0U) {
+		frame_write(output, data, data_len, &crc);
 	}
 
-	log_output_flush(output);
+	frame_end(output, crc);
 }
 
 void log_dict_output_dropped_process(const struct log_output *output, uint32_t cnt)
 {
 	struct log_dict_output_dropped_msg_t msg;
+	uint8_t crc = 0;
 
 	msg.type = MSG_DROPPED_MSG;
 	msg.num_dropped_messages = MIN(cnt, 9999);
 
-	buffer_write(output->func, (uint8_t *)&msg, sizeof(msg),
-		     (void *)output);
+	frame_start(output, sizeof(msg), &crc);
+	frame_write(output, &msg, sizeof(msg), &crc);
+	frame_end(output, crc);
 }
@@ -59,6 +59,27 @@ static struct net_conn conns[CONFIG_NET_MAX_CONN];
 static sys_slist_t conn_unused;
 static sys_slist_t conn_used;
 
+#if defined(CONFIG_NET_UDP) || defined(CONFIG_NET_TCP)
+#define CONN_HASH_SIZE CONFIG_NET_CONN_HASH_SIZE
+#else
+#define CONN_HASH_SIZE 1
+#endif
+
+/* Handlers of UDP/TCP bound to a local port are kept in the bucket for
+ * their protocol and local port, all others in conn_wildcard.  Both are
+ * sorted like conn_used, newest first, so that walking a bucket merged
+ * with the wildcard list visits the candidates in conn_used order.
+ */
+static sys_slist_t conn_hash[CONN_HASH_SIZE];
+static sys_slist_t conn_wildcard;
+static uint32_t conn_seq;
+
+struct conn_iter {
+	sys_snode_t *bucket;
+	sys_snode_t *wildcard;
+	sys_snode_t *all;
+};
+
 #if (CONFIG_NET_CONN_LOG_LEVEL >= LOG_LEVEL_DBG)
 static inline
 void conn_register_debug(struct net_conn *conn,
@@ -127,11 +148,99 @@ static struct net_conn *conn_get_unused(void)
 	return CONTAINER_OF(node, struct net_conn, node);
 }
 
+static inline bool conn_is_hashable(uint16_t proto, uint8_t family,
+				    uint16_t local_port)
+{
+	return local_port != 0U &&
+		(family == AF_INET || family == AF_INET6) &&
+		((IS_ENABLED(CONFIG_NET_UDP) && proto == IPPROTO_UDP) ||
+		 (IS_ENABLED(CONFIG_NET_TCP) && proto == IPPROTO_TCP));
+}
+
+/* local_port is in network byte order */
+static sys_slist_t *conn_bucket(uint16_t proto, uint16_t local_port)
+{
+	uint32_t hash = ((uint32_t)proto << 16) | local_port;
+
+	hash *= 0x9e3779b1U;
+
+	return &conn_hash[(hash ^ (hash >> 16)) % CONN_HASH_SIZE];
+}
+
+static sys_slist_t *conn_index_list(struct net_conn *conn)
+{
+	uint16_t local_port = net_sin(&conn->local_addr)->sin_port;
+
+	if (conn_is_hashable(conn->proto, conn->family, local_port)) {
+		return conn_bucket(conn->proto, local_port);
+	}
+
+	return &conn_wildcard;
+}
+
+static struct net_conn *conn_iter_next(struct conn_iter *it)
+{
+	sys_snode_t **next;
+	struct net_conn *a, *b;
+
+	if (it->all != NULL) {
+		a = CONTAINER_OF(it->all, struct net_conn, node);
+		it->all = sys_slist_peek_next(it->all);
+
+		return a;
+	}
+
+	if (it->bucket == NULL && it->wildcard == NULL) {
+		return NULL;
+	}
+
+	a = it->bucket ?
+		CONTAINER_OF(it->bucket, struct net_conn, hash_node) : NULL;
+	b = it->wildcard ?
+		CONTAINER_OF(it->wildcard, struct net_conn, hash_node) : NULL;
+
+	/* Newest (highest seq) first, wrap-around safe */
+	if (a != NULL && (b == NULL || (int32_t)(a->seq - b->seq) > 0)) {
+		next = &it->bucket;
+	} else {
+		a = b;
+		next = &it->wildcard;
+	}
+
+	*next = sys_slist_peek_next(*next);
+
+	return a;
+}
+
+/* Iterate handlers that may match proto and local_port (network byte
+ * order), in registration order newest first.  Lookups that cannot use
+ * the index (raw packet and CAN sockets, no port) walk every handler.
+ */
+static struct net_conn *conn_iter_start(struct conn_iter *it,
+					uint16_t proto, uint8_t family,
+					uint16_t local_port)
+{
+	if (conn_is_hashable(proto, family, local_port)) {
+		it->bucket = sys_slist_peek_head(conn_bucket(proto,
+							     local_port));
+		it->wildcard = sys_slist_peek_head(&conn_wildcard);
+		it->all = NULL;
+	} else {
+		it->bucket = NULL;
+		it->wildcard = NULL;
+		it->all = sys_slist_peek_head(&conn_used);
+	}
+
+	return conn_iter_next(it);
+}
+
 static void conn_set_used(struct net_conn *conn)
 {
 	conn->flags |= NET_CONN_IN_USE;
+	conn->seq = ++conn_seq;
 
 	sys_slist_prepend(&conn_used, &conn->node);
+	sys_slist_prepend(conn_index_list(conn), &conn->hash_node);
 }
 
 static void conn_set_unused(struct net_conn *conn)
@@ -149,9 +258,10 @@ static struct net_conn *conn_find_handler(uint16_t proto, uint8_t family,
 					  uint16_t local_port)
 {
 	struct net_conn *conn;
-	struct net_conn *tmp;
+	struct conn_iter it;
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&conn_used, conn, tmp, node) {
+	for (conn = conn_iter_start(&it, proto, family, htons(local_port));
+	     conn != NULL; conn = conn_iter_next(&it)) {
 		if (conn->proto != proto) {
 			continue;
 		}
@@ -380,6 +490,7 @@ int net_conn_unregister(struct net_conn_handle *handle)
 	NET_DBG("Connection handler %p removed", conn);
 
 	sys_slist_find_and_remove(&conn_used, &conn->node);
+	sys_slist_find_and_remove(conn_index_list(conn), &conn->hash_node);
 
 	conn_set_unused(conn);
 
@@ -563,6 +674,7 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 	bool raw_pkt_continue = false;
 	int16_t best_rank = -1;
 	struct net_conn *conn;
+	struct conn_iter it;
 	enum net_verdict ret;
 	uint16_t src_port;
 	uint16_t dst_port;
@@ -602,6 +714,11 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 		return NET_DROP;
 	}
 
+	if (IS_ENABLED(CONFIG_NET_TCP_GRO) && proto == IPPROTO_TCP &&
+	    net_tcp_gro_receive(pkt, ip_hdr, proto_hdr)) {
+		return NET_OK;
+	}
+
 	/* TODO: Make core part of networing subsystem less dependent on
 	 * UDP, TCP, IPv4 or IPv6. So that we can add new features with
 	 * less cross-module changes.
@@ -627,7 +744,8 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 		}
 	}
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&conn_used, conn, node) {
+	for (conn = conn_iter_start(&it, proto, net_pkt_family(pkt), dst_port);
+	     conn != NULL; conn = conn_iter_next(&it)) {
 		if (conn->context != NULL &&
 		    net_context_is_bound_to_iface(conn->context) &&
 		    net_pkt_iface(pkt) != net_context_get_iface(conn->context)) {
@@ -859,6 +977,11 @@ void net_conn_init(void)
 
 	sys_slist_init(&conn_unused);
 	sys_slist_init(&conn_used);
+	sys_slist_init(&conn_wildcard);
+
+	for (i = 0; i < CONN_HASH_SIZE; i++) {
+		sys_slist_init(&conn_hash[i]);
+	}
 
 	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
 		sys_slist_prepend(&conn_unused, &conns[i].node);
@@ -51,6 +51,12 @@ struct net_conn {
 	/** Internal slist node */
 	sys_snode_t node;
 
+	/** Lookup hash bucket (or wildcard list) slist node */
+	sys_snode_t hash_node;
+
+	/** Registration order, newest is highest */
+	uint32_t seq;
+
 	/** Remote IP address */
 	struct sockaddr remote_addr;
 
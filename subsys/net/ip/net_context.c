@@ -410,6 +410,7 @@ int net_context_put(struct net_context *context)
 	context->connect_cb = NULL;
 	context->recv_cb = NULL;
 	context->send_cb = NULL;
+	context->writable_cb = NULL;
 
 	/* Decrement refcount on user app's behalf */
 	net_context_unref(context);
@@ -1277,10 +1278,22 @@ static int context_write_data(struct net_pkt *pkt, const void *buf,
 	return ret;
 }
 
+/* Attach caller supplied fragments to the packet instead of copying
+ * them. Unused header space is dropped first so that the data follows
+ * directly after the headers written so far. An extra reference is
+ * taken so that the caller still owns the fragments if sending fails.
+ */
+static void context_attach_frags(struct net_pkt *pkt, struct net_buf *frags)
+{
+	net_pkt_trim_buffer(pkt);
+	net_pkt_append_buffer(pkt, net_buf_ref(frags));
+}
+
 static int context_setup_udp_packet(struct net_context *context,
 				    struct net_pkt *pkt,
 				    const void *buf,
 				    size_t len,
+				    struct net_buf *frags,
 				    const struct msghdr *msg,
 				    const struct sockaddr *dst_addr,
 				    socklen_t addrlen)
@@ -1323,6 +1336,11 @@ static int context_setup_udp_packet(struct net_context *context,
 		return ret;
 	}
 
+	if (frags) {
+		context_attach_frags(pkt, frags);
+		return 0;
+	}
+
 	ret = context_write_data(pkt, buf, len, msg);
 	if (ret) {
 		return ret;
@@ -1406,6 +1424,7 @@ static void set_pkt_txtime(struct net_pkt *pkt, const struct msghdr *msghdr)
 static int context_sendto(struct net_context *context,
 			  const void *buf,
 			  size_t len,
+			  struct net_buf *frags,
 			  const struct sockaddr *dst_addr,
 			  socklen_t addrlen,
 			  net_context_send_cb_t cb,
@@ -1621,15 +1640,38 @@ static int context_sendto(struct net_context *context,
 		return -ENETDOWN;
 	}
 
-	pkt = context_alloc_pkt(context, len, PKT_WAIT_TIME);
+	if (frags) {
+		if ((IS_ENABLED(CONFIG_NET_OFFLOAD) &&
+		     net_if_is_ip_offloaded(iface)) ||
+		    (net_context_get_family(context) != AF_INET &&
+		     net_context_get_family(context) != AF_INET6)) {
+			return -EOPNOTSUPP;
+		}
+
+		if (IS_ENABLED(CONFIG_NET_UDP) &&
+		    net_context_get_ip_proto(context) == IPPROTO_UDP &&
+		    iface) {
+			tmp_len = net_if_get_mtu(iface) -
+				(net_context_get_family(context) == AF_INET6 ?
+				 NET_IPV6UDPH_LEN : NET_IPV4UDPH_LEN);
+			if (len > tmp_len) {
+				return -EMSGSIZE;
+			}
+		}
+	}
+
+	/* Only the header space is needed when sending fragments */
+	pkt = context_alloc_pkt(context, frags ? 0 : len, PKT_WAIT_TIME);
 	if (!pkt) {
 		return -ENOBUFS;
 	}
 
-	tmp_len = net_pkt_available_payload_buffer(
+	if (!frags) {
+		tmp_len = net_pkt_available_payload_buffer(
 				pkt, net_context_get_ip_proto(context));
-	if (tmp_len < len) {
-		len = tmp_len;
+		if (tmp_len < len) {
+			len = tmp_len;
+		}
 	}
 
 	context->send_cb = cb;
@@ -1675,8 +1717,8 @@ static int context_sendto(struct net_context *context,
 		}
 	} else if (IS_ENABLED(CONFIG_NET_UDP) &&
 	    net_context_get_ip_proto(context) == IPPROTO_UDP) {
-		ret = context_setup_udp_packet(context, pkt, buf, len, msghdr,
-					       dst_addr, addrlen);
+		ret = context_setup_udp_packet(context, pkt, buf, len, frags,
+					       msghdr, dst_addr, addrlen);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1687,9 +1729,13 @@ static int context_sendto(struct net_context *context,
 	} else if (IS_ENABLED(CONFIG_NET_TCP) &&
 		   net_context_get_ip_proto(context) == IPPROTO_TCP) {
 
-		ret = context_write_data(pkt, buf, len, msghdr);
-		if (ret < 0) {
-			goto fail;
+		if (frags) {
+			context_attach_frags(pkt, frags);
+		} else {
+			ret = context_write_data(pkt, buf, len, msghdr);
+			if (ret < 0) {
+				goto fail;
+			}
 		}
 
 		net_pkt_cursor_init(pkt);
@@ -1735,6 +1781,11 @@ static int context_sendto(struct net_context *context,
 		goto fail;
 	}
 
+	if (frags) {
+		/* The packet holds its own reference now */
+		net_buf_unref(frags);
+	}
+
 	return len;
 fail:
 	net_pkt_unref(pkt);
@@ -1777,7 +1828,7 @@ int net_context_send(struct net_context *context,
 		addrlen = 0;
 	}
 
-	ret = context_sendto(context, buf, len, &context->remote,
+	ret = context_sendto(context, buf, len, NULL, &context->remote,
 			     addrlen, cb, timeout, user_data, false);
 unlock:
 	k_mutex_unlock(&context->lock);
@@ -1796,7 +1847,7 @@ int net_context_sendmsg(struct net_context *context,
 
 	k_mutex_lock(&context->lock, K_FOREVER);
 
-	ret = context_sendto(context, msghdr, 0, NULL, 0,
+	ret = context_sendto(context, msghdr, 0, NULL, NULL, 0,
 			     cb, timeout, user_data, true);
 
 	k_mutex_unlock(&context->lock);
@@ -1817,7 +1868,7 @@ int net_context_sendto(struct net_context *context,
 
 	k_mutex_lock(&context->lock, K_FOREVER);
 
-	ret = context_sendto(context, buf, len, dst_addr, addrlen,
+	ret = context_sendto(context, buf, len, NULL, dst_addr, addrlen,
 			     cb, timeout, user_data, true);
 
 	k_mutex_unlock(&context->lock);
@@ -1825,6 +1876,49 @@ int net_context_sendto(struct net_context *context,
 	return ret;
 }
 
+int net_context_send_buf(struct net_context *context,
+			 struct net_buf *frags,
+			 const struct sockaddr *dst_addr,
+			 socklen_t addrlen,
+			 net_context_send_cb_t cb,
+			 k_timeout_t timeout,
+			 void *user_data)
+{
+	size_t len;
+	int ret;
+
+	if (!frags) {
+		return -EINVAL;
+	}
+
+	len = net_buf_frags_len(frags);
+	if (len == 0) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&context->lock, K_FOREVER);
+
+	if (!dst_addr) {
+		if (!(context->flags & NET_CONTEXT_REMOTE_ADDR_SET) ||
+		    !net_sin(&context->remote)->sin_port) {
+			ret = -EDESTADDRREQ;
+			goto unlock;
+		}
+
+		dst_addr = &context->remote;
+		addrlen = net_context_get_family(context) == AF_INET6 ?
+			sizeof(struct sockaddr_in6) :
+			sizeof(struct sockaddr_in);
+	}
+
+	ret = context_sendto(context, NULL, len, frags, dst_addr, addrlen,
+			     cb, timeout, user_data, true);
+unlock:
+	k_mutex_unlock(&context->lock);
+
+	return ret;
+}
+
 enum net_verdict net_context_packet_received(struct net_conn *conn,
 					     struct net_pkt *pkt,
 					     union net_ip_header *ip_hdr,
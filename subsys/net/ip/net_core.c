@@ -359,12 +359,9 @@ static void net_rx(struct net_if *iface, struct net_pkt *pkt)
 	}
 
 	processing_data(pkt, is_loopback);
-
-	net_print_statistics();
-	net_pkt_print();
 }
 
-void net_process_rx_packet(struct net_pkt *pkt)
+static void net_rx_one(struct net_pkt *pkt)
 {
 	net_pkt_set_rx_stats_tick(pkt, k_cycle_get_32());
 
@@ -373,7 +370,37 @@ void net_process_rx_packet(struct net_pkt *pkt)
 	net_rx(net_pkt_iface(pkt), pkt);
 }
 
-static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
+void net_process_rx_packet(struct net_pkt *pkt)
+{
+	net_rx_one(pkt);
+
+	net_print_statistics();
+	net_pkt_print();
+}
+
+void net_process_rx_burst(struct net_pkt **pkts, int count)
+{
+	bool gro = IS_ENABLED(CONFIG_NET_TCP_GRO) && count > 1;
+	int i;
+
+	if (gro) {
+		net_tcp_gro_begin();
+	}
+
+	for (i = 0; i < count; i++) {
+		net_rx_one(pkts[i]);
+	}
+
+	if (gro) {
+		net_tcp_gro_end();
+	}
+
+	net_print_statistics();
+	net_pkt_print();
+}
+
+/* Returns the RX traffic class of the packet and updates its statistics */
+static uint8_t net_rx_classify(struct net_if *iface, struct net_pkt *pkt)
 {
 	uint8_t prio = net_pkt_priority(pkt);
 	uint8_t tc = net_rx_priority2tc(prio);
@@ -388,6 +415,13 @@ static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
 	NET_DBG("TC %d with prio %d pkt %p", tc, prio, pkt);
 #endif
 
+	return tc;
+}
+
+static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
+{
+	uint8_t tc = net_rx_classify(iface, pkt);
+
 	if (NET_TC_RX_COUNT == 0) {
 		net_process_rx_packet(pkt);
 	} else {
@@ -395,8 +429,7 @@ static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
 	}
 }
 
-/* Called by driver when an IP packet has been received */
-int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
+static int net_recv_check(struct net_if *iface, struct net_pkt *pkt)
 {
 	if (!pkt || !iface) {
 		return -EINVAL;
@@ -410,6 +443,11 @@ int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
 		return -ENETDOWN;
 	}
 
+	return 0;
+}
+
+static void net_recv_prepare(struct net_if *iface, struct net_pkt *pkt)
+{
 	net_pkt_set_overwrite(pkt, true);
 	net_pkt_cursor_init(pkt);
 
@@ -421,12 +459,87 @@ int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
 	}
 
 	net_pkt_set_iface(pkt, iface);
+}
+
+/* Called by driver when an IP packet has been received */
+int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
+{
+	int ret;
+
+	ret = net_recv_check(iface, pkt);
+	if (ret < 0) {
+		return ret;
+	}
+
+	net_recv_prepare(iface, pkt);
 
 	net_queue_rx(iface, pkt);
 
 	return 0;
 }
 
+/* Called by driver when a burst of IP packets has been received */
+int net_recv_data_batch(struct net_if *iface, struct net_pkt **pkts,
+			size_t count)
+{
+#if NET_TC_RX_COUNT > 0
+	struct net_pkt *heads[NET_TC_RX_COUNT] = { NULL };
+	struct net_pkt *tails[NET_TC_RX_COUNT] = { NULL };
+#endif
+	size_t i;
+	int ret;
+
+	if (!pkts) {
+		return -EINVAL;
+	}
+
+	/* All or nothing, so that the caller knows what to free */
+	for (i = 0; i < count; i++) {
+		ret = net_recv_check(iface, pkts[i]);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	for (i = 0; i < count; i++) {
+		struct net_pkt *pkt = pkts[i];
+		uint8_t tc;
+
+		net_recv_prepare(iface, pkt);
+
+		tc = net_rx_classify(iface, pkt);
+
+#if NET_TC_RX_COUNT > 0
+		/* Chain the packets of each traffic class through their
+		 * fifo word, as expected by k_fifo_put_list().
+		 */
+		pkt->fifo = 0;
+
+		if (heads[tc] == NULL) {
+			heads[tc] = pkt;
+		} else {
+			tails[tc]->fifo = (intptr_t)pkt;
+		}
+
+		tails[tc] = pkt;
+#else
+		ARG_UNUSED(tc);
+
+		net_process_rx_packet(pkt);
+#endif
+	}
+
+#if NET_TC_RX_COUNT > 0
+	for (i = 0; i < NET_TC_RX_COUNT; i++) {
+		if (heads[i] != NULL) {
+			net_tc_submit_list_to_rx_queue(i, heads[i], tails[i]);
+		}
+	}
+#endif
+
+	return 0;
+}
+
 static inline void l3_init(void)
 {
 	net_icmpv4_init();
@@ -1480,6 +1480,25 @@ static void tcp_cb(struct tcp *conn, void *user_data)
 	(*count)++;
 }
 
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+static void tcp_cc_cb(struct tcp *conn, void *user_data)
+{
+	struct net_shell_user_data *data = user_data;
+	const struct shell *shell = data->shell;
+	struct tcp_cc_info info;
+
+	if (net_tcp_get_state(conn) == TCP_LISTEN ||
+	    net_tcp_get_cc_info(conn, &info) < 0) {
+		return;
+	}
+
+	PR("%p %-8s %7u %10u %6u %6u %6u %6u%s\n",
+	   conn, info.algo, info.cwnd, info.ssthresh, info.srtt,
+	   info.rttvar, info.rto, info.fast_rexmits,
+	   info.in_recovery ? "  recovery" : "");
+}
+#endif /* CONFIG_NET_TCP_CONGESTION_CONTROL */
+
 #if CONFIG_NET_TCP_LOG_LEVEL >= LOG_LEVEL_DBG
 static void tcp_sent_list_cb(struct tcp *conn, void *user_data)
 {
@@ -2038,6 +2057,12 @@ static int cmd_net_conn(const struct shell *shell, size_t argc, char *argv[])
 	if (count == 0) {
 		PR("No TCP connections\n");
 	} else {
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+		PR("\nTCP        Algo        Cwnd   Ssthresh   SRTT RTTvar    "
+		   "RTO Rexmit\n");
+
+		net_tcp_foreach(tcp_cc_cb, &user_data);
+#endif
 #if CONFIG_NET_TCP_LOG_LEVEL >= LOG_LEVEL_DBG
 		/* Print information about pending packets */
 		struct tcp2_detail_info details;
@@ -72,6 +72,24 @@ void net_tc_submit_to_rx_queue(uint8_t tc, struct net_pkt *pkt)
 #endif
 }
 
+void net_tc_submit_list_to_rx_queue(uint8_t tc, struct net_pkt *head,
+				    struct net_pkt *tail)
+{
+#if NET_TC_RX_COUNT > 0
+	struct net_pkt *pkt;
+
+	for (pkt = head; pkt != NULL; pkt = (struct net_pkt *)pkt->fifo) {
+		net_pkt_set_rx_stats_tick(pkt, k_cycle_get_32());
+	}
+
+	k_fifo_put_list(&rx_classes[tc].fifo, head, tail);
+#else
+	ARG_UNUSED(tc);
+	ARG_UNUSED(head);
+	ARG_UNUSED(tail);
+#endif
+}
+
 int net_tx_priority2tc(enum net_priority prio)
 {
 #if NET_TC_TX_COUNT > 0
@@ -239,15 +257,26 @@ static void net_tc_rx_stats_priority_setup(struct net_if *iface,
 #if NET_TC_RX_COUNT > 0
 static void tc_rx_handler(struct k_fifo *fifo)
 {
+	struct net_pkt *burst[CONFIG_NET_TC_RX_BURST];
 	struct net_pkt *pkt;
+	int count;
 
 	while (1) {
-		pkt = k_fifo_get(fifo, K_FOREVER);
-		if (pkt == NULL) {
-			continue;
-		}
+		/* Take everything queued in one go, so that a burst from
+		 * the driver costs one queue operation and one wakeup.
+		 */
+		pkt = k_fifo_get_list(fifo, K_FOREVER);
+
+		while (pkt != NULL) {
+			count = 0;
 
-		net_process_rx_packet(pkt);
+			while (pkt != NULL && count < CONFIG_NET_TC_RX_BURST) {
+				burst[count++] = pkt;
+				pkt = (struct net_pkt *)pkt->fifo;
+			}
+
+			net_process_rx_burst(burst, count);
+		}
 	}
 }
 #endif
@@ -16,6 +16,7 @@ LOG_MODULE_REGISTER(net_route, CONFIG_NET_ROUTE_LOG_LEVEL);
 #include <limits.h>
 #include <zephyr/types.h>
 #include <sys/slist.h>
+#include <sys/dlist.h>
 
 #include <net/net_pkt.h>
 #include <net/net_core.h>
@@ -36,7 +37,7 @@ LOG_MODULE_REGISTER(net_route, CONFIG_NET_ROUTE_LOG_LEVEL);
 /* We keep track of the routes in a separate list so that we can remove
  * the oldest routes (at tail) if needed.
  */
-static sys_slist_t routes;
+static sys_dlist_t routes = SYS_DLIST_STATIC_INIT(&routes);
 
 static void net_route_nexthop_remove(struct net_nbr *nbr)
 {
@@ -253,13 +254,294 @@ static int nbr_nexthop_put(struct net_nbr *nbr)
 /* Route was accessed, so place it in front of the routes list */
 static inline void update_route_access(struct net_route_entry *route)
 {
-	sys_slist_find_and_remove(&routes, &route->node);
-	sys_slist_prepend(&routes, &route->node);
+	if (sys_dnode_is_linked(&route->node)) {
+		sys_dlist_remove(&route->node);
+	}
+
+	sys_dlist_prepend(&routes, &route->node);
 }
 
-struct net_route_entry *net_route_lookup(struct net_if *iface,
-					 struct in6_addr *dst)
+#if defined(CONFIG_NET_ROUTE_LPM)
+/* Longest prefix match index. The routes are kept in a path compressed
+ * binary trie (Patricia trie) keyed by their prefix. A node either holds
+ * the routes having exactly its prefix, or is a branch point with two
+ * children, so a trie of N distinct prefixes has at most 2N - 1 nodes
+ * and a lookup visits at most one node per distinct prefix length on
+ * the path to the destination instead of every route in the table.
+ */
+struct route_lpm_node {
+	struct route_lpm_node *child[2];
+
+	/* Routes (on different interfaces) having this prefix */
+	sys_slist_t routes;
+
+	struct in6_addr prefix;
+	uint8_t len;
+};
+
+static struct route_lpm_node lpm_nodes[2 * CONFIG_NET_MAX_ROUTES];
+static struct route_lpm_node *lpm_free;
+static struct route_lpm_node *lpm_root;
+
+static inline int lpm_bit(const struct in6_addr *addr, uint8_t pos)
+{
+	return (addr->s6_addr[pos / 8U] >> (7 - pos % 8U)) & 1;
+}
+
+/* Number of leading bits, up to max, that the addresses have in common */
+static uint8_t lpm_common_len(const struct in6_addr *a,
+			      const struct in6_addr *b, uint8_t max)
+{
+	uint8_t len = 0U;
+	int i;
+
+	for (i = 0; i < sizeof(a->s6_addr) && len < max; i++) {
+		uint8_t diff = a->s6_addr[i] ^ b->s6_addr[i];
+
+		if (diff) {
+			len += __builtin_clz(diff) - 24;
+			break;
+		}
+
+		len += 8U;
+	}
+
+	return MIN(len, max);
+}
+
+static struct route_lpm_node *lpm_node_alloc(const struct in6_addr *prefix,
+					     uint8_t len)
+{
+	struct route_lpm_node *node = lpm_free;
+
+	if (!node) {
+		return NULL;
+	}
+
+	lpm_free = node->child[0];
+
+	node->child[0] = NULL;
+	node->child[1] = NULL;
+	sys_slist_init(&node->routes);
+	net_ipaddr_copy(&node->prefix, prefix);
+	node->len = len;
+
+	return node;
+}
+
+static void lpm_node_free(struct route_lpm_node *node)
+{
+	node->child[0] = lpm_free;
+	lpm_free = node;
+}
+
+static void lpm_init(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(lpm_nodes); i++) {
+		lpm_node_free(&lpm_nodes[i]);
+	}
+}
+
+static int lpm_insert(struct net_route_entry *route)
+{
+	struct route_lpm_node **link = &lpm_root;
+	struct route_lpm_node *node, *new, *branch;
+	uint8_t len = route->prefix_len;
+	uint8_t common = 0U;
+
+	if (len > 128U) {
+		return -EINVAL;
+	}
+
+	while ((node = *link) != NULL) {
+		common = lpm_common_len(&node->prefix, &route->addr,
+					MIN(node->len, len));
+		if (common < node->len) {
+			break;
+		}
+
+		if (node->len == len) {
+			sys_slist_prepend(&node->routes, &route->lpm);
+			return 0;
+		}
+
+		link = &node->child[lpm_bit(&route->addr, node->len)];
+	}
+
+	new = lpm_node_alloc(&route->addr, len);
+	if (!new) {
+		return -ENOMEM;
+	}
+
+	sys_slist_prepend(&new->routes, &route->lpm);
+
+	if (!node) {
+		*link = new;
+		return 0;
+	}
+
+	/* The prefix of the new route and the one of node diverge (or the
+	 * new one is shorter), so they are joined under a common node.
+	 */
+	if (common == len) {
+		new->child[lpm_bit(&node->prefix, len)] = node;
+		*link = new;
+		return 0;
+	}
+
+	branch = lpm_node_alloc(&route->addr, common);
+	if (!branch) {
+		lpm_node_free(new);
+		return -ENOMEM;
+	}
+
+	branch->child[lpm_bit(&node->prefix, common)] = node;
+	branch->child[lpm_bit(&route->addr, common)] = new;
+	*link = branch;
+
+	return 0;
+}
+
+static void lpm_remove(struct net_route_entry *route)
 {
+	struct route_lpm_node **link = &lpm_root, **parent_link = NULL;
+	struct route_lpm_node *node, *parent = NULL;
+	uint8_t len = route->prefix_len;
+
+	while ((node = *link) != NULL) {
+		if (node->len > len ||
+		    lpm_common_len(&node->prefix, &route->addr,
+				   node->len) < node->len) {
+			return;
+		}
+
+		if (node->len == len) {
+			break;
+		}
+
+		parent_link = link;
+		parent = node;
+		link = &node->child[lpm_bit(&route->addr, node->len)];
+	}
+
+	if (!node || !sys_slist_find_and_remove(&node->routes, &route->lpm)) {
+		return;
+	}
+
+	if (!sys_slist_is_empty(&node->routes) ||
+	    (node->child[0] && node->child[1])) {
+		return;
+	}
+
+	*link = node->child[0] ? node->child[0] : node->child[1];
+	lpm_node_free(node);
+
+	/* A branch node left with a single child is not needed anymore */
+	if (parent && sys_slist_is_empty(&parent->routes) &&
+	    !(parent->child[0] && parent->child[1])) {
+		*parent_link = parent->child[0] ? parent->child[0] :
+			parent->child[1];
+		lpm_node_free(parent);
+	}
+}
+
+static struct net_route_entry *lpm_lookup(struct net_if *iface,
+					  struct in6_addr *dst)
+{
+	struct route_lpm_node *node = lpm_root;
+	struct net_route_entry *route, *found = NULL;
+
+	while (node) {
+		if (lpm_common_len(&node->prefix, dst, node->len) < node->len) {
+			break;
+		}
+
+		SYS_SLIST_FOR_EACH_CONTAINER(&node->routes, route, lpm) {
+			if (!iface || route->iface == iface) {
+				found = route;
+				break;
+			}
+		}
+
+		if (node->len == 128U) {
+			break;
+		}
+
+		node = node->child[lpm_bit(dst, node->len)];
+	}
+
+	return found;
+}
+#else
+static inline void lpm_init(void)
+{
+}
+
+static inline int lpm_insert(struct net_route_entry *route)
+{
+	ARG_UNUSED(route);
+
+	return 0;
+}
+
+static inline void lpm_remove(struct net_route_entry *route)
+{
+	ARG_UNUSED(route);
+}
+#endif /* CONFIG_NET_ROUTE_LPM */
+
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+/* Destination cache, remembers the result of recent lookups (including
+ * failed ones) so that a stream of packets to the same destination
+ * does not search the table for each packet. Any change to the routing
+ * table invalidates the whole cache.
+ */
+struct route_cache_entry {
+	struct in6_addr dst;
+	struct net_if *iface;
+	struct net_route_entry *route;
+	uint32_t gen;
+};
+
+static struct route_cache_entry route_cache[CONFIG_NET_ROUTE_CACHE_SIZE];
+
+/* Entries with generation 0 are never valid */
+static uint32_t route_cache_gen = 1U;
+
+static inline struct route_cache_entry *route_cache_slot(
+						const struct in6_addr *dst)
+{
+	uint32_t hash = UNALIGNED_GET(&dst->s6_addr32[0]) ^
+		UNALIGNED_GET(&dst->s6_addr32[1]) ^
+		UNALIGNED_GET(&dst->s6_addr32[2]) ^
+		UNALIGNED_GET(&dst->s6_addr32[3]);
+
+	hash ^= hash >> 16;
+
+	return &route_cache[hash % CONFIG_NET_ROUTE_CACHE_SIZE];
+}
+
+static inline void route_cache_invalidate(void)
+{
+	if (++route_cache_gen == 0U) {
+		route_cache_gen = 1U;
+		memset(route_cache, 0, sizeof(route_cache));
+	}
+}
+#else
+static inline void route_cache_invalidate(void)
+{
+}
+#endif /* CONFIG_NET_ROUTE_CACHE_SIZE > 0 */
+
+static struct net_route_entry *route_lookup(struct net_if *iface,
+					    struct in6_addr *dst)
+{
+#if defined(CONFIG_NET_ROUTE_LPM)
+	return lpm_lookup(iface, dst);
+#else
 	struct net_route_entry *route, *found = NULL;
 	uint8_t longest_match = 0U;
 	int i;
@@ -286,6 +568,32 @@ struct net_route_entry *net_route_lookup(struct net_if *iface,
 		}
 	}
 
+	return found;
+#endif /* CONFIG_NET_ROUTE_LPM */
+}
+
+struct net_route_entry *net_route_lookup(struct net_if *iface,
+					 struct in6_addr *dst)
+{
+	struct net_route_entry *found;
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+	struct route_cache_entry *entry = route_cache_slot(dst);
+
+	if (entry->gen == route_cache_gen && entry->iface == iface &&
+	    net_ipv6_addr_cmp(&entry->dst, dst)) {
+		found = entry->route;
+	} else {
+		found = route_lookup(iface, dst);
+
+		net_ipaddr_copy(&entry->dst, dst);
+		entry->iface = iface;
+		entry->route = found;
+		entry->gen = route_cache_gen;
+	}
+#else
+	found = route_lookup(iface, dst);
+#endif
+
 	if (found) {
 		net_route_info("Found", found, dst);
 
@@ -353,9 +661,9 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	nbr = nbr_new(iface, addr, prefix_len);
 	if (!nbr) {
 		/* Remove the oldest route and try again */
-		sys_snode_t *last = sys_slist_peek_tail(&routes);
+		sys_dnode_t *last = sys_dlist_peek_tail(&routes);
 
-		sys_slist_find_and_remove(&routes, last);
+		sys_dlist_remove(last);
 
 		route = CONTAINER_OF(last,
 				     struct net_route_entry,
@@ -401,7 +709,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	route = net_route_data(nbr);
 	route->iface = iface;
 
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_prepend(&routes, &route->node);
 
 	tmp = nbr_nexthop_get(iface, nexthop);
 
@@ -412,6 +720,14 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	sys_slist_init(&route->nexthop);
 	sys_slist_prepend(&route->nexthop, &nexthop_route->node);
 
+	if (lpm_insert(route) < 0) {
+		NET_ERR("Cannot index route!");
+		net_route_del(route);
+		return NULL;
+	}
+
+	route_cache_invalidate();
+
 	net_route_info("Added", route, addr);
 
 #if defined(CONFIG_NET_MGMT_EVENT_INFO)
@@ -454,7 +770,12 @@ int net_route_del(struct net_route_entry *route)
 	net_mgmt_event_notify(NET_EVENT_IPV6_ROUTE_DEL, route->iface);
 #endif
 
-	sys_slist_find_and_remove(&routes, &route->node);
+	if (sys_dnode_is_linked(&route->node)) {
+		sys_dlist_remove(&route->node);
+	}
+
+	lpm_remove(route);
+	route_cache_invalidate();
 
 	nbr = net_route_get_nbr(route);
 	if (!nbr) {
@@ -915,4 +1236,6 @@ void net_route_init(void)
 
 	NET_DBG("Allocated %d nexthop entries (%zu bytes)",
 		CONFIG_NET_MAX_NEXTHOPS, sizeof(net_route_nexthop_pool));
+
+	lpm_init();
 }
@@ -31,13 +31,24 @@ LOG_MODULE_REGISTER(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
 #define FIN_TIMEOUT_MS MSEC_PER_SEC
 #define FIN_TIMEOUT K_MSEC(FIN_TIMEOUT_MS)
 
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+#define TCP_CC_DEFAULT (&tcp_cc_cubic)
+#else
+#define TCP_CC_DEFAULT (&tcp_cc_newreno)
+#endif
+
+#define TCP_DUP_ACK_THRESHOLD 3
+#define TCP_RTO_MAX_MS 60000
+#define TCP_CWND_MAX UINT16_MAX
+
 static int tcp_rto = CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT;
 static int tcp_retries = CONFIG_NET_TCP_RETRY_COUNT;
 static int tcp_window = NET_IPV6_MTU;
 
-static sys_slist_t tcp_conns = SYS_SLIST_STATIC_INIT(&tcp_conns);
-
-static K_MUTEX_DEFINE(tcp_lock);
+/* All connections, hashed on their 4-tuple. Those without endpoints
+ * yet all share the bucket of the empty 4-tuple.
+ */
+static struct tcp_conn_bucket tcp_conn_hash[CONFIG_NET_TCP_CONN_HASH_SIZE];
 
 static K_MEM_SLAB_DEFINE(tcp_conns_slab, sizeof(struct tcp),
 				CONFIG_NET_MAX_CONTEXTS, 4);
@@ -203,6 +214,90 @@ static int tcp_endpoint_set(union tcp_endpoint *ep, struct net_pkt *pkt,
 	return ret;
 }
 
+static uint32_t tcp_conn_hash_fn(const union tcp_endpoint *local,
+				 const union tcp_endpoint *remote)
+{
+	uint32_t hash = ((uint32_t)local->sin.sin_port << 16) |
+			remote->sin.sin_port;
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && local->sa.sa_family == AF_INET6) {
+		for (int i = 0; i < 4; i++) {
+			hash ^= UNALIGNED_GET(&local->sin6.sin6_addr.s6_addr32[i]);
+			hash = (hash << 5) | (hash >> 27);
+			hash ^= UNALIGNED_GET(&remote->sin6.sin6_addr.s6_addr32[i]);
+			hash = (hash << 5) | (hash >> 27);
+		}
+	} else {
+		hash ^= UNALIGNED_GET(&local->sin.sin_addr.s_addr);
+		hash = (hash << 5) | (hash >> 27);
+		hash ^= UNALIGNED_GET(&remote->sin.sin_addr.s_addr);
+	}
+
+	/* Fold the high bits in so the bucket index depends on them */
+	hash *= 0x9e3779b1U;
+
+	return hash ^ (hash >> 16);
+}
+
+static struct tcp_conn_bucket *tcp_conn_bucket_get(
+	const union tcp_endpoint *local, const union tcp_endpoint *remote)
+{
+	return &tcp_conn_hash[tcp_conn_hash_fn(local, remote) %
+			      ARRAY_SIZE(tcp_conn_hash)];
+}
+
+static void tcp_conn_unindex(struct tcp *conn)
+{
+	struct tcp_conn_bucket *bucket = conn->bucket;
+	k_spinlock_key_t key;
+
+	if (bucket == NULL) {
+		return;
+	}
+
+	key = k_spin_lock(&bucket->lock);
+	sys_slist_find_and_remove(&bucket->conns, &conn->hash_next);
+	conn->bucket = NULL;
+	k_spin_unlock(&bucket->lock, key);
+}
+
+/* Must be called whenever conn->src or conn->dst are (re)set */
+static void tcp_conn_index(struct tcp *conn)
+{
+	struct tcp_conn_bucket *from = conn->bucket;
+	struct tcp_conn_bucket *to = tcp_conn_bucket_get(&conn->src,
+							 &conn->dst);
+	struct tcp_conn_bucket *first = to;
+	struct tcp_conn_bucket *second = NULL;
+	k_spinlock_key_t key, key2;
+
+	/* Move the connection in one critical section, so that a lookup
+	 * always finds it in one of the buckets. Two bucket locks are
+	 * taken in address order.
+	 */
+	if (from != NULL && from != to) {
+		first = MIN(from, to);
+		second = MAX(from, to);
+	}
+
+	key = k_spin_lock(&first->lock);
+	if (second != NULL) {
+		key2 = k_spin_lock(&second->lock);
+	}
+
+	if (from != NULL) {
+		sys_slist_find_and_remove(&from->conns, &conn->hash_next);
+	}
+
+	sys_slist_prepend(&to->conns, &conn->hash_next);
+	conn->bucket = to;
+
+	if (second != NULL) {
+		k_spin_unlock(&second->lock, key2);
+	}
+	k_spin_unlock(&first->lock, key);
+}
+
 static const char *tcp_flags(uint8_t flags)
 {
 #define BUF_SIZE 25 /* 6 * 4 + 1 */
@@ -352,39 +447,13 @@ static void tcp_send_queue_flush(struct tcp *conn)
 	}
 }
 
-#if CONFIG_NET_TCP_LOG_LEVEL >= LOG_LEVEL_DBG
-#define tcp_conn_unref(conn)				\
-	tcp_conn_unref_debug(conn, __func__, __LINE__)
-
-static int tcp_conn_unref_debug(struct tcp *conn, const char *caller, int line)
-#else
-static int tcp_conn_unref(struct tcp *conn)
-#endif
+/* Free a connection whose last reference is gone */
+static void tcp_conn_release(struct tcp *conn)
 {
-	int ref_count = atomic_get(&conn->ref_count);
 	struct net_pkt *pkt;
 
-#if CONFIG_NET_TCP_LOG_LEVEL >= LOG_LEVEL_DBG
-	NET_DBG("conn: %p, ref_count=%d (%s():%d)", conn, ref_count,
-		caller, line);
-#endif
-
-#if !defined(CONFIG_NET_TEST_PROTOCOL)
-	if (conn->in_connect) {
-		NET_DBG("conn: %p is waiting on connect semaphore", conn);
-		tcp_send_queue_flush(conn);
-		goto out;
-	}
-#endif /* CONFIG_NET_TEST_PROTOCOL */
-
-	k_mutex_lock(&tcp_lock, K_FOREVER);
-
-	ref_count = atomic_dec(&conn->ref_count) - 1;
-	if (ref_count) {
-		tp_out(net_context_get_family(conn->context), conn->iface,
-		       "TP_TRACE", "event", "CONN_DELETE");
-		goto unlock;
-	}
+	/* No lookup may find the connection from now on */
+	tcp_conn_unindex(conn);
 
 	/* If there is any pending data, pass that to application */
 	while ((pkt = k_fifo_get(&conn->recv_data, K_NO_WAIT)) != NULL) {
@@ -423,14 +492,43 @@ static int tcp_conn_unref(struct tcp *conn)
 	k_work_cancel_delayable(&conn->timewait_timer);
 	k_work_cancel_delayable(&conn->fin_timer);
 
-	sys_slist_find_and_remove(&tcp_conns, &conn->next);
-
 	memset(conn, 0, sizeof(*conn));
 
 	k_mem_slab_free(&tcp_conns_slab, (void **)&conn);
+}
+
+#if CONFIG_NET_TCP_LOG_LEVEL >= LOG_LEVEL_DBG
+#define tcp_conn_unref(conn)				\
+	tcp_conn_unref_debug(conn, __func__, __LINE__)
+
+static int tcp_conn_unref_debug(struct tcp *conn, const char *caller, int line)
+#else
+static int tcp_conn_unref(struct tcp *conn)
+#endif
+{
+	int ref_count = atomic_get(&conn->ref_count);
+
+#if CONFIG_NET_TCP_LOG_LEVEL >= LOG_LEVEL_DBG
+	NET_DBG("conn: %p, ref_count=%d (%s():%d)", conn, ref_count,
+		caller, line);
+#endif
+
+#if !defined(CONFIG_NET_TEST_PROTOCOL)
+	if (conn->in_connect) {
+		NET_DBG("conn: %p is waiting on connect semaphore", conn);
+		tcp_send_queue_flush(conn);
+		goto out;
+	}
+#endif /* CONFIG_NET_TEST_PROTOCOL */
+
+	ref_count = atomic_dec(&conn->ref_count) - 1;
+	if (ref_count) {
+		tp_out(net_context_get_family(conn->context), conn->iface,
+		       "TP_TRACE", "event", "CONN_DELETE");
+		goto out;
+	}
 
-unlock:
-	k_mutex_unlock(&tcp_lock);
+	tcp_conn_release(conn);
 out:
 	return ref_count;
 }
@@ -613,8 +711,12 @@ static bool tcp_options_check(struct tcp_options *recv_options,
 
 	NET_DBG("len=%zd", len);
 
-	recv_options->mss_found = false;
-	recv_options->wnd_found = false;
+	/* MSS and window scale are only sent in SYN segments, keep
+	 * them for the lifetime of the connection.
+	 */
+#if defined(CONFIG_NET_TCP_SACK)
+	recv_options->sack_cnt = 0;
+#endif
 
 	for ( ; options && len >= 1; options += opt_len, len -= opt_len) {
 		opt = options[0];
@@ -661,6 +763,36 @@ static bool tcp_options_check(struct tcp_options *recv_options,
 			recv_options->window = opt;
 			recv_options->wnd_found = true;
 			break;
+#if defined(CONFIG_NET_TCP_SACK)
+		case TCPOPT_SACK_PERM:
+			if (opt_len != 2) {
+				result = false;
+				goto end;
+			}
+
+			recv_options->sack_perm = true;
+			break;
+		case TCPOPT_SACK:
+			if ((opt_len - 2) % 8 != 0) {
+				result = false;
+				goto end;
+			}
+
+			for (recv_options->sack_cnt = 0;
+			     recv_options->sack_cnt < MIN((opt_len - 2) / 8,
+							  TCP_SACK_MAX_BLOCKS);
+			     recv_options->sack_cnt++) {
+				uint32_t *block = (uint32_t *)(options + 2 + 8 *
+						recv_options->sack_cnt);
+				struct tcp_sack_block *sack = &recv_options->sack[
+						recv_options->sack_cnt];
+
+				sack->left = ntohl(UNALIGNED_GET(block));
+				sack->right = ntohl(UNALIGNED_GET(block + 1));
+				NET_DBG("SACK %u-%u", sack->left, sack->right);
+			}
+			break;
+#endif
 		default:
 			continue;
 		}
@@ -755,11 +887,30 @@ static int tcp_finalize_pkt(struct net_pkt *pkt)
 	return -EINVAL;
 }
 
+/* Length of the options added to an outgoing segment. Only SYN
+ * segments carry options, SACK permitted is padded with two NOPs.
+ */
+static size_t tcp_options_len(struct tcp *conn, uint8_t flags)
+{
+#if defined(CONFIG_NET_TCP_SACK)
+	/* Answer a SYN with SACK permitted only if the peer offered it */
+	if ((flags & SYN) && (!(flags & ACK) || conn->recv_options.sack_perm)) {
+		return 4;
+	}
+#endif
+	return 0;
+}
+
 static int tcp_header_add(struct tcp *conn, struct net_pkt *pkt, uint8_t flags,
 			  uint32_t seq)
 {
 	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct tcphdr);
+	static const uint8_t syn_options[] = {
+		TCPOPT_NOP, TCPOPT_NOP, TCPOPT_SACK_PERM, 2
+	};
+	size_t options_len = tcp_options_len(conn, flags);
 	struct tcphdr *th;
+	int ret;
 
 	th = (struct tcphdr *)net_pkt_get_data(pkt, &tcp_access);
 	if (!th) {
@@ -770,7 +921,7 @@ static int tcp_header_add(struct tcp *conn, struct net_pkt *pkt, uint8_t flags,
 
 	UNALIGNED_PUT(conn->src.sin.sin_port, &th->th_sport);
 	UNALIGNED_PUT(conn->dst.sin.sin_port, &th->th_dport);
-	th->th_off = 5;
+	th->th_off = 5 + options_len / 4;
 	UNALIGNED_PUT(flags, &th->th_flags);
 	UNALIGNED_PUT(htons(conn->recv_win), &th->th_win);
 	UNALIGNED_PUT(htonl(seq), &th->th_seq);
@@ -779,7 +930,12 @@ static int tcp_header_add(struct tcp *conn, struct net_pkt *pkt, uint8_t flags,
 		UNALIGNED_PUT(htonl(conn->ack), &th->th_ack);
 	}
 
-	return net_pkt_set_data(pkt, &tcp_access);
+	ret = net_pkt_set_data(pkt, &tcp_access);
+	if (ret == 0 && options_len) {
+		ret = net_pkt_write(pkt, syn_options, options_len);
+	}
+
+	return ret;
 }
 
 static int ip_header_add(struct tcp *conn, struct net_pkt *pkt)
@@ -805,7 +961,8 @@ static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 	struct net_pkt *pkt;
 	int ret = 0;
 
-	pkt = tcp_pkt_alloc(conn, sizeof(struct tcphdr));
+	pkt = tcp_pkt_alloc(conn, sizeof(struct tcphdr) +
+			    tcp_options_len(conn, flags));
 	if (!pkt) {
 		ret = -ENOBUFS;
 		goto out;
@@ -888,9 +1045,34 @@ static int tcp_pkt_peek(struct net_pkt *to, struct net_pkt *from, size_t pos,
 	return net_pkt_copy(to, from, len);
 }
 
+/* Retransmission timeout of the connection in milliseconds */
+static int tcp_conn_rto(struct tcp *conn)
+{
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	return conn->rto;
+#else
+	ARG_UNUSED(conn);
+
+	return tcp_rto;
+#endif
+}
+
+/* Amount of data that may be in flight, limited by the receiver's
+ * window and by the congestion window.
+ */
+static uint32_t tcp_send_window(struct tcp *conn)
+{
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	return MIN(conn->send_win, conn->cwnd);
+#else
+	return conn->send_win;
+#endif
+}
+
 static bool tcp_window_full(struct tcp *conn)
 {
-	bool window_full = !(conn->unacked_len < conn->send_win);
+	bool window_full = !((uint32_t)conn->unacked_len <
+			     tcp_send_window(conn));
 
 	NET_DBG("conn: %p window_full=%hu", conn, window_full);
 
@@ -915,39 +1097,260 @@ static int tcp_unsent_len(struct tcp *conn)
 	return unsent_len;
 }
 
-static int tcp_send_data(struct tcp *conn)
+/* Send len bytes of send_data starting at offset pos as one segment */
+static int tcp_send_segment(struct tcp *conn, int pos, int len)
 {
-	int ret = 0;
-	int pos, len;
 	struct net_pkt *pkt;
-
-	pos = conn->unacked_len;
-	len = MIN3(conn->send_data_total - conn->unacked_len,
-		   conn->send_win - conn->unacked_len,
-		   conn_mss(conn));
-	if (len == 0) {
-		NET_DBG("conn: %p no data to send", conn);
-		ret = -ENODATA;
-		goto out;
-	}
+	int ret;
 
 	pkt = tcp_pkt_alloc(conn, len);
 	if (!pkt) {
 		NET_ERR("conn: %p packet allocation failed, len=%d", conn, len);
-		ret = -ENOBUFS;
-		goto out;
+		return -ENOBUFS;
 	}
 
 	ret = tcp_pkt_peek(pkt, conn->send_data, pos, len);
 	if (ret < 0) {
 		tcp_pkt_unref(pkt);
-		ret = -ENOBUFS;
+		return -ENOBUFS;
+	}
+
+	ret = tcp_out_ext(conn, PSH | ACK, pkt, conn->seq + pos);
+
+	/* The data we want to send, has been moved to the send queue so we
+	 * can unref the head net_pkt. If there was an error, we need to remove
+	 * the packet anyway.
+	 */
+	tcp_pkt_unref(pkt);
+
+	return ret;
+}
+
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+/* Time one segment per round trip, RFC 6298. Segments sent while
+ * retransmitting are never timed (Karn's algorithm).
+ */
+static void tcp_rtt_start(struct tcp *conn)
+{
+	if (conn->data_mode == TCP_DATA_MODE_RESEND || conn->rtt_pending) {
+		return;
+	}
+
+	conn->rtt_pending = true;
+	conn->rtt_seq = conn->seq + conn->unacked_len;
+	conn->rtt_start = k_uptime_get_32();
+}
+
+static void tcp_rtt_update(struct tcp *conn)
+{
+	int32_t rtt, delta;
+
+	if (!conn->rtt_pending ||
+	    net_tcp_seq_cmp(conn->seq, conn->rtt_seq) < 0) {
+		return;
+	}
+
+	conn->rtt_pending = false;
+	rtt = k_uptime_get_32() - conn->rtt_start;
+
+	if (conn->srtt == 0) {
+		conn->srtt = rtt << 3;
+		conn->rttvar = rtt << 1;
+	} else {
+		delta = rtt - (conn->srtt >> 3);
+		conn->srtt += delta;
+		if (delta < 0) {
+			delta = -delta;
+		}
+		conn->rttvar += delta - (conn->rttvar >> 2);
+	}
+
+	/* The configured initial RTO is also the lower bound */
+	conn->rto = CLAMP((conn->srtt >> 3) + MAX(conn->rttvar, 1U),
+			  (uint32_t)tcp_rto, TCP_RTO_MAX_MS);
+
+	NET_DBG("conn: %p rtt=%d srtt=%u rttvar=%u rto=%u", conn, rtt,
+		conn->srtt >> 3, conn->rttvar >> 2, conn->rto);
+}
+
+static void tcp_cc_init(struct tcp *conn)
+{
+	conn->cc->init(conn);
+	conn->recover = conn->seq;
+	conn->dup_acks = 0;
+	conn->in_recovery = false;
+}
+
+/* Length of the first hole in the peer's receive queue, from the
+ * first unacknowledged byte up to the lowest SACKed block.
+ */
+static int tcp_sack_hole_len(struct tcp *conn)
+{
+	int len = MIN(conn->unacked_len, conn_mss(conn));
+
+#if defined(CONFIG_NET_TCP_SACK)
+	for (int i = 0; i < conn->recv_options.sack_cnt; i++) {
+		uint32_t left = conn->recv_options.sack[i].left;
+
+		if (net_tcp_seq_greater(left, conn->seq) &&
+		    net_tcp_seq_cmp(left, conn->seq + len) < 0) {
+			len = left - conn->seq;
+		}
+	}
+#endif
+
+	return len;
+}
+
+/* Retransmit the first unacknowledged segment without waiting for the
+ * retransmission timer.
+ */
+static void tcp_fast_retransmit(struct tcp *conn)
+{
+	int len = tcp_sack_hole_len(conn);
+
+	if (len <= 0) {
+		return;
+	}
+
+	conn->rtt_pending = false;
+
+	if (tcp_send_segment(conn, 0, len) == 0) {
+		conn->fast_rexmits++;
+		net_stats_update_tcp_resent(conn->iface, len);
+		net_stats_update_tcp_seg_rexmit(conn->iface);
+	}
+
+	NET_DBG("conn: %p fast retransmit len=%d cwnd=%u ssthresh=%u", conn,
+		len, conn->cwnd, conn->ssthresh);
+}
+
+/* New data was acknowledged, conn->seq is already advanced */
+static void tcp_cc_ack(struct tcp *conn, uint32_t len_acked)
+{
+	uint32_t mss = conn_mss(conn);
+
+	tcp_rtt_update(conn);
+	conn->dup_acks = 0;
+
+	if (!conn->in_recovery) {
+		conn->cc->acked(conn, len_acked);
+		conn->cwnd = MIN(conn->cwnd, TCP_CWND_MAX);
+		return;
+	}
+
+	if (net_tcp_seq_cmp(conn->seq, conn->recover) >= 0) {
+		/* Full acknowledgment, deflate the window, RFC 6582 */
+		conn->cwnd = MIN(conn->ssthresh,
+				 MAX((uint32_t)conn->unacked_len, mss) + mss);
+		conn->in_recovery = false;
+		return;
+	}
+
+	/* Partial acknowledgment, the next segment was lost too */
+	tcp_fast_retransmit(conn);
+
+	conn->cwnd -= MIN(conn->cwnd, len_acked);
+	if (len_acked >= mss) {
+		conn->cwnd += mss;
+	}
+}
+
+static int tcp_send_queued_data(struct tcp *conn);
+
+/* Duplicate ACK, RFC 5681 chapter 3.2 */
+static void tcp_cc_dup_ack(struct tcp *conn)
+{
+	uint32_t mss = conn_mss(conn);
+
+	if (conn->data_mode == TCP_DATA_MODE_RESEND) {
+		return;
+	}
+
+	if (conn->in_recovery) {
+		/* Every duplicate ACK means a segment has left the network */
+		conn->cwnd += mss;
+		(void)tcp_send_queued_data(conn);
+		return;
+	}
+
+	/* Do not reduce the window twice for losses of the same flight */
+	if (++conn->dup_acks != TCP_DUP_ACK_THRESHOLD ||
+	    net_tcp_seq_cmp(conn->seq, conn->recover) < 0) {
+		return;
+	}
+
+	conn->ssthresh = conn->cc->loss(conn);
+	conn->cwnd = conn->ssthresh + TCP_DUP_ACK_THRESHOLD * mss;
+	conn->recover = conn->seq + conn->unacked_len;
+	conn->in_recovery = true;
+
+	tcp_fast_retransmit(conn);
+}
+
+/* The retransmission timer expired, restart from one segment */
+static void tcp_cc_timeout(struct tcp *conn)
+{
+	/* Only the first expiration for a flight reduces ssthresh */
+	if (conn->data_mode == TCP_DATA_MODE_SEND && conn->unacked_len) {
+		conn->ssthresh = conn->cc->loss(conn);
+		conn->recover = conn->seq + conn->unacked_len;
+	}
+
+	conn->rto = MIN(conn->rto * 2, TCP_RTO_MAX_MS);
+
+	conn->cwnd = conn_mss(conn);
+	conn->dup_acks = 0;
+	conn->in_recovery = false;
+	conn->rtt_pending = false;
+}
+#else
+static inline void tcp_rtt_start(struct tcp *conn)
+{
+	ARG_UNUSED(conn);
+}
+
+static inline void tcp_cc_init(struct tcp *conn)
+{
+	ARG_UNUSED(conn);
+}
+
+static inline void tcp_cc_ack(struct tcp *conn, uint32_t len_acked)
+{
+	ARG_UNUSED(conn);
+	ARG_UNUSED(len_acked);
+}
+
+static inline void tcp_cc_dup_ack(struct tcp *conn)
+{
+	ARG_UNUSED(conn);
+}
+
+static inline void tcp_cc_timeout(struct tcp *conn)
+{
+	ARG_UNUSED(conn);
+}
+#endif /* CONFIG_NET_TCP_CONGESTION_CONTROL */
+
+static int tcp_send_data(struct tcp *conn)
+{
+	int ret = 0;
+	int pos, len;
+
+	pos = conn->unacked_len;
+	len = MIN3(conn->send_data_total - conn->unacked_len,
+		   tcp_send_window(conn) - conn->unacked_len,
+		   conn_mss(conn));
+	if (len == 0) {
+		NET_DBG("conn: %p no data to send", conn);
+		ret = -ENODATA;
 		goto out;
 	}
 
-	ret = tcp_out_ext(conn, PSH | ACK, pkt, conn->seq + conn->unacked_len);
+	ret = tcp_send_segment(conn, pos, len);
 	if (ret == 0) {
 		conn->unacked_len += len;
+		tcp_rtt_start(conn);
 
 		if (conn->data_mode == TCP_DATA_MODE_RESEND) {
 			net_stats_update_tcp_resent(conn->iface, len);
@@ -958,12 +1361,6 @@ static int tcp_send_data(struct tcp *conn)
 		}
 	}
 
-	/* The data we want to send, has been moved to the send queue so we
-	 * can unref the head net_pkt. If there was an error, we need to remove
-	 * the packet anyway.
-	 */
-	tcp_pkt_unref(pkt);
-
 	conn_send_data_dump(conn);
 
  out:
@@ -1013,7 +1410,7 @@ static int tcp_send_queued_data(struct tcp *conn)
 	if (subscribe) {
 		conn->send_data_retries = 0;
 		k_work_reschedule_for_queue(&tcp_work_q, &conn->send_data_timer,
-					    K_MSEC(tcp_rto));
+					    K_MSEC(tcp_conn_rto(conn)));
 	}
  out:
 	return ret;
@@ -1051,6 +1448,8 @@ static void tcp_resend_data(struct k_work *work)
 		goto out;
 	}
 
+	tcp_cc_timeout(conn);
+
 	conn->data_mode = TCP_DATA_MODE_RESEND;
 	conn->unacked_len = 0;
 
@@ -1081,7 +1480,7 @@ static void tcp_resend_data(struct k_work *work)
 	}
 
 	k_work_reschedule_for_queue(&tcp_work_q, &conn->send_data_timer,
-				    K_MSEC(tcp_rto));
+				    K_MSEC(tcp_conn_rto(conn)));
 
  out:
 	k_mutex_unlock(&conn->lock);
@@ -1168,6 +1567,12 @@ static struct tcp *tcp_conn_alloc(void)
 	conn->state = TCP_LISTEN;
 	conn->recv_win = tcp_window;
 
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	conn->cc = TCP_CC_DEFAULT;
+	conn->rto = tcp_rto;
+#endif
+	tcp_cc_init(conn);
+
 	/* The ISN value will be set when we get the connection attempt or
 	 * when trying to create a connection.
 	 */
@@ -1183,7 +1588,7 @@ static struct tcp *tcp_conn_alloc(void)
 
 	tcp_conn_ref(conn);
 
-	sys_slist_append(&tcp_conns, &conn->next);
+	tcp_conn_index(conn);
 out:
 	NET_DBG("conn: %p", conn);
 
@@ -1201,59 +1606,48 @@ fail:
 
 int net_tcp_get(struct net_context *context)
 {
-	int ret = 0;
 	struct tcp *conn;
 
-	k_mutex_lock(&tcp_lock, K_FOREVER);
-
 	conn = tcp_conn_alloc();
 	if (conn == NULL) {
-		ret = -ENOMEM;
-		goto out;
+		return -ENOMEM;
 	}
 
 	/* Mutually link the net_context and tcp connection */
 	conn->context = context;
 	context->tcp = conn;
-out:
-	k_mutex_unlock(&tcp_lock);
 
-	return ret;
+	return 0;
 }
 
-static bool tcp_endpoint_cmp(union tcp_endpoint *ep, struct net_pkt *pkt,
-			     enum pkt_addr which)
+static struct tcp *tcp_conn_search(struct net_pkt *pkt)
 {
-	union tcp_endpoint ep_tmp;
+	union tcp_endpoint local, remote;
+	struct tcp_conn_bucket *bucket;
+	struct tcp *conn = NULL;
+	k_spinlock_key_t key;
+	size_t len;
 
-	if (tcp_endpoint_set(&ep_tmp, pkt, which) < 0) {
-		return false;
+	if (tcp_endpoint_set(&local, pkt, TCP_EP_DST) < 0 ||
+	    tcp_endpoint_set(&remote, pkt, TCP_EP_SRC) < 0) {
+		return NULL;
 	}
 
-	return !memcmp(ep, &ep_tmp, tcp_endpoint_len(ep->sa.sa_family));
-}
-
-static bool tcp_conn_cmp(struct tcp *conn, struct net_pkt *pkt)
-{
-	return tcp_endpoint_cmp(&conn->src, pkt, TCP_EP_DST) &&
-		tcp_endpoint_cmp(&conn->dst, pkt, TCP_EP_SRC);
-}
-
-static struct tcp *tcp_conn_search(struct net_pkt *pkt)
-{
-	bool found = false;
-	struct tcp *conn;
-	struct tcp *tmp;
+	len = tcp_endpoint_len(local.sa.sa_family);
+	bucket = tcp_conn_bucket_get(&local, &remote);
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&tcp_conns, conn, tmp, next) {
+	key = k_spin_lock(&bucket->lock);
 
-		found = tcp_conn_cmp(conn, pkt);
-		if (found) {
+	SYS_SLIST_FOR_EACH_CONTAINER(&bucket->conns, conn, hash_next) {
+		if (!memcmp(&conn->src, &local, len) &&
+		    !memcmp(&conn->dst, &remote, len)) {
 			break;
 		}
 	}
 
-	return found ? conn : NULL;
+	k_spin_unlock(&bucket->lock, key);
+
+	return conn;
 }
 
 static struct tcp *tcp_conn_new(struct net_pkt *pkt);
@@ -1430,6 +1824,8 @@ static struct tcp *tcp_conn_new(struct net_pkt *pkt)
 		goto err;
 	}
 
+	tcp_conn_index(conn);
+
 	NET_DBG("conn: src: %s, dst: %s",
 		log_strdup(net_sprint_addr(conn->src.sa.sa_family,
 				(const void *)&conn->src.sin.sin_addr)),
@@ -1638,6 +2034,10 @@ static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 	struct net_pkt *recv_pkt;
 	void *recv_user_data;
 	struct k_fifo *recv_data_fifo;
+	struct net_context *writable_ctx = NULL;
+	net_context_writable_cb_t writable_cb = NULL;
+	uint16_t prev_send_win = 0;
+	bool window_full = false;
 	size_t len;
 	int ret;
 
@@ -1669,6 +2069,10 @@ static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 		goto next_state;
 	}
 
+#if defined(CONFIG_NET_TCP_SACK)
+	conn->recv_options.sack_cnt = 0;
+#endif
+
 	if (tcp_options_len && !tcp_options_check(&conn->recv_options, pkt,
 						  tcp_options_len)) {
 		NET_DBG("DROP: Invalid TCP option list");
@@ -1680,6 +2084,11 @@ static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 	if (th) {
 		size_t max_win;
 
+		/* The application is told when the send window opens again */
+		window_full = conn->state == TCP_ESTABLISHED &&
+			      tcp_window_full(conn);
+
+		prev_send_win = conn->send_win;
 		conn->send_win = ntohs(th_win(th));
 
 #if defined(CONFIG_NET_TCP_MAX_SEND_WINDOW_SIZE)
@@ -1731,6 +2140,7 @@ next_state:
 				th_seq(th) == conn->ack)) {
 			k_work_cancel_delayable(&conn->establish_timer);
 			tcp_send_timer_cancel(conn);
+			tcp_cc_init(conn);
 			next = TCP_ESTABLISHED;
 			net_context_set_state(conn->context,
 					      NET_CONTEXT_CONNECTED);
@@ -1771,6 +2181,7 @@ next_state:
 				conn_ack(conn, + len);
 			}
 
+			tcp_cc_init(conn);
 			next = TCP_ESTABLISHED;
 			net_context_set_state(conn->context,
 					      NET_CONTEXT_CONNECTED);
@@ -1845,6 +2256,8 @@ next_state:
 
 			conn_send_data_dump(conn);
 
+			tcp_cc_ack(conn, len_acked);
+
 			if (!k_work_delayable_remaining_get(
 				    &conn->send_data_timer)) {
 				NET_DBG("conn: %p, Missing a subscription "
@@ -1874,6 +2287,10 @@ next_state:
 				conn_state(conn, TCP_CLOSED);
 				break;
 			}
+		} else if (th && len == 0 && th_ack(th) == conn->seq &&
+			   conn->unacked_len > 0 &&
+			   conn->send_win == prev_send_win) {
+			tcp_cc_dup_ack(conn);
 		}
 
 		if (th && len) {
@@ -1974,8 +2391,18 @@ next_state:
 	recv_user_data = conn->recv_user_data;
 	recv_data_fifo = &conn->recv_data;
 
+	if (window_full && conn->context && conn->state == TCP_ESTABLISHED &&
+	    !tcp_window_full(conn)) {
+		writable_ctx = conn->context;
+		writable_cb = writable_ctx->writable_cb;
+	}
+
 	k_mutex_unlock(&conn->lock);
 
+	if (writable_cb) {
+		writable_cb(writable_ctx);
+	}
+
 	/* Pass all the received data stored in recv fifo to the application.
 	 * This is done like this so that we do not have any connection lock
 	 * held.
@@ -2246,6 +2673,10 @@ int net_tcp_connect(struct net_context *context,
 		ret = -EPROTONOSUPPORT;
 	}
 
+	if (ret == 0) {
+		tcp_conn_index(conn);
+	}
+
 	if (!(IS_ENABLED(CONFIG_NET_TEST_PROTOCOL) ||
 	      IS_ENABLED(CONFIG_NET_TEST))) {
 		conn->seq = tcp_init_isn(&conn->src.sa, &conn->dst.sa);
@@ -2425,6 +2856,19 @@ drop:
 }
 
 #if defined(CONFIG_NET_TEST_PROTOCOL)
+/* The test protocol drives a single connection */
+static struct tcp *tcp_conn_first(void)
+{
+	struct tcp *conn = NULL;
+
+	for (int i = 0; i < ARRAY_SIZE(tcp_conn_hash) && conn == NULL; i++) {
+		conn = SYS_SLIST_PEEK_HEAD_CONTAINER(&tcp_conn_hash[i].conns,
+						     conn, hash_next);
+	}
+
+	return conn;
+}
+
 static enum net_verdict tcp_input(struct net_conn *net_conn,
 				  struct net_pkt *pkt,
 				  union net_ip_header *ip,
@@ -2444,6 +2888,7 @@ static enum net_verdict tcp_input(struct net_conn *net_conn,
 			conn = context->tcp;
 			tcp_endpoint_set(&conn->dst, pkt, TCP_EP_SRC);
 			tcp_endpoint_set(&conn->src, pkt, TCP_EP_DST);
+			tcp_conn_index(conn);
 			/* Make an extra reference, the sanity check suite
 			 * will delete the connection explicitly
 			 */
@@ -2576,7 +3021,7 @@ enum net_verdict tp_input(struct net_conn *net_conn,
 			{
 				struct net_context *context;
 
-				conn = (void *)sys_slist_peek_head(&tcp_conns);
+				conn = tcp_conn_first();
 				context = conn->context;
 				while (tcp_conn_unref(conn))
 					;
@@ -2589,7 +3034,7 @@ enum net_verdict tp_input(struct net_conn *net_conn,
 		}
 		if (is("CLOSE2", tp->op)) {
 			struct tcp *conn =
-				(void *)sys_slist_peek_head(&tcp_conns);
+				tcp_conn_first();
 			net_tcp_put(conn->context);
 		}
 		if (is("RECV", tp->op)) {
@@ -2607,7 +3052,7 @@ enum net_verdict tp_input(struct net_conn *net_conn,
 		if (is("SEND", tp->op)) {
 			ssize_t len = tp_str_to_hex(buf, sizeof(buf), tp->data);
 			struct tcp *conn =
-				(void *)sys_slist_peek_head(&tcp_conns);
+				tcp_conn_first();
 
 			tp_output(pkt->family, pkt->iface, buf, 1);
 			responded = true;
@@ -2632,7 +3077,7 @@ enum net_verdict tp_input(struct net_conn *net_conn,
 		break;
 	case TP_INTROSPECT_REQUEST:
 		json_len = sizeof(buf);
-		conn = (void *)sys_slist_peek_head(&tcp_conns);
+		conn = tcp_conn_first();
 		tcp_to_json(conn, buf, &json_len);
 		break;
 	case TP_DEBUG_STOP: case TP_DEBUG_CONTINUE:
@@ -2674,23 +3119,58 @@ static void test_cb_register(sa_family_t family, uint8_t proto, uint16_t remote_
 }
 #endif /* CONFIG_NET_TEST_PROTOCOL */
 
+/* Take a reference unless the last one is already gone */
+static bool tcp_conn_try_ref(struct tcp *conn)
+{
+	atomic_val_t ref_count;
+
+	do {
+		ref_count = atomic_get(&conn->ref_count);
+		if (ref_count == 0) {
+			return false;
+		}
+	} while (!atomic_cas(&conn->ref_count, ref_count, ref_count + 1));
+
+	return true;
+}
+
+/* Drop a reference taken with tcp_conn_try_ref() */
+static void tcp_conn_ref_drop(struct tcp *conn)
+{
+	if (atomic_dec(&conn->ref_count) == 1) {
+		tcp_conn_release(conn);
+	}
+}
+
 void net_tcp_foreach(net_tcp_cb_t cb, void *user_data)
 {
-	struct tcp *conn;
-	struct tcp *tmp;
+	struct tcp *conns[CONFIG_NET_MAX_CONTEXTS];
 
-	k_mutex_lock(&tcp_lock, K_FOREVER);
+	for (int i = 0; i < ARRAY_SIZE(tcp_conn_hash); i++) {
+		struct tcp_conn_bucket *bucket = &tcp_conn_hash[i];
+		k_spinlock_key_t key;
+		struct tcp *conn;
+		int count = 0;
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&tcp_conns, conn, tmp, next) {
+		/* The callback runs without the bucket lock, a reference
+		 * keeps each connection alive until it returns.
+		 */
+		key = k_spin_lock(&bucket->lock);
 
-		if (atomic_get(&conn->ref_count) > 0) {
-			k_mutex_unlock(&tcp_lock);
-			cb(conn, user_data);
-			k_mutex_lock(&tcp_lock, K_FOREVER);
+		SYS_SLIST_FOR_EACH_CONTAINER(&bucket->conns, conn, hash_next) {
+			if (count < ARRAY_SIZE(conns) &&
+			    tcp_conn_try_ref(conn)) {
+				conns[count++] = conn;
+			}
 		}
-	}
 
-	k_mutex_unlock(&tcp_lock);
+		k_spin_unlock(&bucket->lock, key);
+
+		for (int j = 0; j < count; j++) {
+			cb(conns[j], user_data);
+			tcp_conn_ref_drop(conns[j]);
+		}
+	}
 }
 
 uint16_t net_tcp_get_recv_mss(const struct tcp *conn)
@@ -2734,6 +3214,26 @@ uint16_t net_tcp_get_recv_mss(const struct tcp *conn)
 	return 0;
 }
 
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+int net_tcp_get_cc_info(struct tcp *conn, struct tcp_cc_info *info)
+{
+	k_mutex_lock(&conn->lock, K_FOREVER);
+
+	info->algo = conn->cc->name;
+	info->cwnd = conn->cwnd;
+	info->ssthresh = conn->ssthresh;
+	info->srtt = conn->srtt >> 3;
+	info->rttvar = conn->rttvar >> 2;
+	info->rto = conn->rto;
+	info->fast_rexmits = conn->fast_rexmits;
+	info->in_recovery = conn->in_recovery;
+
+	k_mutex_unlock(&conn->lock);
+
+	return 0;
+}
+#endif /* CONFIG_NET_TCP_CONGESTION_CONTROL */
+
 const char *net_tcp_state_str(enum tcp_state state)
 {
 	return tcp_state_to_str(state, false);
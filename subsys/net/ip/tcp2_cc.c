@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
+
+#include <zephyr.h>
+#include <net/net_pkt.h>
+#include <net/net_context.h>
+#include "net_private.h"
+#include "tcp2_priv.h"
+
+/* Initial window, RFC 5681 chapter 3.1 */
+static uint32_t tcp_cc_initial_window(struct tcp *conn)
+{
+	uint32_t mss = conn_mss(conn);
+
+	return MIN(4 * mss, MAX(2 * mss, 4380U));
+}
+
+/* Grow the window by at most one segment per ACK in slow start
+ * (appropriate byte counting, RFC 3465). Returns false if the
+ * connection is in congestion avoidance.
+ */
+static bool tcp_cc_slow_start(struct tcp *conn, uint32_t len_acked)
+{
+	if (conn->cwnd >= conn->ssthresh) {
+		return false;
+	}
+
+	conn->cwnd += MIN(len_acked, (uint32_t)conn_mss(conn));
+
+	return true;
+}
+
+static void newreno_init(struct tcp *conn)
+{
+	conn->cwnd = tcp_cc_initial_window(conn);
+	conn->ssthresh = UINT32_MAX;
+}
+
+static void newreno_acked(struct tcp *conn, uint32_t len_acked)
+{
+	uint32_t mss = conn_mss(conn);
+
+	if (tcp_cc_slow_start(conn, len_acked)) {
+		return;
+	}
+
+	/* Congestion avoidance, one segment per round trip */
+	conn->cwnd += MAX(1U, mss * mss / conn->cwnd);
+}
+
+static uint32_t newreno_loss(struct tcp *conn)
+{
+	return MAX((uint32_t)conn->unacked_len / 2, 2U * conn_mss(conn));
+}
+
+const struct tcp_cc_ops tcp_cc_newreno = {
+	.name = "newreno",
+	.init = newreno_init,
+	.acked = newreno_acked,
+	.loss = newreno_loss,
+};
+
+/* CUBIC, RFC 8312. The window is kept in bytes and time in
+ * milliseconds, C = 0.4 and beta = 0.7 are applied as fractions.
+ */
+#define CUBIC_MAX_OFFSET_MS 60000
+
+/* Integer cube root, bitwise method */
+static uint32_t cubic_root(uint64_t a)
+{
+	uint64_t y = 0;
+	int s;
+
+	for (s = 63; s >= 0; s -= 3) {
+		uint64_t b;
+
+		y <<= 1;
+		b = 3 * y * (y + 1) + 1;
+		if ((a >> s) >= b) {
+			a -= b << s;
+			y++;
+		}
+	}
+
+	return (uint32_t)y;
+}
+
+static void cubic_init(struct tcp *conn)
+{
+	newreno_init(conn);
+
+	memset(&conn->cc_data.cubic, 0, sizeof(conn->cc_data.cubic));
+}
+
+static void cubic_epoch_start(struct tcp *conn, uint32_t now)
+{
+	uint32_t mss = conn_mss(conn);
+
+	conn->cc_data.cubic.epoch_start = now ? now : 1;
+	conn->cc_data.cubic.w_est = conn->cwnd;
+
+	if (conn->cwnd < conn->cc_data.cubic.w_max) {
+		/* K = cbrt((W_max - cwnd) / C), in segments and seconds */
+		conn->cc_data.cubic.k = cubic_root(
+			(uint64_t)(conn->cc_data.cubic.w_max - conn->cwnd) *
+			2500000000ULL / mss);
+	} else {
+		conn->cc_data.cubic.k = 0;
+		conn->cc_data.cubic.w_max = conn->cwnd;
+	}
+}
+
+static void cubic_acked(struct tcp *conn, uint32_t len_acked)
+{
+	uint32_t mss = conn_mss(conn);
+	uint32_t now = k_uptime_get_32();
+	int64_t offs, target;
+
+	if (tcp_cc_slow_start(conn, len_acked)) {
+		return;
+	}
+
+	if (!conn->cc_data.cubic.epoch_start) {
+		cubic_epoch_start(conn, now);
+	}
+
+	/* W_cubic(t + RTT) = C * (t + RTT - K)^3 + W_max */
+	offs = (int64_t)(now - conn->cc_data.cubic.epoch_start) +
+		(conn->srtt >> 3) - conn->cc_data.cubic.k;
+	offs = CLAMP(offs, -CUBIC_MAX_OFFSET_MS, CUBIC_MAX_OFFSET_MS);
+
+	target = (int64_t)conn->cc_data.cubic.w_max +
+		4 * (offs * offs * offs / 1000) * mss / 10000000LL;
+
+	/* TCP friendly region, W_est grows by 3 * (1 - beta) / (1 + beta)
+	 * segments per round trip.
+	 */
+	conn->cc_data.cubic.w_est += (uint64_t)9 * mss * len_acked /
+		(17ULL * conn->cwnd);
+
+	target = MAX(target, (int64_t)conn->cc_data.cubic.w_est);
+
+	if (target > conn->cwnd) {
+		conn->cwnd += MIN((uint64_t)(target - conn->cwnd) * len_acked /
+				  conn->cwnd, len_acked);
+	}
+}
+
+static uint32_t cubic_loss(struct tcp *conn)
+{
+	uint32_t cwnd = conn->cwnd;
+
+	conn->cc_data.cubic.epoch_start = 0;
+
+	/* Fast convergence, release bandwidth to new flows */
+	if (cwnd < conn->cc_data.cubic.w_last_max) {
+		conn->cc_data.cubic.w_max = (uint64_t)cwnd * 17 / 20;
+	} else {
+		conn->cc_data.cubic.w_max = cwnd;
+	}
+
+	conn->cc_data.cubic.w_last_max = cwnd;
+
+	NET_DBG("conn: %p W_max=%u", conn, conn->cc_data.cubic.w_max);
+
+	return MAX((uint32_t)((uint64_t)cwnd * 7 / 10), 2U * conn_mss(conn));
+}
+
+const struct tcp_cc_ops tcp_cc_cubic = {
+	.name = "cubic",
+	.init = cubic_init,
+	.acked = cubic_acked,
+	.loss = cubic_loss,
+};
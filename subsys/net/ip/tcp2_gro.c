@@ -0,0 +1,317 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
+
+#include <zephyr.h>
+#include <sys/byteorder.h>
+#include <net/net_pkt.h>
+#include <net/net_context.h>
+#include "net_private.h"
+#include "connection.h"
+#include "tcp_internal.h"
+
+/* Software receive offload. While an RX thread processes a burst of
+ * packets, in-order data segments of the same flow are chained into the
+ * first one of them instead of going through connection lookup, the
+ * TCP state machine, an ACK and a socket wakeup each. The merged
+ * segment is delivered when a segment that cannot be merged arrives
+ * for the flow, when one carries PSH, or at the end of the burst, so
+ * nothing is ever held back longer than the burst it arrived in.
+ */
+
+#define GRO_MAX_LEN UINT16_MAX
+#define TCP_MAX_HDR_LEN 60
+
+struct gro_flow {
+	struct net_pkt *pkt;
+	uint32_t seq;
+	uint32_t next_seq;
+	uint16_t src_port;
+	uint16_t dst_port;
+	uint16_t segs;
+	uint8_t hdr_len;
+	uint8_t tcp_len;
+	union {
+		struct in6_addr in6;
+		struct in_addr in;
+	} src, dst;
+};
+
+struct gro_ctx {
+	k_tid_t owner;
+	bool flushing;
+	struct gro_flow flows[CONFIG_NET_TCP_GRO_FLOWS];
+};
+
+/* One context per RX thread, claimed for the duration of a burst */
+static struct gro_ctx gro_ctxs[NET_TC_RX_COUNT];
+static struct k_spinlock gro_lock;
+
+static struct gro_ctx *gro_ctx_get(void)
+{
+	k_tid_t current = k_current_get();
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(gro_ctxs); i++) {
+		if (gro_ctxs[i].owner == current) {
+			return &gro_ctxs[i];
+		}
+	}
+
+	return NULL;
+}
+
+static bool gro_flow_match(struct gro_flow *flow, struct net_pkt *pkt,
+			   union net_ip_header *ip_hdr,
+			   struct net_tcp_hdr *tcp_hdr)
+{
+	if (flow->src_port != tcp_hdr->src_port ||
+	    flow->dst_port != tcp_hdr->dst_port ||
+	    net_pkt_family(flow->pkt) != net_pkt_family(pkt)) {
+		return false;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && net_pkt_family(pkt) == AF_INET6) {
+		return net_ipv6_addr_cmp(&flow->src.in6, &ip_hdr->ipv6->src) &&
+			net_ipv6_addr_cmp(&flow->dst.in6, &ip_hdr->ipv6->dst);
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
+		return net_ipv4_addr_cmp(&flow->src.in, &ip_hdr->ipv4->src) &&
+			net_ipv4_addr_cmp(&flow->dst.in, &ip_hdr->ipv4->dst);
+	}
+
+	return false;
+}
+
+static void gro_flow_hold(struct gro_flow *flow, struct net_pkt *pkt,
+			  union net_ip_header *ip_hdr,
+			  struct net_tcp_hdr *tcp_hdr, uint8_t hdr_len,
+			  uint8_t tcp_len, uint32_t seq, size_t len)
+{
+	flow->pkt = pkt;
+	flow->seq = seq;
+	flow->next_seq = seq + len;
+	flow->src_port = tcp_hdr->src_port;
+	flow->dst_port = tcp_hdr->dst_port;
+	flow->segs = 1U;
+	flow->hdr_len = hdr_len;
+	flow->tcp_len = tcp_len;
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && net_pkt_family(pkt) == AF_INET6) {
+		net_ipaddr_copy(&flow->src.in6, &ip_hdr->ipv6->src);
+		net_ipaddr_copy(&flow->dst.in6, &ip_hdr->ipv6->dst);
+	} else if (IS_ENABLED(CONFIG_NET_IPV4)) {
+		net_ipaddr_copy(&flow->src.in, &ip_hdr->ipv4->src);
+		net_ipaddr_copy(&flow->dst.in, &ip_hdr->ipv4->dst);
+	}
+}
+
+/* Append the payload of pkt to the held segment. The merged segment
+ * keeps its sequence number and takes the rest of the TCP header
+ * (ACK, window, flags and options) from the newest segment.
+ */
+static int gro_flow_merge(struct gro_flow *flow, struct net_pkt *pkt,
+			  size_t len)
+{
+	uint8_t th[TCP_MAX_HDR_LEN];
+	struct net_pkt *held = flow->pkt;
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+	if (net_pkt_skip(pkt, flow->hdr_len) ||
+	    net_pkt_read(pkt, th, flow->tcp_len)) {
+		return -EINVAL;
+	}
+
+	sys_put_be32(flow->seq, ((struct net_tcp_hdr *)th)->seq);
+
+	/* Both segments must be left intact if the merge cannot be done */
+	net_pkt_cursor_init(held);
+	net_pkt_set_overwrite(held, true);
+
+	if (net_pkt_skip(held, flow->hdr_len) ||
+	    net_pkt_remaining_data(held) < flow->tcp_len) {
+		return -EINVAL;
+	}
+
+	net_pkt_cursor_init(pkt);
+	if (net_pkt_pull(pkt, flow->hdr_len + flow->tcp_len)) {
+		return -EINVAL;
+	}
+
+	(void)net_pkt_write(held, th, flow->tcp_len);
+
+	net_pkt_append_buffer(held, pkt->buffer);
+	pkt->buffer = NULL;
+	net_pkt_unref(pkt);
+
+	flow->next_seq += len;
+	flow->segs++;
+
+	return 0;
+}
+
+/* Fix the IP length of a merged segment and pass it to the connection
+ * handlers, as the IP layer would have done.
+ */
+static void gro_deliver(struct net_pkt *pkt, uint8_t hdr_len, bool merged)
+{
+	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct net_tcp_hdr);
+	union net_proto_header proto_hdr;
+	union net_ip_header ip_hdr;
+	size_t len = net_pkt_get_len(pkt);
+
+	/* The IP header stays in the first buffer, see the IP input */
+	ip_hdr.ipv6 = (struct net_ipv6_hdr *)pkt->buffer->data;
+
+	if (merged) {
+		if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		    net_pkt_family(pkt) == AF_INET6) {
+			ip_hdr.ipv6->len =
+				htons(len - sizeof(struct net_ipv6_hdr));
+		} else if (IS_ENABLED(CONFIG_NET_IPV4)) {
+			ip_hdr.ipv4->len = htons(len);
+			ip_hdr.ipv4->chksum = 0U;
+			ip_hdr.ipv4->chksum = net_calc_chksum_ipv4(pkt);
+		}
+	}
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+	if (net_pkt_skip(pkt, hdr_len)) {
+		goto drop;
+	}
+
+	proto_hdr.tcp = (struct net_tcp_hdr *)net_pkt_get_data(pkt,
+							       &tcp_access);
+	if (!proto_hdr.tcp || net_pkt_acknowledge_data(pkt, &tcp_access)) {
+		goto drop;
+	}
+
+	if (net_conn_input(pkt, &ip_hdr, IPPROTO_TCP, &proto_hdr) !=
+	    NET_DROP) {
+		return;
+	}
+
+drop:
+	net_pkt_unref(pkt);
+}
+
+static void gro_flow_flush(struct gro_ctx *ctx, struct gro_flow *flow)
+{
+	struct net_pkt *pkt = flow->pkt;
+
+	flow->pkt = NULL;
+
+	NET_DBG("pkt %p seq %u segs %u", pkt, flow->seq, flow->segs);
+
+	ctx->flushing = true;
+	gro_deliver(pkt, flow->hdr_len, flow->segs > 1U);
+	ctx->flushing = false;
+}
+
+bool net_tcp_gro_receive(struct net_pkt *pkt, union net_ip_header *ip_hdr,
+			 union net_proto_header *proto_hdr)
+{
+	struct gro_ctx *ctx = gro_ctx_get();
+	struct net_tcp_hdr *tcp_hdr = proto_hdr->tcp;
+	struct gro_flow *flow = NULL;
+	struct gro_flow *free_flow = NULL;
+	uint8_t hdr_len, tcp_len;
+	bool mergeable;
+	uint32_t seq;
+	int len, i;
+
+	if (ctx == NULL || ctx->flushing) {
+		return false;
+	}
+
+	hdr_len = net_pkt_ip_hdr_len(pkt) + net_pkt_ip_opts_len(pkt);
+	tcp_len = (tcp_hdr->offset >> 4) * 4U;
+	len = net_pkt_get_len(pkt) - hdr_len - tcp_len;
+	seq = sys_get_be32(tcp_hdr->seq);
+
+	/* Only plain data segments are coalesced */
+	mergeable = (tcp_hdr->flags & ~PSH) == ACK && len > 0 &&
+		tcp_len >= NET_TCPH_LEN && tcp_len <= TCP_MAX_HDR_LEN &&
+		net_pkt_is_contiguous(pkt, hdr_len);
+
+	for (i = 0; i < ARRAY_SIZE(ctx->flows); i++) {
+		if (ctx->flows[i].pkt == NULL) {
+			free_flow = &ctx->flows[i];
+		} else if (gro_flow_match(&ctx->flows[i], pkt, ip_hdr,
+					  tcp_hdr)) {
+			flow = &ctx->flows[i];
+			break;
+		}
+	}
+
+	if (flow) {
+		if (mergeable && seq == flow->next_seq &&
+		    hdr_len == flow->hdr_len && tcp_len == flow->tcp_len &&
+		    net_pkt_get_len(flow->pkt) + len <= GRO_MAX_LEN &&
+		    gro_flow_merge(flow, pkt, len) == 0) {
+			if (tcp_hdr->flags & PSH) {
+				gro_flow_flush(ctx, flow);
+			}
+
+			return true;
+		}
+
+		/* Deliver what was held first to keep the flow in order */
+		gro_flow_flush(ctx, flow);
+
+		return false;
+	}
+
+	/* Nothing to wait for if the sender pushes already */
+	if (!mergeable || (tcp_hdr->flags & PSH) || free_flow == NULL) {
+		return false;
+	}
+
+	gro_flow_hold(free_flow, pkt, ip_hdr, tcp_hdr, hdr_len, tcp_len,
+		      seq, len);
+
+	return true;
+}
+
+void net_tcp_gro_begin(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&gro_lock);
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(gro_ctxs); i++) {
+		if (gro_ctxs[i].owner == NULL) {
+			gro_ctxs[i].owner = k_current_get();
+			break;
+		}
+	}
+
+	k_spin_unlock(&gro_lock, key);
+}
+
+void net_tcp_gro_end(void)
+{
+	struct gro_ctx *ctx = gro_ctx_get();
+	int i;
+
+	if (ctx == NULL) {
+		return;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(ctx->flows); i++) {
+		if (ctx->flows[i].pkt != NULL) {
+			gro_flow_flush(ctx, &ctx->flows[i]);
+		}
+	}
+
+	ctx->owner = NULL;
+}
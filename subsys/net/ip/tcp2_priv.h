@@ -141,6 +141,10 @@
 #define TCPOPT_NOP	1
 #define TCPOPT_MAXSEG	2
 #define TCPOPT_WINDOW	3
+#define TCPOPT_SACK_PERM	4
+#define TCPOPT_SACK	5
+
+#define TCP_SACK_MAX_BLOCKS	4
 
 enum pkt_addr {
 	TCP_EP_SRC = 1,
@@ -202,15 +206,65 @@ union tcp_endpoint {
 	struct sockaddr_in6 sin6;
 };
 
+struct tcp_sack_block {
+	uint32_t left;
+	uint32_t right;
+};
+
 struct tcp_options {
 	uint16_t mss;
 	uint16_t window;
 	bool mss_found : 1;
 	bool wnd_found : 1;
+#if defined(CONFIG_NET_TCP_SACK)
+	bool sack_perm : 1;
+	uint8_t sack_cnt; /* SACK blocks in the last received segment */
+	struct tcp_sack_block sack[TCP_SACK_MAX_BLOCKS];
+#endif
+};
+
+struct tcp;
+
+/* Congestion control algorithm. The generic code in tcp2.c takes care
+ * of duplicate ACK counting, fast retransmit and fast recovery, the
+ * algorithm only decides how the congestion window grows and how much
+ * it shrinks on a loss.
+ */
+struct tcp_cc_ops {
+	const char *name;
+	/* Initialize cwnd, ssthresh and private state */
+	void (*init)(struct tcp *conn);
+	/* New data was acknowledged outside of fast recovery */
+	void (*acked)(struct tcp *conn, uint32_t len_acked);
+	/* A loss was detected, returns the new slow start threshold */
+	uint32_t (*loss)(struct tcp *conn);
+};
+
+extern const struct tcp_cc_ops tcp_cc_newreno;
+extern const struct tcp_cc_ops tcp_cc_cubic;
+
+/* Congestion control and RTT state of a connection, see
+ * net_tcp_get_cc_info()
+ */
+struct tcp_cc_info {
+	const char *algo;
+	uint32_t cwnd;
+	uint32_t ssthresh;
+	uint32_t srtt;   /* ms */
+	uint32_t rttvar; /* ms */
+	uint32_t rto;    /* ms */
+	uint32_t fast_rexmits;
+	bool in_recovery;
+};
+
+struct tcp_conn_bucket {
+	sys_slist_t conns;
+	struct k_spinlock lock;
 };
 
 struct tcp { /* TCP connection */
-	sys_snode_t next;
+	sys_snode_t hash_next;
+	struct tcp_conn_bucket *bucket; /* NULL once freed */
 	struct net_context *context;
 	struct net_pkt *send_data;
 	struct net_pkt *queue_recv_data;
@@ -253,6 +307,30 @@ struct tcp { /* TCP connection */
 	bool in_retransmission : 1;
 	bool in_connect : 1;
 	bool in_close : 1;
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	const struct tcp_cc_ops *cc;
+	union {
+		struct {
+			uint32_t w_max;
+			uint32_t w_last_max;
+			uint32_t w_est;
+			uint32_t k;           /* ms */
+			uint32_t epoch_start; /* ms, 0 if no epoch */
+		} cubic;
+	} cc_data;
+	uint32_t cwnd;
+	uint32_t ssthresh;
+	uint32_t recover;  /* highest seq sent when recovery started */
+	uint32_t rtt_seq;  /* ACK of this seq gives the RTT sample */
+	uint32_t rtt_start;
+	uint32_t srtt;     /* ms, scaled by 8 */
+	uint32_t rttvar;   /* ms, scaled by 4 */
+	uint32_t rto;      /* ms */
+	uint32_t fast_rexmits;
+	uint8_t dup_acks;
+	bool in_recovery : 1;
+	bool rtt_pending : 1;
+#endif
 };
 
 #define _flags(_fl, _op, _mask, _cond)					\
@@ -84,6 +84,78 @@ static inline void net_tcp_foreach(net_tcp_cb_t cb, void *user_data)
 }
 #endif
 
+/**
+ * @brief Get the congestion control and round trip time state of
+ * a TCP connection.
+ *
+ * @param conn TCP connection
+ * @param info Filled with the current state
+ *
+ * @return 0 if successful, < 0 on error
+ */
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+int net_tcp_get_cc_info(struct tcp *conn, struct tcp_cc_info *info);
+#else
+static inline int net_tcp_get_cc_info(struct tcp *conn,
+				      struct tcp_cc_info *info)
+{
+	ARG_UNUSED(conn);
+	ARG_UNUSED(info);
+
+	return -ENOTSUP;
+}
+#endif
+
+/**
+ * @brief Start coalescing received TCP segments for an RX burst
+ * processed by the calling thread.
+ */
+#if defined(CONFIG_NET_TCP_GRO)
+void net_tcp_gro_begin(void);
+#else
+static inline void net_tcp_gro_begin(void)
+{
+}
+#endif
+
+/**
+ * @brief Deliver all the segments held for the RX burst of the calling
+ * thread and stop coalescing.
+ */
+#if defined(CONFIG_NET_TCP_GRO)
+void net_tcp_gro_end(void);
+#else
+static inline void net_tcp_gro_end(void)
+{
+}
+#endif
+
+/**
+ * @brief Offer a received TCP segment for coalescing.
+ *
+ * @param pkt Received segment, its checksum already verified
+ * @param ip_hdr IP header of the segment
+ * @param proto_hdr TCP header of the segment
+ *
+ * @return true if the segment was consumed, false if it is to be
+ * delivered to its connection as usual
+ */
+#if defined(CONFIG_NET_TCP_GRO)
+bool net_tcp_gro_receive(struct net_pkt *pkt, union net_ip_header *ip_hdr,
+			 union net_proto_header *proto_hdr);
+#else
+static inline bool net_tcp_gro_receive(struct net_pkt *pkt,
+				       union net_ip_header *ip_hdr,
+				       union net_proto_header *proto_hdr)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(ip_hdr);
+	ARG_UNUSED(proto_hdr);
+
+	return false;
+}
+#endif
+
 /**
  * @brief Initialize TCP parts of a context
  *
@@ -117,6 +117,69 @@ static void zsock_received_cb(struct net_context *ctx,
 			      int status,
 			      void *user_data);
 
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+/* Called with the epoll lock held, so only lock-free checks here */
+static uint32_t sock_epoll_poll(void *obj)
+{
+	struct net_context *ctx = obj;
+	/* For now, assume that socket is always writable */
+	uint32_t events = ZSOCK_EPOLLOUT;
+
+	/* recv_q and accept_q are in union */
+	if (!k_fifo_is_empty(&ctx->recv_q) || sock_is_eof(ctx)) {
+		events |= ZSOCK_EPOLLIN;
+	}
+
+	if (sock_is_eof(ctx)) {
+		events |= ZSOCK_EPOLLHUP;
+	}
+
+	if (sock_is_error(ctx)) {
+		events |= ZSOCK_EPOLLERR;
+	}
+
+	return events;
+}
+
+/* Called when the send window of a stream socket opens again */
+static void sock_epoll_writable_cb(struct net_context *ctx)
+{
+	zsock_epoll_notify(&ctx->epoll_items, ZSOCK_EPOLLOUT);
+}
+
+static inline void sock_epoll_init(struct net_context *ctx)
+{
+	sys_slist_init(&ctx->epoll_items);
+	ctx->writable_cb = sock_epoll_writable_cb;
+}
+
+static inline void sock_epoll_notify(struct net_context *ctx, uint32_t events)
+{
+	zsock_epoll_notify(&ctx->epoll_items, events);
+}
+
+static inline void sock_epoll_detach(struct net_context *ctx)
+{
+	zsock_epoll_detach(&ctx->epoll_items);
+}
+#else
+static inline void sock_epoll_init(struct net_context *ctx)
+{
+	ARG_UNUSED(ctx);
+}
+
+static inline void sock_epoll_notify(struct net_context *ctx, uint32_t events)
+{
+	ARG_UNUSED(ctx);
+	ARG_UNUSED(events);
+}
+
+static inline void sock_epoll_detach(struct net_context *ctx)
+{
+	ARG_UNUSED(ctx);
+}
+#endif /* CONFIG_NET_SOCKETS_EPOLL */
+
 static int fifo_wait_non_empty(struct k_fifo *fifo, k_timeout_t timeout)
 {
 	struct k_poll_event events[] = {
@@ -188,6 +251,8 @@ int zsock_socket_internal(int family, int type, int proto)
 	 */
 	k_condvar_init(&ctx->cond.recv);
 
+	sock_epoll_init(ctx);
+
 	/* TCP context is effectively owned by both application
 	 * and the stack: stack may detect that peer closed/aborted
 	 * connection, but it must not dispose of the context behind
@@ -244,6 +309,9 @@ static inline int z_vrfy_zsock_socket(int family, int type, int proto)
 
 int zsock_close_ctx(struct net_context *ctx)
 {
+	/* A closed socket is dropped from all epoll instances */
+	sock_epoll_detach(ctx);
+
 	/* Reset callbacks to avoid any race conditions while
 	 * flushing queues. No need to check return values here,
 	 * as these are fail-free operations and we're closing
@@ -331,8 +399,10 @@ static void zsock_accepted_cb(struct net_context *new_ctx,
 				       NULL);
 		k_fifo_init(&new_ctx->recv_q);
 		k_condvar_init(&new_ctx->cond.recv);
+		sock_epoll_init(new_ctx);
 
 		k_fifo_put(&parent->accept_q, new_ctx);
+		sock_epoll_notify(parent, ZSOCK_EPOLLIN);
 	}
 }
 
@@ -343,6 +413,8 @@ static void zsock_received_cb(struct net_context *ctx,
 			      int status,
 			      void *user_data)
 {
+	uint32_t events = ZSOCK_EPOLLIN;
+
 	if (ctx->cond.lock) {
 		(void)k_mutex_lock(ctx->cond.lock, K_FOREVER);
 	}
@@ -350,10 +422,17 @@ static void zsock_received_cb(struct net_context *ctx,
 	NET_DBG("ctx=%p, pkt=%p, st=%d, user_data=%p", ctx, pkt, status,
 		user_data);
 
+	if (status < 0) {
+		sock_set_error(ctx, true);
+		sock_epoll_notify(ctx, ZSOCK_EPOLLERR);
+	}
+
 	/* if pkt is NULL, EOF */
 	if (!pkt) {
 		struct net_pkt *last_pkt = k_fifo_peek_tail(&ctx->recv_q);
 
+		events |= ZSOCK_EPOLLHUP;
+
 		if (!last_pkt) {
 			/* If there're no packets in the queue, recv() may
 			 * be blocked waiting on it to become non-empty,
@@ -382,6 +461,8 @@ static void zsock_received_cb(struct net_context *ctx,
 	k_fifo_put(&ctx->recv_q, pkt);
 
 unlock:
+	sock_epoll_notify(ctx, events);
+
 	if (ctx->cond.lock) {
 		(void)k_mutex_unlock(ctx->cond.lock);
 	}
@@ -390,6 +471,17 @@ unlock:
 	(void)k_condvar_signal(&ctx->cond.recv);
 }
 
+/* Called when a datagram went out */
+static void zsock_sent_cb(struct net_context *ctx, int status,
+			  void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	if (status >= 0) {
+		sock_epoll_notify(ctx, ZSOCK_EPOLLOUT);
+	}
+}
+
 int zsock_bind_ctx(struct net_context *ctx, const struct sockaddr *addr,
 		   socklen_t addrlen)
 {
@@ -437,12 +529,23 @@ int zsock_connect_ctx(struct net_context *ctx, const struct sockaddr *addr,
 		return 0;
 	}
 #endif
-	SET_ERRNO(net_context_connect(ctx, addr, addrlen, NULL,
-			      K_MSEC(CONFIG_NET_SOCKETS_CONNECT_TIMEOUT),
-			      NULL));
+	int ret;
+
+	ret = net_context_connect(ctx, addr, addrlen, NULL,
+				  K_MSEC(CONFIG_NET_SOCKETS_CONNECT_TIMEOUT),
+				  NULL);
+	sock_set_error(ctx, ret < 0);
+	if (ret < 0) {
+		sock_epoll_notify(ctx, ZSOCK_EPOLLERR);
+		errno = -ret;
+		return -1;
+	}
+
 	SET_ERRNO(net_context_recv(ctx, zsock_received_cb, K_NO_WAIT,
 				   ctx->user_data));
 
+	sock_epoll_notify(ctx, ZSOCK_EPOLLOUT);
+
 	return 0;
 }
 
@@ -617,9 +720,9 @@ static inline int z_vrfy_zsock_accept(int sock, struct sockaddr *addr,
 #define WAIT_BUFS K_MSEC(100)
 #define MAX_WAIT_BUFS K_SECONDS(10)
 
-ssize_t zsock_sendto_ctx(struct net_context *ctx, const void *buf, size_t len,
-			 int flags,
-			 const struct sockaddr *dest_addr, socklen_t addrlen)
+static ssize_t sock_send_ctx(struct net_context *ctx, const void *buf,
+			     size_t len, struct net_buf *frags, int flags,
+			     const struct sockaddr *dest_addr, socklen_t addrlen)
 {
 	k_timeout_t timeout = K_FOREVER;
 	uint64_t buf_timeout = 0;
@@ -643,12 +746,17 @@ ssize_t zsock_sendto_ctx(struct net_context *ctx, const void *buf, size_t len,
 	}
 
 	while (1) {
-		if (dest_addr) {
+		if (frags) {
+			status = net_context_send_buf(ctx, frags, dest_addr,
+						      addrlen, zsock_sent_cb,
+						      timeout, ctx->user_data);
+		} else if (dest_addr) {
 			status = net_context_sendto(ctx, buf, len, dest_addr,
-						    addrlen, NULL, timeout,
-						    ctx->user_data);
+						    addrlen, zsock_sent_cb,
+						    timeout, ctx->user_data);
 		} else {
-			status = net_context_send(ctx, buf, len, NULL, timeout,
+			status = net_context_send(ctx, buf, len,
+						  zsock_sent_cb, timeout,
 						  ctx->user_data);
 		}
 
@@ -688,6 +796,13 @@ ssize_t zsock_sendto_ctx(struct net_context *ctx, const void *buf, size_t len,
 	return status;
 }
 
+ssize_t zsock_sendto_ctx(struct net_context *ctx, const void *buf, size_t len,
+			 int flags,
+			 const struct sockaddr *dest_addr, socklen_t addrlen)
+{
+	return sock_send_ctx(ctx, buf, len, NULL, flags, dest_addr, addrlen);
+}
+
 ssize_t z_impl_zsock_sendto(int sock, const void *buf, size_t len, int flags,
 			   const struct sockaddr *dest_addr, socklen_t addrlen)
 {
@@ -726,7 +841,8 @@ ssize_t zsock_sendmsg_ctx(struct net_context *ctx, const struct msghdr *msg,
 		net_context_get_option(ctx, NET_OPT_SNDTIMEO, &timeout, NULL);
 	}
 
-	status = net_context_sendmsg(ctx, msg, flags, NULL, timeout, NULL);
+	status = net_context_sendmsg(ctx, msg, flags, zsock_sent_cb, timeout,
+				     NULL);
 	if (status < 0) {
 		errno = -status;
 		return -1;
@@ -983,6 +1099,48 @@ static int wait_data(struct net_context *ctx, k_timeout_t *timeout)
 	return 0;
 }
 
+static int sock_get_src_addr(struct net_context *ctx, struct net_pkt *pkt,
+			     struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
+	    net_if_is_ip_offloaded(net_context_get_iface(ctx))) {
+		/*
+		 * Packets from offloaded IP stack do not have IP
+		 * headers, so src address cannot be figured out at this
+		 * point. The best we can do is returning remote address
+		 * if that was set using connect() call.
+		 */
+		if (ctx->flags & NET_CONTEXT_REMOTE_ADDR_SET) {
+			memcpy(src_addr, &ctx->remote,
+			       MIN(*addrlen, sizeof(ctx->remote)));
+		} else {
+			return -ENOTSUP;
+		}
+	} else {
+		int rv;
+
+		rv = sock_get_pkt_src_addr(pkt, net_context_get_ip_proto(ctx),
+					   src_addr, *addrlen);
+		if (rv < 0) {
+			LOG_ERR("sock_get_pkt_src_addr %d", rv);
+			return rv;
+		}
+	}
+
+	/* addrlen is a value-result argument, set to actual
+	 * size of source address
+	 */
+	if (src_addr->sa_family == AF_INET) {
+		*addrlen = sizeof(struct sockaddr_in);
+	} else if (src_addr->sa_family == AF_INET6) {
+		*addrlen = sizeof(struct sockaddr_in6);
+	} else {
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
 static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 				       void *buf,
 				       size_t max_len,
@@ -1033,42 +1191,11 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 	net_pkt_cursor_backup(pkt, &backup);
 
 	if (src_addr && addrlen) {
-		if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
-		    net_if_is_ip_offloaded(net_context_get_iface(ctx))) {
-			/*
-			 * Packets from offloaded IP stack do not have IP
-			 * headers, so src address cannot be figured out at this
-			 * point. The best we can do is returning remote address
-			 * if that was set using connect() call.
-			 */
-			if (ctx->flags & NET_CONTEXT_REMOTE_ADDR_SET) {
-				memcpy(src_addr, &ctx->remote,
-				       MIN(*addrlen, sizeof(ctx->remote)));
-			} else {
-				errno = ENOTSUP;
-				goto fail;
-			}
-		} else {
-			int rv;
-
-			rv = sock_get_pkt_src_addr(pkt, net_context_get_ip_proto(ctx),
-						   src_addr, *addrlen);
-			if (rv < 0) {
-				errno = -rv;
-				LOG_ERR("sock_get_pkt_src_addr %d", rv);
-				goto fail;
-			}
-		}
+		int rv;
 
-		/* addrlen is a value-result argument, set to actual
-		 * size of source address
-		 */
-		if (src_addr->sa_family == AF_INET) {
-			*addrlen = sizeof(struct sockaddr_in);
-		} else if (src_addr->sa_family == AF_INET6) {
-			*addrlen = sizeof(struct sockaddr_in6);
-		} else {
-			errno = ENOTSUP;
+		rv = sock_get_src_addr(ctx, pkt, src_addr, addrlen);
+		if (rv < 0) {
+			errno = -rv;
 			goto fail;
 		}
 	}
@@ -1283,6 +1410,255 @@ ssize_t z_vrfy_zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
 #include <syscalls/zsock_recvfrom_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY)
+/* Detach the unread part of the packet data. Fragments holding only
+ * already consumed data (protocol headers) are released and the
+ * cursor fragment is pulled up to the cursor position, so no payload
+ * byte is moved.
+ */
+static struct net_buf *sock_pkt_take_data(struct net_pkt *pkt)
+{
+	struct net_buf *frags = pkt->buffer;
+	struct net_buf *cur = pkt->cursor.buf;
+
+	pkt->buffer = NULL;
+
+	while (frags && frags != cur) {
+		frags = net_buf_frag_del(NULL, frags);
+	}
+
+	if (!frags) {
+		return NULL;
+	}
+
+	net_buf_pull(frags, pkt->cursor.pos - frags->data);
+	if (!frags->len) {
+		frags = net_buf_frag_del(NULL, frags);
+	}
+
+	return frags;
+}
+
+static ssize_t zsock_recv_buf_dgram(struct net_context *ctx,
+				    struct net_buf **frags, int flags,
+				    struct sockaddr *src_addr,
+				    socklen_t *addrlen)
+{
+	k_timeout_t timeout = K_FOREVER;
+	struct net_pkt *pkt;
+	size_t recv_len;
+	int ret;
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	} else {
+		net_context_get_option(ctx, NET_OPT_RCVTIMEO, &timeout, NULL);
+
+		ret = wait_data(ctx, &timeout);
+		if (ret < 0) {
+			errno = -ret;
+			return -1;
+		}
+	}
+
+	pkt = k_fifo_get(&ctx->recv_q, timeout);
+	if (!pkt) {
+		errno = EAGAIN;
+		return -1;
+	}
+
+	if (src_addr && addrlen) {
+		ret = sock_get_src_addr(ctx, pkt, src_addr, addrlen);
+		if (ret < 0) {
+			net_pkt_unref(pkt);
+			errno = -ret;
+			return -1;
+		}
+	}
+
+	if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS)) {
+		net_socket_update_tc_rx_time(pkt, k_cycle_get_32());
+	}
+
+	recv_len = net_pkt_remaining_data(pkt);
+	*frags = sock_pkt_take_data(pkt);
+	net_pkt_unref(pkt);
+
+	return recv_len;
+}
+
+static ssize_t zsock_recv_buf_stream(struct net_context *ctx,
+				     struct net_buf **frags, int flags)
+{
+	k_timeout_t timeout = K_FOREVER;
+	struct net_pkt *pkt;
+	size_t recv_len;
+	int ret;
+
+	if (net_context_get_state(ctx) != NET_CONTEXT_CONNECTED) {
+		errno = ENOTCONN;
+		return -1;
+	}
+
+	if (sock_is_eof(ctx)) {
+		return 0;
+	}
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	} else {
+		net_context_get_option(ctx, NET_OPT_RCVTIMEO, &timeout, NULL);
+
+		ret = wait_data(ctx, &timeout);
+		if (ret < 0) {
+			errno = -ret;
+			return -1;
+		}
+	}
+
+	pkt = k_fifo_get(&ctx->recv_q, K_NO_WAIT);
+	if (!pkt) {
+		/* Either timeout expired, or wait was cancelled
+		 * due to connection closure by peer.
+		 */
+		if (sock_is_eof(ctx)) {
+			return 0;
+		}
+
+		errno = EAGAIN;
+		return -1;
+	}
+
+	if (net_pkt_eof(pkt)) {
+		sock_set_eof(ctx);
+	}
+
+	if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS)) {
+		net_socket_update_tc_rx_time(pkt, k_cycle_get_32());
+	}
+
+	recv_len = net_pkt_remaining_data(pkt);
+	*frags = sock_pkt_take_data(pkt);
+	net_pkt_unref(pkt);
+
+	net_context_update_recv_wnd(ctx, recv_len);
+
+	return recv_len;
+}
+
+static ssize_t zsock_recv_buf_ctx(struct net_context *ctx,
+				  struct net_buf **frags, int flags,
+				  struct sockaddr *src_addr,
+				  socklen_t *addrlen)
+{
+	enum net_sock_type sock_type = net_context_get_type(ctx);
+
+	*frags = NULL;
+
+	if (flags & ZSOCK_MSG_PEEK) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
+	    net_if_is_ip_offloaded(net_context_get_iface(ctx))) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	if (sock_type == SOCK_DGRAM &&
+	    net_context_get_ip_proto(ctx) == IPPROTO_UDP) {
+		return zsock_recv_buf_dgram(ctx, frags, flags, src_addr,
+					    addrlen);
+	} else if (sock_type == SOCK_STREAM) {
+		return zsock_recv_buf_stream(ctx, frags, flags);
+	}
+
+	errno = EOPNOTSUPP;
+	return -1;
+}
+
+/* The zero-copy calls hand out kernel buffers, so they are restricted
+ * to supervisor threads and to native sockets (no TLS, offloaded or
+ * other socket implementations behind the fd).
+ */
+static struct net_context *sock_zerocopy_ctx(int sock, struct k_mutex **lock)
+{
+	const struct socket_op_vtable *vtable;
+	struct net_context *ctx;
+
+	if (k_is_user_context()) {
+		errno = EPERM;
+		return NULL;
+	}
+
+	ctx = get_sock_vtable(sock, &vtable, lock);
+	if (ctx == NULL) {
+		errno = EBADF;
+		return NULL;
+	}
+
+	if (vtable != &sock_fd_op_vtable) {
+		errno = EOPNOTSUPP;
+		return NULL;
+	}
+
+	return ctx;
+}
+
+ssize_t zsock_recv_buf(int sock, struct net_buf **frags, int flags,
+		       struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	struct net_context *ctx;
+	struct k_mutex *lock;
+	ssize_t ret;
+
+	if (frags == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	ctx = sock_zerocopy_ctx(sock, &lock);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	ret = zsock_recv_buf_ctx(ctx, frags, flags, src_addr, addrlen);
+
+	k_mutex_unlock(lock);
+
+	return ret;
+}
+
+ssize_t zsock_send_buf(int sock, struct net_buf *frags, int flags,
+		       const struct sockaddr *dest_addr, socklen_t addrlen)
+{
+	struct net_context *ctx;
+	struct k_mutex *lock;
+	ssize_t ret;
+
+	if (frags == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	ctx = sock_zerocopy_ctx(sock, &lock);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	ret = sock_send_ctx(ctx, NULL, 0, frags, flags, dest_addr, addrlen);
+
+	k_mutex_unlock(lock);
+
+	return ret;
+}
+#endif /* CONFIG_NET_SOCKETS_ZEROCOPY */
+
 /* As this is limited function, we don't follow POSIX signature, with
  * "..." instead of last arg.
  */
@@ -2117,6 +2493,20 @@ static int sock_ioctl_vmeth(void *obj, unsigned int request, va_list args)
 		return 0;
 	}
 
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+	case ZFD_IOCTL_EPOLL_WATCH: {
+		struct zsock_epoll_item *item;
+		struct net_context *ctx = obj;
+
+		item = va_arg(args, struct zsock_epoll_item *);
+
+		item->obj = ctx;
+		item->poll = sock_epoll_poll;
+		item->watchers = &ctx->epoll_items;
+		return 0;
+	}
+#endif
+
 	default:
 		errno = EOPNOTSUPP;
 		return -1;
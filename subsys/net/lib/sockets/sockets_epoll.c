@@ -0,0 +1,535 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* epoll() style event notification for sockets.
+ *
+ * Each epoll instance keeps one entry per watched file descriptor,
+ * indexed by the descriptor number. A watched socket links the entries
+ * into its own watchers list and the socket receive callbacks move the
+ * entries to the ready list of the instance, so zsock_epoll_wait() only
+ * looks at the sockets which got events instead of the whole set.
+ * Level triggered entries are queued again after being reported and
+ * dropped on the next wait once they are no longer ready.
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_sock_epoll, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <kernel.h>
+#include <sys/fdtable.h>
+#include <net/socket.h>
+#include <syscall_handler.h>
+#include <sys/math_extras.h>
+
+#include "sockets_internal.h"
+
+/* Events which are reported even if not requested */
+#define EPOLL_ALWAYS (ZSOCK_EPOLLERR | ZSOCK_EPOLLHUP)
+
+/* Flags which are not events */
+#define EPOLL_FLAGS (ZSOCK_EPOLLET | ZSOCK_EPOLLONESHOT)
+
+struct zsock_epoll {
+	struct zsock_epoll_item items[CONFIG_POSIX_MAX_FDS];
+	sys_dlist_t ready;
+	struct k_condvar ready_cond;
+	bool used;
+};
+
+static struct zsock_epoll epoll_instances[CONFIG_NET_SOCKETS_EPOLL_MAX];
+
+/* Protects all instances, their entries and the watchers lists of the
+ * sockets. Socket receive callbacks take it with the socket lock held,
+ * so it must never be held while taking a socket lock.
+ */
+static K_MUTEX_DEFINE(epoll_lock);
+
+static const struct fd_op_vtable epoll_fd_op_vtable;
+
+static void epoll_item_queue(struct zsock_epoll_item *item)
+{
+	if (!item->ready) {
+		sys_dlist_append(&item->ep->ready, &item->ready_node);
+		item->ready = true;
+	}
+
+	(void)k_condvar_signal(&item->ep->ready_cond);
+}
+
+static void epoll_item_release(struct zsock_epoll_item *item)
+{
+	if (item->ready) {
+		sys_dlist_remove(&item->ready_node);
+		item->ready = false;
+	}
+
+	(void)sys_slist_find_and_remove(item->watchers, &item->watch_node);
+
+	item->watchers = NULL;
+	item->obj = NULL;
+	item->poll = NULL;
+}
+
+/* Queue the entry if it is already ready when (re)armed */
+static void epoll_item_arm(struct zsock_epoll_item *item)
+{
+	if (item->poll(item->obj) & (item->event.events | EPOLL_ALWAYS)) {
+		epoll_item_queue(item);
+	}
+}
+
+void zsock_epoll_notify(sys_slist_t *watchers, uint32_t events)
+{
+	struct zsock_epoll_item *item;
+
+	/* Cheap check for the common case of an unwatched socket, a
+	 * concurrently added entry checks the socket state when armed.
+	 */
+	if (sys_slist_is_empty(watchers)) {
+		return;
+	}
+
+	(void)k_mutex_lock(&epoll_lock, K_FOREVER);
+
+	SYS_SLIST_FOR_EACH_CONTAINER(watchers, item, watch_node) {
+		if (item->event.events & (events | EPOLL_ALWAYS)) {
+			epoll_item_queue(item);
+		}
+	}
+
+	k_mutex_unlock(&epoll_lock);
+}
+
+void zsock_epoll_detach(sys_slist_t *watchers)
+{
+	sys_snode_t *node;
+
+	(void)k_mutex_lock(&epoll_lock, K_FOREVER);
+
+	while ((node = sys_slist_peek_head(watchers)) != NULL) {
+		epoll_item_release(CONTAINER_OF(node, struct zsock_epoll_item,
+						watch_node));
+	}
+
+	k_mutex_unlock(&epoll_lock);
+}
+
+int z_impl_zsock_epoll_create1(int flags)
+{
+	struct zsock_epoll *ep = NULL;
+	int fd, i;
+
+	if (flags != 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	fd = z_reserve_fd();
+	if (fd < 0) {
+		return -1;
+	}
+
+	(void)k_mutex_lock(&epoll_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(epoll_instances); i++) {
+		if (!epoll_instances[i].used) {
+			ep = &epoll_instances[i];
+			break;
+		}
+	}
+
+	if (ep == NULL) {
+		k_mutex_unlock(&epoll_lock);
+		z_free_fd(fd);
+		errno = ENOMEM;
+		return -1;
+	}
+
+	memset(ep, 0, sizeof(*ep));
+	sys_dlist_init(&ep->ready);
+	k_condvar_init(&ep->ready_cond);
+
+	for (i = 0; i < ARRAY_SIZE(ep->items); i++) {
+		ep->items[i].ep = ep;
+	}
+
+	ep->used = true;
+
+	k_mutex_unlock(&epoll_lock);
+
+	z_finalize_fd(fd, ep, &epoll_fd_op_vtable);
+
+	NET_DBG("epoll: ep=%p, fd=%d", ep, fd);
+
+	return fd;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_epoll_create1(int flags)
+{
+	return z_impl_zsock_epoll_create1(flags);
+}
+#include <syscalls/zsock_epoll_create1_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+static int epoll_ctl_add(struct zsock_epoll_item *item, int fd,
+			 const struct zsock_epoll_event *event)
+{
+	const struct fd_op_vtable *vtable;
+	struct k_mutex *lock;
+	void *obj;
+	int ret;
+
+	obj = z_get_fd_obj_and_vtable(fd, &vtable, &lock);
+	if (obj == NULL) {
+		return -EBADF;
+	}
+
+	/* Socket lock first, see epoll_lock */
+	(void)k_mutex_lock(lock, K_FOREVER);
+	(void)k_mutex_lock(&epoll_lock, K_FOREVER);
+
+	if (item->watchers != NULL) {
+		ret = -EEXIST;
+		goto out;
+	}
+
+	ret = z_fdtable_call_ioctl(vtable, obj, ZFD_IOCTL_EPOLL_WATCH, item);
+	if (ret < 0 || item->watchers == NULL) {
+		/* The descriptor does not support epoll */
+		item->watchers = NULL;
+		ret = -EPERM;
+		goto out;
+	}
+
+	item->event = *event;
+	sys_slist_append(item->watchers, &item->watch_node);
+
+	epoll_item_arm(item);
+
+out:
+	k_mutex_unlock(&epoll_lock);
+	k_mutex_unlock(lock);
+
+	return ret;
+}
+
+int z_impl_zsock_epoll_ctl(int epfd, int op, int fd,
+			   struct zsock_epoll_event *event)
+{
+	struct zsock_epoll_item *item;
+	struct zsock_epoll *ep;
+	int ret = 0;
+
+	ep = z_get_fd_obj(epfd, &epoll_fd_op_vtable, EINVAL);
+	if (ep == NULL) {
+		return -1;
+	}
+
+	if (fd < 0 || fd >= ARRAY_SIZE(ep->items)) {
+		errno = EBADF;
+		return -1;
+	}
+
+	if (fd == epfd) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (op != ZSOCK_EPOLL_CTL_DEL && event == NULL) {
+		errno = EFAULT;
+		return -1;
+	}
+
+	item = &ep->items[fd];
+
+	switch (op) {
+	case ZSOCK_EPOLL_CTL_ADD:
+		ret = epoll_ctl_add(item, fd, event);
+		break;
+
+	case ZSOCK_EPOLL_CTL_MOD:
+		(void)k_mutex_lock(&epoll_lock, K_FOREVER);
+
+		if (item->watchers == NULL) {
+			ret = -ENOENT;
+		} else {
+			item->event = *event;
+			epoll_item_arm(item);
+		}
+
+		k_mutex_unlock(&epoll_lock);
+		break;
+
+	case ZSOCK_EPOLL_CTL_DEL:
+		(void)k_mutex_lock(&epoll_lock, K_FOREVER);
+
+		if (item->watchers == NULL) {
+			ret = -ENOENT;
+		} else {
+			epoll_item_release(item);
+		}
+
+		k_mutex_unlock(&epoll_lock);
+		break;
+
+	default:
+		ret = -EINVAL;
+		break;
+	}
+
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
+	}
+
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_epoll_ctl(int epfd, int op, int fd,
+					 struct zsock_epoll_event *event)
+{
+	struct zsock_epoll_event event_copy;
+
+	if (op != ZSOCK_EPOLL_CTL_DEL) {
+		Z_OOPS(z_user_from_copy(&event_copy, event,
+					sizeof(event_copy)));
+	}
+
+	/* Only sockets the caller has access to can be watched */
+	if (op == ZSOCK_EPOLL_CTL_ADD || op == ZSOCK_EPOLL_CTL_MOD) {
+		const struct fd_op_vtable *vtable;
+		void *obj = z_get_fd_obj_and_vtable(fd, &vtable, NULL);
+
+		Z_OOPS(Z_SYSCALL_OBJ(obj, K_OBJ_NET_SOCKET));
+	}
+
+	return z_impl_zsock_epoll_ctl(epfd, op, fd,
+			op != ZSOCK_EPOLL_CTL_DEL ? &event_copy : NULL);
+}
+#include <syscalls/zsock_epoll_ctl_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+/* Move up to maxevents reported entries from the ready list to events.
+ * Entries that are no longer ready are dropped from the list.
+ */
+static int epoll_collect(struct zsock_epoll *ep,
+			 struct zsock_epoll_event *events, int maxevents)
+{
+	sys_dlist_t requeue;
+	sys_dnode_t *node;
+	int count = 0;
+
+	sys_dlist_init(&requeue);
+
+	while (count < maxevents &&
+	       (node = sys_dlist_get(&ep->ready)) != NULL) {
+		struct zsock_epoll_item *item;
+		uint32_t revents;
+
+		item = CONTAINER_OF(node, struct zsock_epoll_item, ready_node);
+		item->ready = false;
+
+		revents = item->poll(item->obj) &
+			  (item->event.events | EPOLL_ALWAYS) & ~EPOLL_FLAGS;
+		if (!revents) {
+			continue;
+		}
+
+		events[count].events = revents;
+		events[count].data = item->event.data;
+		count++;
+
+		if (item->event.events & ZSOCK_EPOLLONESHOT) {
+			/* Disabled until re-armed with ZSOCK_EPOLL_CTL_MOD */
+			item->event.events &= EPOLL_FLAGS;
+		} else if (!(item->event.events & ZSOCK_EPOLLET)) {
+			sys_dlist_append(&requeue, &item->ready_node);
+			item->ready = true;
+		}
+	}
+
+	/* Level triggered entries go to the tail, so that a busy socket
+	 * cannot starve the others.
+	 */
+	while ((node = sys_dlist_get(&requeue)) != NULL) {
+		sys_dlist_append(&ep->ready, node);
+	}
+
+	return count;
+}
+
+int z_impl_zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+			    int maxevents, int timeout)
+{
+	struct zsock_epoll *ep;
+	k_timeout_t wait;
+	uint64_t end;
+	int count;
+
+	ep = z_get_fd_obj(epfd, &epoll_fd_op_vtable, EINVAL);
+	if (ep == NULL) {
+		return -1;
+	}
+
+	if (maxevents <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (timeout < 0) {
+		wait = K_FOREVER;
+	} else {
+		wait = K_MSEC(timeout);
+	}
+
+	end = sys_clock_timeout_end_calc(wait);
+
+	(void)k_mutex_lock(&epoll_lock, K_FOREVER);
+
+	while (true) {
+		count = epoll_collect(ep, events, maxevents);
+		if (count > 0 || K_TIMEOUT_EQ(wait, K_NO_WAIT)) {
+			break;
+		}
+
+		if (k_condvar_wait(&ep->ready_cond, &epoll_lock, wait) < 0) {
+			/* Timed out, pick up a late notification */
+			count = epoll_collect(ep, events, maxevents);
+			break;
+		}
+
+		if (!ep->used) {
+			/* Closed while waiting */
+			errno = EBADF;
+			count = -1;
+			break;
+		}
+
+		if (!K_TIMEOUT_EQ(wait, K_FOREVER)) {
+			int64_t remaining = end - sys_clock_tick_get();
+
+			if (remaining <= 0) {
+				wait = K_NO_WAIT;
+			} else {
+				wait = Z_TIMEOUT_TICKS(remaining);
+			}
+		}
+	}
+
+	k_mutex_unlock(&epoll_lock);
+
+	return count;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_epoll_wait(int epfd,
+					  struct zsock_epoll_event *events,
+					  int maxevents, int timeout)
+{
+	struct zsock_epoll_event *events_copy;
+	size_t events_size;
+	int ret;
+
+	if (maxevents <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* Do not fault on user memory with the epoll lock held */
+	if (size_mul_overflow(maxevents, sizeof(struct zsock_epoll_event),
+			      &events_size)) {
+		errno = EFAULT;
+		return -1;
+	}
+
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(events, events_size));
+
+	events_copy = z_user_alloc_from_copy((void *)events, events_size);
+	if (!events_copy) {
+		errno = ENOMEM;
+		return -1;
+	}
+
+	ret = z_impl_zsock_epoll_wait(epfd, events_copy, maxevents, timeout);
+	if (ret > 0) {
+		z_user_to_copy((void *)events, events_copy,
+			       ret * sizeof(struct zsock_epoll_event));
+	}
+
+	k_free(events_copy);
+
+	return ret;
+}
+#include <syscalls/zsock_epoll_wait_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+static ssize_t epoll_read_vmeth(void *obj, void *buffer, size_t count)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(buffer);
+	ARG_UNUSED(count);
+
+	errno = EINVAL;
+	return -1;
+}
+
+static ssize_t epoll_write_vmeth(void *obj, const void *buffer, size_t count)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(buffer);
+	ARG_UNUSED(count);
+
+	errno = EINVAL;
+	return -1;
+}
+
+static int epoll_ioctl_vmeth(void *obj, unsigned int request, va_list args)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(args);
+
+	switch (request) {
+	case ZFD_IOCTL_SET_LOCK:
+		/* The instance is protected by the epoll lock */
+		return 0;
+
+	default:
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+}
+
+static int epoll_close_vmeth(void *obj)
+{
+	struct zsock_epoll *ep = obj;
+	int i;
+
+	(void)k_mutex_lock(&epoll_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(ep->items); i++) {
+		if (ep->items[i].watchers != NULL) {
+			epoll_item_release(&ep->items[i]);
+		}
+	}
+
+	/* Wake up any waiter, it fails with EBADF */
+	(void)k_condvar_broadcast(&ep->ready_cond);
+
+	ep->used = false;
+
+	k_mutex_unlock(&epoll_lock);
+
+	return 0;
+}
+
+static const struct fd_op_vtable epoll_fd_op_vtable = {
+	.read = epoll_read_vmeth,
+	.write = epoll_write_vmeth,
+	.close = epoll_close_vmeth,
+	.ioctl = epoll_ioctl_vmeth,
+};
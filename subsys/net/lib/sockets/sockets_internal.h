@@ -11,6 +11,7 @@
 
 #define SOCK_EOF 1
 #define SOCK_NONBLOCK 2
+#define SOCK_ERROR 4
 
 int zsock_close_ctx(struct net_context *ctx);
 int zsock_poll_internal(struct zsock_pollfd *fds, int nfds, k_timeout_t timeout);
@@ -43,9 +44,39 @@ static inline bool net_socket_is_tls(void *obj)
 }
 #endif
 
+/* Entry of an epoll instance. The watched descriptor fills in obj,
+ * poll and watchers from its ZFD_IOCTL_EPOLL_WATCH handler, all other
+ * fields belong to the epoll instance. Entries are protected by the
+ * global epoll lock.
+ */
+struct zsock_epoll_item {
+	/** Node in the watchers list of the descriptor */
+	sys_snode_t watch_node;
+	/** Node in the ready list of the epoll instance */
+	sys_dnode_t ready_node;
+	/** Owning epoll instance */
+	struct zsock_epoll *ep;
+	/** Watchers list of the descriptor, NULL if the entry is free */
+	sys_slist_t *watchers;
+	/** Watched object */
+	void *obj;
+	/** Return the current ZSOCK_EPOLL* events of obj, without locking */
+	uint32_t (*poll)(void *obj);
+	/** Registered events and user data */
+	struct zsock_epoll_event event;
+	/** True while the entry is queued in the ready list */
+	bool ready;
+};
+
+void zsock_epoll_notify(sys_slist_t *watchers, uint32_t events);
+void zsock_epoll_detach(sys_slist_t *watchers);
+
 #define sock_is_eof(ctx) sock_get_flag(ctx, SOCK_EOF)
 #define sock_set_eof(ctx) sock_set_flag(ctx, SOCK_EOF, SOCK_EOF)
 #define sock_is_nonblock(ctx) sock_get_flag(ctx, SOCK_NONBLOCK)
+#define sock_is_error(ctx) sock_get_flag(ctx, SOCK_ERROR)
+#define sock_set_error(ctx, err) \
+	sock_set_flag(ctx, SOCK_ERROR, (err) ? SOCK_ERROR : 0)
 
 struct socket_op_vtable {
 	struct fd_op_vtable fd_vtable;
@@ -27,11 +27,114 @@ K_MUTEX_DEFINE(settings_lock);
 
 void settings_store_init(void);
 
+#if defined(CONFIG_SETTINGS_STATIC_HANDLER_INDEX)
+extern struct settings_handler_index _settings_handler_index_list_start[];
+extern struct settings_handler_index _settings_handler_index_list_end[];
+
+static bool settings_index_sorted;
+
+static void settings_index_sort(void)
+{
+	struct settings_handler_index *start = _settings_handler_index_list_start;
+	struct settings_handler_index *end = _settings_handler_index_list_end;
+	struct settings_handler_index *i, *j;
+	struct settings_handler_index tmp;
+
+	/* Insertion sort, there are few handlers and this is done once */
+	for (i = start + 1; i < end; i++) {
+		tmp = *i;
+		for (j = i; j > start &&
+		     strcmp((j - 1)->handler->name, tmp.handler->name) > 0;
+		     j--) {
+			*j = *(j - 1);
+		}
+		*j = tmp;
+	}
+
+	settings_index_sorted = true;
+}
+
+/* Compare the first len characters of name with a handler name, with the
+ * same order as the strcmp() used for sorting.
+ */
+static int settings_index_cmp(const char *name, size_t len, const char *hname)
+{
+	int rc = strncmp(name, hname, len);
+
+	if ((rc == 0) && (hname[len] != '\0')) {
+		rc = -1;
+	}
+
+	return rc;
+}
+
+static struct settings_handler_static *settings_index_find(const char *name,
+							   size_t len)
+{
+	struct settings_handler_index *lo = _settings_handler_index_list_start;
+	struct settings_handler_index *hi = _settings_handler_index_list_end;
+	struct settings_handler_index *mid;
+	int rc;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		rc = settings_index_cmp(name, len, mid->handler->name);
+		if (rc == 0) {
+			return (struct settings_handler_static *)mid->handler;
+		}
+		if (rc < 0) {
+			hi = mid;
+		} else {
+			lo = mid + 1;
+		}
+	}
+
+	return NULL;
+}
+
+/* Look up the handler with the longest name matching whole components of
+ * name, as settings_name_steq() does.
+ */
+static struct settings_handler_static *settings_index_lookup(const char *name,
+							     const char **next)
+{
+	struct settings_handler_static *ch;
+	size_t len = 0;
+
+	if (!name) {
+		return NULL;
+	}
+
+	while ((name[len] != '\0') && (name[len] != SETTINGS_NAME_END)) {
+		len++;
+	}
+
+	while (1) {
+		ch = settings_index_find(name, len);
+		if (ch) {
+			if (next && (name[len] == SETTINGS_NAME_SEPARATOR)) {
+				*next = name + len + 1;
+			}
+			return ch;
+		}
+
+		while ((len > 0) && (name[--len] != SETTINGS_NAME_SEPARATOR)) {
+		}
+		if (len == 0) {
+			return NULL;
+		}
+	}
+}
+#endif /* CONFIG_SETTINGS_STATIC_HANDLER_INDEX */
+
 void settings_init(void)
 {
 #if defined(CONFIG_SETTINGS_DYNAMIC_HANDLERS)
 	sys_slist_init(&settings_handlers);
 #endif /* CONFIG_SETTINGS_DYNAMIC_HANDLERS */
+#if defined(CONFIG_SETTINGS_STATIC_HANDLER_INDEX)
+	settings_index_sort();
+#endif /* CONFIG_SETTINGS_STATIC_HANDLER_INDEX */
 	settings_store_init();
 }
 
@@ -134,16 +237,19 @@ int settings_name_next(const char *name, const char **next)
 	return rc;
 }
 
-struct settings_handler_static *settings_parse_and_lookup(const char *name,
-							const char **next)
+static struct settings_handler_static *settings_static_lookup(const char *name,
+							      const char **next)
 {
 	struct settings_handler_static *bestmatch;
 	const char *tmpnext;
 
-	bestmatch = NULL;
-	if (next) {
-		*next = NULL;
+#if defined(CONFIG_SETTINGS_STATIC_HANDLER_INDEX)
+	if (settings_index_sorted) {
+		return settings_index_lookup(name, next);
 	}
+#endif /* CONFIG_SETTINGS_STATIC_HANDLER_INDEX */
+
+	bestmatch = NULL;
 
 	STRUCT_SECTION_FOREACH(settings_handler_static, ch) {
 		if (!settings_name_steq(name, ch->name, &tmpnext)) {
@@ -164,8 +270,23 @@ struct settings_handler_static *settings_parse_and_lookup(const char *name,
 		}
 	}
 
+	return bestmatch;
+}
+
+struct settings_handler_static *settings_parse_and_lookup(const char *name,
+							const char **next)
+{
+	struct settings_handler_static *bestmatch;
+
+	if (next) {
+		*next = NULL;
+	}
+
+	bestmatch = settings_static_lookup(name, next);
+
 #if defined(CONFIG_SETTINGS_DYNAMIC_HANDLERS)
 	struct settings_handler *ch;
+	const char *tmpnext;
 
 	SYS_SLIST_FOR_EACH_CONTAINER(&settings_handlers, ch, node) {
 		if (!settings_name_steq(name, ch->name, &tmpnext)) {
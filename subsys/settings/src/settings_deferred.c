@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <kernel.h>
+
+#include "settings/settings.h"
+#include "settings_priv.h"
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(settings, CONFIG_SETTINGS_LOG_LEVEL);
+
+/* Values saved with settings_save_one_deferred() wait in these entries until
+ * the work item or settings_flush() writes them to the backend. Only the last
+ * value saved for an item is kept. A value the backend fails to write stays
+ * pending.
+ */
+struct settings_deferred_entry {
+	bool used;
+	uint8_t val_len;
+	char name[SETTINGS_MAX_NAME_LEN + 1];
+	uint8_t val[CONFIG_SETTINGS_DEFERRED_SAVE_VALUE_MAX];
+};
+
+BUILD_ASSERT(CONFIG_SETTINGS_DEFERRED_SAVE_VALUE_MAX <= UINT8_MAX,
+	     "Deferred values are limited to 255 bytes");
+
+static struct settings_deferred_entry
+	entries[CONFIG_SETTINGS_DEFERRED_SAVE_ENTRIES];
+
+/* Protects the entries. It is taken with settings_lock held, never the other
+ * way around.
+ */
+static K_MUTEX_DEFINE(entries_lock);
+
+/* Entry being written, protected by settings_lock */
+static struct settings_deferred_entry flushing;
+
+extern struct k_mutex settings_lock;
+
+static void settings_deferred_work_handler(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(settings_deferred_work,
+			       settings_deferred_work_handler);
+
+static struct settings_deferred_entry *entry_find(const char *name)
+{
+	for (int i = 0; i < ARRAY_SIZE(entries); i++) {
+		if (entries[i].used && !strcmp(entries[i].name, name)) {
+			return &entries[i];
+		}
+	}
+
+	return NULL;
+}
+
+static struct settings_deferred_entry *entry_alloc(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(entries); i++) {
+		if (!entries[i].used) {
+			return &entries[i];
+		}
+	}
+
+	return NULL;
+}
+
+int settings_save_one_deferred(const char *name, const void *value,
+			       size_t val_len)
+{
+	struct settings_deferred_entry *entry;
+
+	if (!settings_save_dst) {
+		return -ENOENT;
+	}
+
+	if (!value) {
+		val_len = 0;
+	}
+
+	if ((strlen(name) > SETTINGS_MAX_NAME_LEN) ||
+	    (val_len > sizeof(entry->val))) {
+		return settings_save_one(name, value, val_len);
+	}
+
+	k_mutex_lock(&entries_lock, K_FOREVER);
+
+	entry = entry_find(name);
+	if (!entry) {
+		entry = entry_alloc();
+		if (!entry) {
+			k_mutex_unlock(&entries_lock);
+			return settings_save_one(name, value, val_len);
+		}
+		strcpy(entry->name, name);
+		entry->used = true;
+	}
+
+	memcpy(entry->val, value, val_len);
+	entry->val_len = val_len;
+
+	k_mutex_unlock(&entries_lock);
+
+	/* The delay runs from the first pending save, not the last one */
+	k_work_schedule(&settings_deferred_work,
+			K_MSEC(CONFIG_SETTINGS_DEFERRED_SAVE_DELAY));
+
+	return 0;
+}
+
+void settings_deferred_cancel(const char *name)
+{
+	struct settings_deferred_entry *entry;
+
+	k_mutex_lock(&entries_lock, K_FOREVER);
+
+	entry = entry_find(name);
+	if (entry) {
+		entry->used = false;
+	}
+
+	k_mutex_unlock(&entries_lock);
+}
+
+/* Puts back an entry whose write failed, unless a newer value was saved for
+ * the same name meanwhile. Called with settings_lock held.
+ */
+static void entry_requeue(struct settings_deferred_entry *slot)
+{
+	struct settings_deferred_entry *entry;
+
+	k_mutex_lock(&entries_lock, K_FOREVER);
+
+	if (!entry_find(flushing.name)) {
+		entry = slot->used ? entry_alloc() : slot;
+		if (entry) {
+			*entry = flushing;
+		} else {
+			LOG_ERR("no entry left to retry key: %s",
+				log_strdup(flushing.name));
+		}
+	}
+
+	k_mutex_unlock(&entries_lock);
+}
+
+int settings_flush(void)
+{
+	struct settings_store *cs;
+	int rc = 0;
+	int rc2;
+
+	cs = settings_save_dst;
+	if (!cs) {
+		return -ENOENT;
+	}
+
+	k_mutex_lock(&settings_lock, K_FOREVER);
+
+	/* Entries are taken one at a time so that deferred saves done
+	 * meanwhile don't wait for the storage.
+	 */
+	for (int i = 0; i < ARRAY_SIZE(entries); i++) {
+		k_mutex_lock(&entries_lock, K_FOREVER);
+		if (!entries[i].used) {
+			k_mutex_unlock(&entries_lock);
+			continue;
+		}
+		flushing = entries[i];
+		entries[i].used = false;
+		k_mutex_unlock(&entries_lock);
+
+		rc2 = cs->cs_itf->csi_save(cs, flushing.name,
+					   flushing.val_len ?
+					   (char *)flushing.val : NULL,
+					   flushing.val_len);
+		if (rc2) {
+			LOG_ERR("deferred save failure. key: %s error(%d)",
+				log_strdup(flushing.name), rc2);
+			if (!rc) {
+				rc = rc2;
+			}
+			entry_requeue(&entries[i]);
+		}
+	}
+
+	k_mutex_unlock(&settings_lock);
+
+	return rc;
+}
+
+static void settings_deferred_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	/* Failed values are still pending, try them again later */
+	if (settings_flush()) {
+		k_work_schedule(&settings_deferred_work,
+				K_MSEC(CONFIG_SETTINGS_DEFERRED_SAVE_DELAY));
+	}
+}
@@ -124,7 +124,8 @@ static int read_entry_len(const struct fcb_entry_ctx *entry_ctx, off_t off)
 static int settings_fcb_load_priv(struct settings_store *cs,
 				  line_load_cb cb,
 				  void *cb_arg,
-				  bool filter_duplicates)
+				  bool filter_duplicates,
+				  const char *subtree)
 {
 	struct settings_fcb *cf = (struct settings_fcb *)cs;
 	struct fcb_entry_ctx entry_ctx = {
@@ -147,7 +148,12 @@ static int settings_fcb_load_priv(struct settings_store *cs,
 		}
 		name[name_len] = '\0';
 
-		if (filter_duplicates &&
+		/* Skip other subtrees before the search for duplicates */
+		if (subtree && !settings_name_steq(name, subtree, NULL)) {
+			pass_entry = false;
+		}
+
+		if (pass_entry && filter_duplicates &&
 		    (!read_entry_len(&entry_ctx, name_len+1) ||
 		     settings_fcb_check_duplicate(cf, &entry_ctx, name))) {
 			pass_entry = false;
@@ -171,7 +177,8 @@ static int settings_fcb_load(struct settings_store *cs,
 		cs,
 		settings_line_load_cb,
 		(void *)arg,
-		true);
+		true,
+		arg ? arg->subtree : NULL);
 }
 
 static int read_handler(void *ctx, off_t off, char *buf, size_t *len)
@@ -360,7 +367,8 @@ static int settings_fcb_save(struct settings_store *cs, const char *name,
 	cdca.val = (char *)value;
 	cdca.is_dup = 0;
 	cdca.val_len = val_len;
-	settings_fcb_load_priv(cs, settings_line_dup_check_cb, &cdca, false);
+	settings_fcb_load_priv(cs, settings_line_dup_check_cb, &cdca, false,
+			NULL);
 	if (cdca.is_dup == 1) {
 		return 0;
 	}
@@ -108,7 +108,8 @@ static int read_entry_len(const struct line_entry_ctx *entry_ctx, off_t off)
 }
 
 static int settings_file_load_priv(struct settings_store *cs, line_load_cb cb,
-				   void *cb_arg, bool filter_duplicates)
+				   void *cb_arg, bool filter_duplicates,
+				   const char *subtree)
 {
 	struct settings_file *cf = (struct settings_file *)cs;
 	struct fs_file_t file;
@@ -148,7 +149,12 @@ static int settings_file_load_priv(struct settings_store *cs, line_load_cb cb,
 		}
 		name[name_len] = '\0';
 
-		if (filter_duplicates &&
+		/* Skip other subtrees before the search for duplicates */
+		if (subtree && !settings_name_steq(name, subtree, NULL)) {
+			pass_entry = false;
+		}
+
+		if (pass_entry && filter_duplicates &&
 		    (!read_entry_len(&entry_ctx, name_len+1) ||
 		     settings_file_check_duplicate(&entry_ctx, name))) {
 			pass_entry = false;
@@ -176,7 +182,8 @@ static int settings_file_load(struct settings_store *cs,
 	return settings_file_load_priv(cs,
 				       settings_line_load_cb,
 				       (void *)arg,
-				       true);
+				       true,
+				       arg ? arg->subtree : NULL);
 }
 
 static void settings_tmpfile(char *dst, const char *src, char *pfx)
@@ -428,7 +435,8 @@ static int settings_file_save(struct settings_store *cs, const char *name,
 	cdca.val = (char *)value;
 	cdca.is_dup = 0;
 	cdca.val_len = val_len;
-	settings_file_load_priv(cs, settings_line_dup_check_cb, &cdca, false);
+	settings_file_load_priv(cs, settings_line_dup_check_cb, &cdca, false,
+			NULL);
 	if (cdca.is_dup == 1) {
 		return 0;
 	}
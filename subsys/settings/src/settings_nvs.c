@@ -19,6 +19,8 @@ LOG_MODULE_DECLARE(settings, CONFIG_SETTINGS_LOG_LEVEL);
 struct settings_nvs_read_fn_arg {
 	struct nvs_fs *fs;
 	uint16_t id;
+	/* Entry found by a walk, NULL to look up the id */
+	const struct nvs_walk_entry *entry;
 };
 
 static int settings_nvs_load(struct settings_store *cs,
@@ -38,7 +40,13 @@ static ssize_t settings_nvs_read_fn(void *back_end, void *data, size_t len)
 
 	rd_fn_arg = (struct settings_nvs_read_fn_arg *)back_end;
 
-	rc = nvs_read(rd_fn_arg->fs, rd_fn_arg->id, data, len);
+	rc = -EAGAIN;
+	if (rd_fn_arg->entry) {
+		rc = nvs_read_entry(rd_fn_arg->fs, rd_fn_arg->entry, data, len);
+	}
+	if (rc == -EAGAIN) {
+		rc = nvs_read(rd_fn_arg->fs, rd_fn_arg->id, data, len);
+	}
 	if (rc > (ssize_t)len) {
 		/* nvs_read signals that not all bytes were read
 		 * align read len to what was requested
@@ -64,63 +72,161 @@ int settings_nvs_dst(struct settings_nvs *cf)
 	return 0;
 }
 
-static int settings_nvs_load(struct settings_store *cs,
-			     const struct settings_load_arg *arg)
+#if defined(CONFIG_SETTINGS_NVS_SINGLE_PASS_LOAD)
+/* Newest NVS entries for the name and the value of each name ID, found by
+ * a single walk of the file system. An entry id of 0 means not found.
+ */
+struct settings_nvs_load_entry {
+	struct nvs_walk_entry name;
+	struct nvs_walk_entry val;
+};
+
+static struct settings_nvs_load_entry
+	load_entries[CONFIG_SETTINGS_NVS_SINGLE_PASS_LOAD_MAX];
+
+static int settings_nvs_load_walk_cb(struct nvs_fs *fs,
+				     const struct nvs_walk_entry *entry,
+				     void *param)
+{
+	struct settings_nvs *cf = (struct settings_nvs *)param;
+	struct nvs_walk_entry *found;
+	uint16_t id = entry->id;
+
+	if (id >= NVS_NAMECNT_ID + NVS_NAME_ID_OFFSET) {
+		id -= NVS_NAME_ID_OFFSET;
+		if (id <= NVS_NAMECNT_ID || id > cf->last_name_id) {
+			return 0;
+		}
+		found = &load_entries[id - NVS_NAMECNT_ID - 1].val;
+	} else {
+		if (id <= NVS_NAMECNT_ID || id > cf->last_name_id) {
+			return 0;
+		}
+		found = &load_entries[id - NVS_NAMECNT_ID - 1].name;
+	}
+
+	/* The walk goes from new to old, only the first entry counts */
+	if (found->id == 0U) {
+		*found = *entry;
+	}
+
+	return 0;
+}
+#endif /* CONFIG_SETTINGS_NVS_SINGLE_PASS_LOAD */
+
+static int settings_nvs_load_one(struct settings_nvs *cf, uint16_t name_id,
+				 const struct settings_load_arg *arg,
+				 const struct nvs_walk_entry *name_entry,
+				 const struct nvs_walk_entry *val_entry)
 {
-	int ret = 0;
-	struct settings_nvs *cf = (struct settings_nvs *)cs;
 	struct settings_nvs_read_fn_arg read_fn_arg;
 	char name[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
 	char buf;
-	ssize_t rc1, rc2;
-	uint16_t name_id = NVS_NAMECNT_ID;
-
-	name_id = cf->last_name_id + 1;
-
-	while (1) {
+	ssize_t rc1 = 0, rc2 = 0;
 
-		name_id--;
-		if (name_id == NVS_NAMECNT_ID) {
-			break;
+	if (name_entry) {
+		if (name_entry->id) {
+			rc1 = nvs_read_entry(&cf->cf_nvs, name_entry, &name,
+					     sizeof(name));
+		}
+		if (val_entry->id) {
+			rc2 = nvs_read_entry(&cf->cf_nvs, val_entry, NULL, 0);
+		}
+		if ((rc1 == -EAGAIN) || (rc2 == -EAGAIN)) {
+			/* Written by a handler since the walk */
+			name_entry = NULL;
+			val_entry = NULL;
 		}
+	}
 
+	if (!name_entry) {
 		/* In the NVS backend, each setting item is stored in two NVS
 		 * entries one for the setting's name and one with the
 		 * setting's value.
 		 */
 		rc1 = nvs_read(&cf->cf_nvs, name_id, &name, sizeof(name));
+	}
+
+	if (rc1 > 0) {
+		/* Found a name, this might not include a trailing \0 */
+		name[MIN((size_t)rc1, sizeof(name) - 1)] = '\0';
+	}
+
+	/* Skip items of other subtrees without looking up their value,
+	 * dirty entries are cleaned by a full load.
+	 */
+	if (arg && arg->subtree &&
+	    ((rc1 <= 0) || !settings_name_steq(name, arg->subtree, NULL))) {
+		return 0;
+	}
+
+	if (!name_entry) {
 		rc2 = nvs_read(&cf->cf_nvs, name_id + NVS_NAME_ID_OFFSET,
 			       &buf, sizeof(buf));
+	}
 
-		if ((rc1 <= 0) && (rc2 <= 0)) {
-			continue;
+	if ((rc1 <= 0) && (rc2 <= 0)) {
+		return 0;
+	}
+
+	if ((rc1 <= 0) || (rc2 <= 0)) {
+		/* Settings item is not stored correctly in the NVS.
+		 * NVS entry for its name or value is either missing
+		 * or deleted. Clean dirty entries to make space for
+		 * future settings item.
+		 */
+		if (name_id == cf->last_name_id) {
+			cf->last_name_id--;
+			nvs_write(&cf->cf_nvs, NVS_NAMECNT_ID,
+				  &cf->last_name_id, sizeof(uint16_t));
 		}
+		nvs_delete(&cf->cf_nvs, name_id);
+		nvs_delete(&cf->cf_nvs, name_id + NVS_NAME_ID_OFFSET);
+		return 0;
+	}
 
-		if ((rc1 <= 0) || (rc2 <= 0)) {
-			/* Settings item is not stored correctly in the NVS.
-			 * NVS entry for its name or value is either missing
-			 * or deleted. Clean dirty entries to make space for
-			 * future settings item.
-			 */
-			if (name_id == cf->last_name_id) {
-				cf->last_name_id--;
-				nvs_write(&cf->cf_nvs, NVS_NAMECNT_ID,
-					  &cf->last_name_id, sizeof(uint16_t));
-			}
-			nvs_delete(&cf->cf_nvs, name_id);
-			nvs_delete(&cf->cf_nvs, name_id + NVS_NAME_ID_OFFSET);
-			continue;
+	read_fn_arg.fs = &cf->cf_nvs;
+	read_fn_arg.id = name_id + NVS_NAME_ID_OFFSET;
+	read_fn_arg.entry = val_entry;
+
+	return settings_call_set_handler(name, rc2, settings_nvs_read_fn,
+					 &read_fn_arg, (void *)arg);
+}
+
+static int settings_nvs_load(struct settings_store *cs,
+			     const struct settings_load_arg *arg)
+{
+	int ret = 0;
+	struct settings_nvs *cf = (struct settings_nvs *)cs;
+	struct nvs_walk_entry *name_entry = NULL;
+	struct nvs_walk_entry *val_entry = NULL;
+	uint16_t name_id;
+#if defined(CONFIG_SETTINGS_NVS_SINGLE_PASS_LOAD)
+	uint16_t count = cf->last_name_id - NVS_NAMECNT_ID;
+	bool single_pass = (cf->last_name_id >= NVS_NAMECNT_ID) &&
+			   (count <= ARRAY_SIZE(load_entries));
+
+	/* Find the entries of all settings at once instead of looking up
+	 * each name and value from the newest entry on.
+	 */
+	if (single_pass) {
+		(void)memset(load_entries, 0, count * sizeof(load_entries[0]));
+		ret = nvs_walk(&cf->cf_nvs, settings_nvs_load_walk_cb, cf);
+		if (ret) {
+			return ret;
 		}
+	}
+#endif
 
-		/* Found a name, this might not include a trailing \0 */
-		name[rc1] = '\0';
-		read_fn_arg.fs = &cf->cf_nvs;
-		read_fn_arg.id = name_id + NVS_NAME_ID_OFFSET;
-
-		ret = settings_call_set_handler(
-			name, rc2,
-			settings_nvs_read_fn, &read_fn_arg,
-			(void *)arg);
+	for (name_id = cf->last_name_id; name_id > NVS_NAMECNT_ID; name_id--) {
+#if defined(CONFIG_SETTINGS_NVS_SINGLE_PASS_LOAD)
+		if (single_pass) {
+			name_entry = &load_entries[name_id - NVS_NAMECNT_ID - 1].name;
+			val_entry = &load_entries[name_id - NVS_NAMECNT_ID - 1].val;
+		}
+#endif
+		ret = settings_nvs_load_one(cf, name_id, arg, name_entry,
+					    val_entry);
 		if (ret) {
 			break;
 		}
@@ -125,6 +125,11 @@ extern sys_slist_t settings_load_srcs;
 extern sys_slist_t settings_handlers;
 extern struct settings_store *settings_save_dst;
 
+#ifdef CONFIG_SETTINGS_DEFERRED_SAVE
+/* Drop the pending deferred value of an item that is written at once */
+void settings_deferred_cancel(const char *name);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
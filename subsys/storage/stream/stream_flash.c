@@ -12,6 +12,7 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME, CONFIG_STREAM_FLASH_LOG_LEVEL);
 
 #include <zephyr/types.h>
 #include <string.h>
+#include <init.h>
 #include <drivers/flash.h>
 
 #include <storage/stream_flash.h>
@@ -104,42 +105,69 @@ int stream_flash_erase_page(struct stream_flash_ctx *ctx, off_t off)
 
 #endif /* CONFIG_STREAM_FLASH_ERASE */
 
-static int flash_sync(struct stream_flash_ctx *ctx)
+#if defined(CONFIG_STREAM_FLASH_ERASE) && \
+	defined(CONFIG_STREAM_FLASH_DOUBLE_BUFFER)
+
+/* Erase the page to which off belongs unless the stream is already past
+ * it, as pages may be erased ahead of the data when double buffering.
+ */
+static int erase_ahead(struct stream_flash_ctx *ctx, off_t off)
+{
+	int rc;
+	struct flash_pages_info page;
+
+	rc = flash_get_page_info_by_offs(ctx->fdev, off, &page);
+	if (rc != 0) {
+		LOG_ERR("Error %d while getting page info", rc);
+		return rc;
+	}
+
+	if (page.start_offset <= ctx->last_erased_page_start_offset) {
+		return 0;
+	}
+
+	return stream_flash_erase_page(ctx, off);
+}
+
+#endif
+
+static int flash_write_buf(struct stream_flash_ctx *ctx, uint8_t *buf,
+			   size_t buf_bytes, size_t write_addr)
 {
 	int rc = 0;
-	size_t write_addr = ctx->offset + ctx->bytes_written;
 	size_t buf_bytes_aligned;
 	size_t fill_length;
 	uint8_t filler;
 
-
-	if (ctx->buf_bytes == 0) {
-		return 0;
+#ifdef CONFIG_STREAM_FLASH_ERASE
+#ifdef CONFIG_STREAM_FLASH_DOUBLE_BUFFER
+	if (ctx->wr_buf != NULL) {
+		rc = erase_ahead(ctx, write_addr + buf_bytes - 1);
+	} else
+#endif
+	{
+		rc = stream_flash_erase_page(ctx, write_addr + buf_bytes - 1);
 	}
 
-	if (IS_ENABLED(CONFIG_STREAM_FLASH_ERASE)) {
-
-		rc = stream_flash_erase_page(ctx,
-					     write_addr + ctx->buf_bytes - 1);
-		if (rc < 0) {
-			LOG_ERR("stream_flash_erase_page err %d offset=0x%08zx",
-				rc, write_addr);
-			return rc;
-		}
+	if (rc < 0) {
+		LOG_ERR("stream_flash_erase_page err %d offset=0x%08zx",
+			rc, write_addr);
+		return rc;
 	}
+#endif
 
 	fill_length = flash_get_write_block_size(ctx->fdev);
-	if (ctx->buf_bytes % fill_length) {
-		fill_length -= ctx->buf_bytes % fill_length;
+	if (buf_bytes % fill_length) {
+		fill_length -= buf_bytes % fill_length;
 		filler = flash_get_parameters(ctx->fdev)->erase_value;
 
-		memset(ctx->buf + ctx->buf_bytes, filler, fill_length);
+		memset(buf + buf_bytes, filler, fill_length);
 	} else {
 		fill_length = 0;
 	}
 
-	buf_bytes_aligned = ctx->buf_bytes + fill_length;
-	rc = flash_write(ctx->fdev, write_addr, ctx->buf, buf_bytes_aligned);
+	buf_bytes_aligned = buf_bytes + fill_length;
+	rc = flash_write(ctx->fdev, write_addr, buf, buf_bytes_aligned);
 
 	if (rc != 0) {
 		LOG_ERR("flash_write error %d offset=0x%08zx", rc,
@@ -151,42 +179,170 @@ static int flash_sync(struct stream_flash_ctx *ctx)
 		/* Invert to ensure that caller is able to discover a faulty
 		 * flash_read() even if no error code is returned.
 		 */
-		for (int i = 0; i < ctx->buf_bytes; i++) {
-			ctx->buf[i] = ~ctx->buf[i];
+		for (int i = 0; i < buf_bytes; i++) {
+			buf[i] = ~buf[i];
 		}
 
-		rc = flash_read(ctx->fdev, write_addr, ctx->buf,
-				ctx->buf_bytes);
+		rc = flash_read(ctx->fdev, write_addr, buf, buf_bytes);
 		if (rc != 0) {
 			LOG_ERR("flash read failed: %d", rc);
 			return rc;
 		}
 
-		rc = ctx->callback(ctx->buf, ctx->buf_bytes, write_addr);
+		rc = ctx->callback(buf, buf_bytes, write_addr);
 		if (rc != 0) {
 			LOG_ERR("callback failed: %d", rc);
 			return rc;
 		}
 	}
 
+	return rc;
+}
+
+static int flash_sync(struct stream_flash_ctx *ctx)
+{
+	int rc;
+
+	if (ctx->buf_bytes == 0) {
+		return 0;
+	}
+
+	rc = flash_write_buf(ctx, ctx->buf, ctx->buf_bytes,
+			     ctx->offset + ctx->bytes_written);
+	if (rc != 0) {
+		return rc;
+	}
+
 	ctx->bytes_written += ctx->buf_bytes;
 	ctx->buf_bytes = 0U;
 
 	return rc;
 }
 
+#ifdef CONFIG_STREAM_FLASH_DOUBLE_BUFFER
+
+static K_KERNEL_STACK_DEFINE(stream_flash_stack,
+			     CONFIG_STREAM_FLASH_WORKQUEUE_STACK_SIZE);
+static struct k_work_q stream_flash_work_q;
+
+static void flash_write_work_handler(struct k_work *work)
+{
+	struct stream_flash_ctx *ctx =
+		CONTAINER_OF(work, struct stream_flash_ctx, write_work);
+	int rc;
+
+	rc = flash_write_buf(ctx, ctx->wr_buf, ctx->wr_bytes, ctx->wr_offset);
+
+#ifdef CONFIG_STREAM_FLASH_ERASE
+	/* Get the page the next buffer ends in ready while it fills. On
+	 * failure the erase is retried before writing that buffer.
+	 */
+	size_t next_end = ctx->wr_offset + ctx->wr_bytes + ctx->buf_len;
+
+	if (rc == 0 && next_end <= ctx->offset + ctx->available) {
+		(void)erase_ahead(ctx, next_end - 1);
+	}
+#endif
+
+	ctx->wr_rc = rc;
+	k_sem_give(&ctx->write_done);
+}
+
+/* Wait for the write in progress, if any, and account for it. The caller
+ * then owns the second buffer until it submits it or gives write_done.
+ */
+static int flash_wait(struct stream_flash_ctx *ctx)
+{
+	int rc;
+
+	k_sem_take(&ctx->write_done, K_FOREVER);
+
+	rc = ctx->wr_rc;
+	if (rc == 0) {
+		ctx->bytes_written += ctx->wr_bytes;
+	}
+
+	ctx->wr_rc = 0;
+	ctx->wr_bytes = 0;
+
+	return rc;
+}
+
+/* Hand the filled buffer over to the work queue and go on with the other */
+static int flash_submit(struct stream_flash_ctx *ctx)
+{
+	uint8_t *buf;
+	int rc;
+
+	rc = flash_wait(ctx);
+	if (rc != 0) {
+		k_sem_give(&ctx->write_done);
+		return rc;
+	}
+
+	buf = ctx->wr_buf;
+	ctx->wr_buf = ctx->buf;
+	ctx->wr_bytes = ctx->buf_bytes;
+	ctx->wr_offset = ctx->offset + ctx->bytes_written;
+	ctx->buf = buf;
+	ctx->buf_bytes = 0U;
+
+	k_work_submit_to_queue(&stream_flash_work_q, &ctx->write_work);
+
+	return 0;
+}
+
+int stream_flash_double_buffer_set(struct stream_flash_ctx *ctx, uint8_t *buf)
+{
+	if (!ctx || !buf) {
+		return -EFAULT;
+	}
+
+	if (k_sem_count_get(&ctx->write_done) == 0) {
+		return -EBUSY;
+	}
+
+	ctx->wr_buf = buf;
+
+	return 0;
+}
+
+static int stream_flash_work_q_init(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	k_work_queue_start(&stream_flash_work_q, stream_flash_stack,
+			   K_KERNEL_STACK_SIZEOF(stream_flash_stack),
+			   CONFIG_STREAM_FLASH_WORKQUEUE_PRIORITY, NULL);
+	k_thread_name_set(&stream_flash_work_q.thread, "stream_flash");
+
+	return 0;
+}
+
+SYS_INIT(stream_flash_work_q_init, POST_KERNEL,
+	 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+
+#endif /* CONFIG_STREAM_FLASH_DOUBLE_BUFFER */
+
 int stream_flash_buffered_write(struct stream_flash_ctx *ctx, const uint8_t *data,
 				size_t len, bool flush)
 {
 	int processed = 0;
 	int rc = 0;
 	int buf_empty_bytes;
+	size_t pending = 0;
 
 	if (!ctx) {
 		return -EFAULT;
 	}
 
-	if (ctx->bytes_written + ctx->buf_bytes + len > ctx->available) {
+#ifdef CONFIG_STREAM_FLASH_DOUBLE_BUFFER
+	/* Only changed by this thread, while no write is in progress */
+	pending = ctx->wr_bytes;
+#endif
+
+	if (ctx->bytes_written + pending + ctx->buf_bytes + len >
+	    ctx->available) {
 		return -ENOMEM;
 	}
 
@@ -196,7 +352,14 @@ int stream_flash_buffered_write(struct stream_flash_ctx *ctx, const uint8_t *dat
 		       buf_empty_bytes);
 
 		ctx->buf_bytes = ctx->buf_len;
-		rc = flash_sync(ctx);
+#ifdef CONFIG_STREAM_FLASH_DOUBLE_BUFFER
+		if (ctx->wr_buf != NULL) {
+			rc = flash_submit(ctx);
+		} else
+#endif
+		{
+			rc = flash_sync(ctx);
+		}
 
 		if (rc != 0) {
 			return rc;
@@ -212,6 +375,22 @@ int stream_flash_buffered_write(struct stream_flash_ctx *ctx, const uint8_t *dat
 		ctx->buf_bytes += len - processed;
 	}
 
+#ifdef CONFIG_STREAM_FLASH_DOUBLE_BUFFER
+	if (flush && ctx->wr_buf != NULL) {
+		if (ctx->buf_bytes > 0) {
+			rc = flash_submit(ctx);
+			if (rc != 0) {
+				return rc;
+			}
+		}
+
+		rc = flash_wait(ctx);
+		k_sem_give(&ctx->write_done);
+
+		return rc;
+	}
+#endif
+
 	if (flush && ctx->buf_bytes > 0) {
 		rc = flash_sync(ctx);
 	}
@@ -219,6 +398,25 @@ int stream_flash_buffered_write(struct stream_flash_ctx *ctx, const uint8_t *dat
 	return rc;
 }
 
+int stream_flash_abort(struct stream_flash_ctx *ctx)
+{
+	if (!ctx) {
+		return -EFAULT;
+	}
+
+#ifdef CONFIG_STREAM_FLASH_DOUBLE_BUFFER
+	if (ctx->wr_buf != NULL) {
+		/* The result of a write nobody waits for any more */
+		(void)flash_wait(ctx);
+		k_sem_give(&ctx->write_done);
+	}
+#endif
+
+	ctx->buf_bytes = 0U;
+
+	return 0;
+}
+
 size_t stream_flash_bytes_written(struct stream_flash_ctx *ctx)
 {
 	return ctx->bytes_written;
@@ -300,6 +498,14 @@ int stream_flash_init(struct stream_flash_ctx *ctx, const struct device *fdev,
 	ctx->last_erased_page_start_offset = -1;
 #endif
 
+#ifdef CONFIG_STREAM_FLASH_DOUBLE_BUFFER
+	k_work_init(&ctx->write_work, flash_write_work_handler);
+	k_sem_init(&ctx->write_done, 1, 1);
+	ctx->wr_buf = NULL;
+	ctx->wr_bytes = 0;
+	ctx->wr_rc = 0;
+#endif
+
 	return 0;
 }
 
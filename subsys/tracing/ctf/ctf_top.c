@@ -22,13 +22,27 @@ static void _get_thread_name(struct k_thread *thread,
 	}
 }
 
+/* Name of a thread for the events which are not about the thread name.
+ * The compact encoding leaves it empty, the host takes it from the
+ * thread_create, thread_info and thread_name_set events instead.
+ */
+static void _get_event_thread_name(struct k_thread *thread,
+				   ctf_bounded_string_t *name)
+{
+	if (IS_ENABLED(CONFIG_TRACING_CTF_COMPACT)) {
+		name->buf[0] = '\0';
+	} else {
+		_get_thread_name(thread, name);
+	}
+}
+
 void sys_trace_k_thread_switched_out(void)
 {
 	ctf_bounded_string_t name = { "unknown" };
 	struct k_thread *thread;
 
 	thread = k_current_get();
-	_get_thread_name(thread, &name);
+	_get_event_thread_name(thread, &name);
 
 	ctf_top_thread_switched_out((uint32_t)(uintptr_t)thread, name);
 }
@@ -39,7 +53,7 @@ void sys_trace_k_thread_switched_in(void)
 	ctf_bounded_string_t name = { "unknown" };
 
 	thread = k_current_get();
-	_get_thread_name(thread, &name);
+	_get_event_thread_name(thread, &name);
 
 	ctf_top_thread_switched_in((uint32_t)(uintptr_t)thread, name);
 }
@@ -48,7 +62,7 @@ void sys_trace_k_thread_priority_set(struct k_thread *thread)
 {
 	ctf_bounded_string_t name = { "unknown" };
 
-	_get_thread_name(thread, &name);
+	_get_event_thread_name(thread, &name);
 	ctf_top_thread_priority_set((uint32_t)(uintptr_t)thread,
 				    thread->base.prio, name);
 }
@@ -78,7 +92,7 @@ void sys_trace_k_thread_abort(struct k_thread *thread)
 {
 	ctf_bounded_string_t name = { "unknown" };
 
-	_get_thread_name(thread, &name);
+	_get_event_thread_name(thread, &name);
 	ctf_top_thread_abort((uint32_t)(uintptr_t)thread, name);
 }
 
@@ -86,7 +100,7 @@ void sys_trace_k_thread_suspend(struct k_thread *thread)
 {
 	ctf_bounded_string_t name = { "unknown" };
 
-	_get_thread_name(thread, &name);
+	_get_event_thread_name(thread, &name);
 	ctf_top_thread_suspend((uint32_t)(uintptr_t)thread, name);
 }
 
@@ -94,7 +108,7 @@ void sys_trace_k_thread_resume(struct k_thread *thread)
 {
 	ctf_bounded_string_t name = { "unknown" };
 
-	_get_thread_name(thread, &name);
+	_get_event_thread_name(thread, &name);
 
 	ctf_top_thread_resume((uint32_t)(uintptr_t)thread, name);
 }
@@ -103,7 +117,7 @@ void sys_trace_k_thread_ready(struct k_thread *thread)
 {
 	ctf_bounded_string_t name = { "unknown" };
 
-	_get_thread_name(thread, &name);
+	_get_event_thread_name(thread, &name);
 
 	ctf_top_thread_ready((uint32_t)(uintptr_t)thread, name);
 }
@@ -117,7 +131,7 @@ void sys_trace_k_thread_pend(struct k_thread *thread)
 {
 	ctf_bounded_string_t name = { "unknown" };
 
-	_get_thread_name(thread, &name);
+	_get_event_thread_name(thread, &name);
 	ctf_top_thread_pend((uint32_t)(uintptr_t)thread, name);
 }
 
@@ -15,6 +15,103 @@
 /* Limit strings to 20 bytes to optimize bandwidth */
 #define CTF_MAX_STRING_LEN 20
 
+typedef struct {
+	char buf[CTF_MAX_STRING_LEN];
+} ctf_bounded_string_t;
+
+#ifdef CONFIG_TRACING_CTF_COMPACT
+
+/*
+ * Compact encoding: 32-bit integers are variable length integers of 7
+ * bits per byte, least significant first, signed ones being zigzag
+ * encoded first. Strings are a length byte followed by the characters.
+ * Other fields are copied as is. The events are timestamped when they
+ * are buffered, see tracing_format_timed_data().
+ */
+static inline uint8_t *ctf_compact_u32(uint8_t *cursor, const void *field,
+				       size_t size)
+{
+	uint32_t val = *(const uint32_t *)field;
+
+	ARG_UNUSED(size);
+
+	while (val >= 0x80U) {
+		*cursor++ = (uint8_t)val | 0x80U;
+		val >>= 7;
+	}
+	*cursor++ = (uint8_t)val;
+
+	return cursor;
+}
+
+static inline uint8_t *ctf_compact_s32(uint8_t *cursor, const void *field,
+				       size_t size)
+{
+	int32_t val = *(const int32_t *)field;
+	uint32_t zigzag = ((uint32_t)val << 1) ^ (uint32_t)(val >> 31);
+
+	return ctf_compact_u32(cursor, &zigzag, size);
+}
+
+static inline uint8_t *ctf_compact_string(uint8_t *cursor, const void *field,
+					  size_t size)
+{
+	const ctf_bounded_string_t *str = field;
+	size_t len = strnlen(str->buf, sizeof(str->buf));
+
+	ARG_UNUSED(size);
+
+	*cursor++ = (uint8_t)len;
+	memcpy(cursor, str->buf, len);
+
+	return cursor + len;
+}
+
+static inline uint8_t *ctf_compact_raw(uint8_t *cursor, const void *field,
+				       size_t size)
+{
+	memcpy(cursor, field, size);
+
+	return cursor + size;
+}
+
+/*
+ * Obtain a field's maximum encoded size at compile-time.
+ */
+#define CTF_INTERNAL_FIELD_SIZE(x) + sizeof(x) + 1
+
+/*
+ * Append a field to current event-packet.
+ */
+#define CTF_INTERNAL_FIELD_APPEND(x)                                           \
+	{                                                                      \
+		epacket_cursor = _Generic((x),                                 \
+			uint32_t: ctf_compact_u32,                             \
+			int32_t: ctf_compact_s32,                              \
+			ctf_bounded_string_t: ctf_compact_string,              \
+			default: ctf_compact_raw)(epacket_cursor, &(x),        \
+						  sizeof(x));                  \
+	}
+
+/*
+ * Gather fields to a contiguous event-packet, then atomically emit.
+ */
+#define CTF_GATHER_FIELDS(...)                                                  \
+	{                                                                       \
+		uint8_t epacket[0 MAP(CTF_INTERNAL_FIELD_SIZE, ##__VA_ARGS__)]; \
+		uint8_t *epacket_cursor = &epacket[0];                          \
+										\
+		MAP(CTF_INTERNAL_FIELD_APPEND, ##__VA_ARGS__)                   \
+		tracing_format_timed_data(epacket, epacket_cursor - epacket);   \
+	}
+
+#define CTF_EVENT(...)                                                         \
+	{                                                                      \
+		CTF_GATHER_FIELDS(__VA_ARGS__)                                 \
+	}
+
+#else
+
 /*
  * Obtain a field's size at compile-time.
  */
@@ -55,6 +152,8 @@
 	}
 #endif
 
+#endif /* CONFIG_TRACING_CTF_COMPACT */
+
 /* Anonymous compound literal with 1 member. Legal since C99.
  * This permits us to take the address of literals, like so:
  *  &CTF_LITERAL(int, 1234)
@@ -99,10 +198,6 @@ typedef enum {
 	CTF_EVENT_MUTEX_UNLOCK_EXIT = 0x2D,
 } ctf_event_t;
 
-typedef struct {
-	char buf[CTF_MAX_STRING_LEN];
-} ctf_bounded_string_t;
-
 static inline void ctf_top_thread_switched_out(uint32_t thread_id,
 					       ctf_bounded_string_t name)
 {
@@ -104,6 +104,61 @@ int tracing_buffer_get_finish(uint32_t size);
  */
 uint32_t tracing_buffer_get(uint8_t *data, uint32_t size);
 
+#ifdef CONFIG_TRACING_PER_CPU_BUFFERS
+/**
+ * @brief Header of a chunk of the tracing buffer of a CPU.
+ *
+ * With per-CPU buffers, the data of the buffers is output in chunks,
+ * each one preceded by this header.
+ */
+struct tracing_buffer_chunk_hdr {
+	uint8_t magic;
+	uint8_t cpu;
+	uint16_t len; /**< Chunk length, little endian */
+} __packed;
+
+#define TRACING_BUFFER_CHUNK_MAGIC 0xCF
+
+/**
+ * @brief Tracing buffer of a CPU is empty or not.
+ *
+ * With per-CPU buffers, the put functions and tracing_buffer_space_get()
+ * apply to the buffer of the current CPU and must be called with its
+ * interrupts locked, while tracing_buffer_is_empty() tells whether all
+ * the buffers are empty.
+ *
+ * @param cpu CPU id.
+ *
+ * @return true if the buffer of the CPU is empty, or false if not.
+ */
+bool tracing_buffer_cpu_is_empty(unsigned int cpu);
+
+/**
+ * @brief Get address of the first valid data in the tracing buffer of a CPU.
+ *
+ * @param cpu CPU id.
+ * @param data Pointer to the address. It's set to a location pointing to
+ *             the first valid data within the buffer.
+ * @param size Requested buffer size (in bytes).
+ *
+ * @return Size of valid buffer which can be smaller than requested
+ *         if there isn't enough valid data or buffer wraps.
+ */
+uint32_t tracing_buffer_cpu_get_claim(unsigned int cpu, uint8_t **data,
+				      uint32_t size);
+
+/**
+ * @brief Indicate number of bytes read from claimed buffer of a CPU.
+ *
+ * @param cpu CPU id.
+ * @param size Number of bytes read from claimed buffer.
+ *
+ * @retval 0 Successful operation.
+ * @retval -EINVAL Given @a size exceeds available data of the buffer.
+ */
+int tracing_buffer_cpu_get_finish(unsigned int cpu, uint32_t size);
+#endif
+
 /**
  * @brief Get buffer from tracing command buffer.
  *
@@ -53,6 +53,18 @@ bool tracing_format_raw_data_put(uint8_t *data, uint32_t size);
  */
 bool tracing_format_data_put(tracing_data_t *tracing_data_array, uint32_t count);
 
+/**
+ * @brief Put timestamped raw data format message to tracing buffer.
+ *
+ * Must be called with the tracing buffer locked.
+ *
+ * @param data   Raw data to be traced.
+ * @param length Raw data length.
+ *
+ * @return true if put tracing message to tracing buffer successfully.
+ */
+bool tracing_format_timed_data_put(uint8_t *data, uint32_t size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <string.h>
+#include <sys/atomic.h>
+#include <sys/printk.h>
+#include <sys/util.h>
+#include <debug/coredump.h>
+#include <tracing/flight_recorder.h>
+#include <tracing_core.h>
+#include <tracing_buffer.h>
+#include <tracing_backend.h>
+
+/* The recorder keeps the most recent packets in a ring. Each packet is
+ * stored as a record made of a 16-bit length and the packet data, and
+ * the oldest records are dropped to make room for new ones, so that the
+ * ring always starts at a packet boundary. Records wrap around the end
+ * of the ring. The header makes the ring self describing for the host
+ * tools reading it from a memory or core dump.
+ */
+
+#define FLIGHT_RECORDER_MAGIC 0x52465A54 /* "TZFR" */
+#define RECORD_HDR_LEN sizeof(uint16_t)
+
+struct flight_recorder {
+	uint32_t magic;
+	uint32_t size;
+	/* Offset of the oldest record */
+	uint32_t head;
+	/* Bytes used by the records */
+	uint32_t used;
+	uint8_t data[CONFIG_TRACING_FLIGHT_RECORDER_SIZE];
+};
+
+static struct flight_recorder recorder = {
+	.magic = FLIGHT_RECORDER_MAGIC,
+	.size = CONFIG_TRACING_FLIGHT_RECORDER_SIZE,
+};
+
+static atomic_t frozen;
+
+static void ring_write(uint32_t offset, const uint8_t *data, uint32_t length)
+{
+	uint32_t first = MIN(length, recorder.size - offset);
+
+	memcpy(&recorder.data[offset], data, first);
+	memcpy(recorder.data, &data[first], length - first);
+}
+
+static void ring_read(uint32_t offset, uint8_t *data, uint32_t length)
+{
+	uint32_t first = MIN(length, recorder.size - offset);
+
+	memcpy(data, &recorder.data[offset], first);
+	memcpy(&data[first], recorder.data, length - first);
+}
+
+static void tracing_backend_flight_recorder_output(
+		const struct tracing_backend *backend,
+		uint8_t *data, uint32_t length)
+{
+	uint16_t record_len = length;
+	uint32_t tail;
+
+	/* Called with the tracing lock held, see tracing_format_sync.c */
+	if (atomic_get(&frozen) ||
+	    length + RECORD_HDR_LEN > recorder.size || length > UINT16_MAX) {
+		return;
+	}
+
+	while (recorder.size - recorder.used < length + RECORD_HDR_LEN) {
+		uint16_t oldest;
+
+		ring_read(recorder.head, (uint8_t *)&oldest, sizeof(oldest));
+
+		recorder.head = (recorder.head + RECORD_HDR_LEN + oldest) %
+			recorder.size;
+		recorder.used -= RECORD_HDR_LEN + oldest;
+	}
+
+	tail = (recorder.head + recorder.used) % recorder.size;
+
+	ring_write(tail, (uint8_t *)&record_len, RECORD_HDR_LEN);
+	ring_write((tail + RECORD_HDR_LEN) % recorder.size, data, length);
+
+	recorder.used += RECORD_HDR_LEN + length;
+}
+
+static void tracing_backend_flight_recorder_init(void)
+{
+	recorder.head = 0U;
+	recorder.used = 0U;
+}
+
+const struct tracing_backend_api tracing_backend_flight_recorder_api = {
+	.init = tracing_backend_flight_recorder_init,
+	.output  = tracing_backend_flight_recorder_output
+};
+
+TRACING_BACKEND_DEFINE(tracing_backend_flight_recorder,
+		       tracing_backend_flight_recorder_api);
+
+void tracing_flight_recorder_freeze(void)
+{
+	/* Let a packet being recorded on another CPU complete */
+	unsigned int key = irq_lock();
+
+	atomic_set(&frozen, true);
+
+	irq_unlock(key);
+}
+
+void tracing_flight_recorder_resume(void)
+{
+	atomic_set(&frozen, false);
+}
+
+bool tracing_flight_recorder_is_frozen(void)
+{
+	return atomic_get(&frozen);
+}
+
+size_t tracing_flight_recorder_dump(tracing_flight_recorder_dump_cb_t cb,
+				    void *user_data)
+{
+	bool was_frozen = tracing_flight_recorder_is_frozen();
+	uint32_t offset, done = 0U;
+	size_t total = 0;
+
+	tracing_flight_recorder_freeze();
+
+	offset = recorder.head;
+
+	while (done < recorder.used) {
+		uint16_t record_len;
+		uint32_t first;
+
+		ring_read(offset, (uint8_t *)&record_len, RECORD_HDR_LEN);
+		offset = (offset + RECORD_HDR_LEN) % recorder.size;
+
+		first = MIN(record_len, recorder.size - offset);
+		cb(&recorder.data[offset], first, user_data);
+		if (first < record_len) {
+			cb(recorder.data, record_len - first, user_data);
+		}
+
+		offset = (offset + record_len) % recorder.size;
+		done += RECORD_HDR_LEN + record_len;
+		total += record_len;
+	}
+
+	if (!was_frozen) {
+		tracing_flight_recorder_resume();
+	}
+
+	return total;
+}
+
+/* Same format as the coredump logging backend, 32 bytes per line */
+#define PRINT_LINE_LEN 32
+
+struct print_ctx {
+	uint8_t line[PRINT_LINE_LEN];
+	size_t len;
+};
+
+static void print_line(struct print_ctx *ctx)
+{
+	char hex[PRINT_LINE_LEN * 2 + 1];
+
+	bin2hex(ctx->line, ctx->len, hex, sizeof(hex));
+	printk("#TR:%s\n", hex);
+	ctx->len = 0;
+}
+
+static void print_cb(const uint8_t *data, size_t length, void *user_data)
+{
+	struct print_ctx *ctx = user_data;
+
+	for (size_t i = 0; i < length; i++) {
+		ctx->line[ctx->len++] = data[i];
+		if (ctx->len == PRINT_LINE_LEN) {
+			print_line(ctx);
+		}
+	}
+}
+
+void tracing_flight_recorder_trigger(void)
+{
+	struct print_ctx ctx = { .len = 0 };
+
+	tracing_flight_recorder_freeze();
+
+	printk("#TR:BEGIN#\n");
+	tracing_flight_recorder_dump(print_cb, &ctx);
+	if (ctx.len > 0) {
+		print_line(&ctx);
+	}
+	printk("#TR:END#\n");
+}
+
+void z_tracing_flight_recorder_fatal_error(void)
+{
+	if (IS_ENABLED(CONFIG_TRACING_FLIGHT_RECORDER_DUMP_ON_FATAL)) {
+		tracing_flight_recorder_trigger();
+	} else {
+		tracing_flight_recorder_freeze();
+	}
+}
+
+void z_tracing_flight_recorder_coredump(void)
+{
+	tracing_flight_recorder_freeze();
+
+	/* The whole RAM is dumped already otherwise */
+	if (!IS_ENABLED(CONFIG_DEBUG_COREDUMP_MEMORY_DUMP_LINKER_RAM)) {
+		coredump_memory_dump(POINTER_TO_UINT(&recorder),
+				     POINTER_TO_UINT(&recorder) +
+				     sizeof(recorder));
+	}
+}
+
+#ifdef CONFIG_TRACING_FLIGHT_RECORDER_SHELL
+#include <shell/shell.h>
+
+static void shell_print_cb(const uint8_t *data, size_t length,
+			   void *user_data)
+{
+	const struct shell *shell = user_data;
+
+	for (size_t i = 0; i < length; i += PRINT_LINE_LEN) {
+		char hex[PRINT_LINE_LEN * 2 + 1];
+		size_t len = MIN(length - i, PRINT_LINE_LEN);
+
+		bin2hex(&data[i], len, hex, sizeof(hex));
+		shell_print(shell, "#TR:%s", hex);
+	}
+}
+
+static int cmd_dump(const struct shell *shell, size_t argc, char **argv)
+{
+	size_t total;
+
+	shell_print(shell, "#TR:BEGIN#");
+	total = tracing_flight_recorder_dump(shell_print_cb, (void *)shell);
+	shell_print(shell, "#TR:END#");
+
+	shell_print(shell, "%zu bytes%s", total,
+		    tracing_flight_recorder_is_frozen() ? " (frozen)" : "");
+
+	return 0;
+}
+
+static int cmd_freeze(const struct shell *shell, size_t argc, char **argv)
+{
+	tracing_flight_recorder_freeze();
+
+	return 0;
+}
+
+static int cmd_resume(const struct shell *shell, size_t argc, char **argv)
+{
+	tracing_flight_recorder_resume();
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_flight_recorder,
+	SHELL_CMD_ARG(dump, NULL, "Print the recorded packets", cmd_dump, 1, 0),
+	SHELL_CMD_ARG(freeze, NULL, "Stop recording", cmd_freeze, 1, 0),
+	SHELL_CMD_ARG(resume, NULL, "Resume recording", cmd_resume, 1, 0),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(flight_recorder, &sub_flight_recorder,
+		   "Tracing flight recorder commands", NULL);
+#endif /* CONFIG_TRACING_FLIGHT_RECORDER_SHELL */
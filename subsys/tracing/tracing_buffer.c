@@ -4,10 +4,14 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <errno.h>
+#include <string.h>
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <sys/atomic.h>
 #include <sys/ring_buffer.h>
+#include <tracing_buffer.h>
 
-static struct ring_buf tracing_ring_buf;
-static uint8_t tracing_buffer[CONFIG_TRACING_BUFFER_SIZE + 1];
 static uint8_t tracing_cmd_buffer[CONFIG_TRACING_CMD_BUFFER_SIZE];
 
 uint32_t tracing_cmd_buffer_alloc(uint8_t **data)
@@ -17,6 +21,154 @@ uint32_t tracing_cmd_buffer_alloc(uint8_t **data)
 	return sizeof(tracing_cmd_buffer);
 }
 
+#ifdef CONFIG_TRACING_PER_CPU_BUFFERS
+
+/* Each CPU puts its packets in its own buffer, with its interrupts
+ * locked, and the tracing thread takes them out. With one producer and
+ * one consumer, no lock is needed: the CPU only moves the tail and the
+ * thread only moves the head, each one publishing its index after the
+ * data it covers.
+ */
+#define CPU_BUFFER_SIZE (CONFIG_TRACING_BUFFER_SIZE + 1)
+
+struct cpu_buffer {
+	atomic_t head;
+	atomic_t tail;
+	/* Tail including the data claimed but not finished yet */
+	uint32_t claim;
+	uint8_t data[CPU_BUFFER_SIZE];
+};
+
+static struct cpu_buffer cpu_buffers[CONFIG_MP_NUM_CPUS];
+
+static struct cpu_buffer *curr_buffer(void)
+{
+	return &cpu_buffers[_current_cpu->id];
+}
+
+static uint32_t used(uint32_t head, uint32_t tail)
+{
+	return tail >= head ? tail - head : CPU_BUFFER_SIZE - head + tail;
+}
+
+uint32_t tracing_buffer_put_claim(uint8_t **data, uint32_t size)
+{
+	struct cpu_buffer *buf = curr_buffer();
+	uint32_t head = atomic_get(&buf->head);
+
+	size = MIN(size, CPU_BUFFER_SIZE - 1 - used(head, buf->claim));
+	size = MIN(size, CPU_BUFFER_SIZE - buf->claim);
+
+	*data = &buf->data[buf->claim];
+	buf->claim = (buf->claim + size) % CPU_BUFFER_SIZE;
+
+	return size;
+}
+
+int tracing_buffer_put_finish(uint32_t size)
+{
+	struct cpu_buffer *buf = curr_buffer();
+	uint32_t tail = atomic_get(&buf->tail);
+
+	if (size > used(tail, buf->claim)) {
+		return -EINVAL;
+	}
+
+	tail = (tail + size) % CPU_BUFFER_SIZE;
+	buf->claim = tail;
+	atomic_set(&buf->tail, tail);
+
+	return 0;
+}
+
+uint32_t tracing_buffer_put(uint8_t *data, uint32_t size)
+{
+	uint32_t total = 0U, claimed;
+	uint8_t *dst;
+
+	do {
+		claimed = tracing_buffer_put_claim(&dst, size - total);
+		memcpy(dst, &data[total], claimed);
+		total += claimed;
+	} while (total < size && claimed > 0U);
+
+	tracing_buffer_put_finish(total);
+
+	return total;
+}
+
+bool tracing_buffer_cpu_is_empty(unsigned int cpu)
+{
+	struct cpu_buffer *buf = &cpu_buffers[cpu];
+
+	return atomic_get(&buf->head) == atomic_get(&buf->tail);
+}
+
+uint32_t tracing_buffer_cpu_get_claim(unsigned int cpu, uint8_t **data,
+				      uint32_t size)
+{
+	struct cpu_buffer *buf = &cpu_buffers[cpu];
+	uint32_t head = atomic_get(&buf->head);
+	uint32_t tail = atomic_get(&buf->tail);
+
+	size = MIN(size, tail >= head ? tail - head : CPU_BUFFER_SIZE - head);
+	*data = &buf->data[head];
+
+	return size;
+}
+
+int tracing_buffer_cpu_get_finish(unsigned int cpu, uint32_t size)
+{
+	struct cpu_buffer *buf = &cpu_buffers[cpu];
+	uint32_t head = atomic_get(&buf->head);
+
+	if (size > used(head, atomic_get(&buf->tail))) {
+		return -EINVAL;
+	}
+
+	atomic_set(&buf->head, (head + size) % CPU_BUFFER_SIZE);
+
+	return 0;
+}
+
+void tracing_buffer_init(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(cpu_buffers); i++) {
+		atomic_set(&cpu_buffers[i].head, 0);
+		atomic_set(&cpu_buffers[i].tail, 0);
+		cpu_buffers[i].claim = 0U;
+	}
+}
+
+bool tracing_buffer_is_empty(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(cpu_buffers); i++) {
+		if (!tracing_buffer_cpu_is_empty(i)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+uint32_t tracing_buffer_capacity_get(void)
+{
+	return CPU_BUFFER_SIZE - 1;
+}
+
+uint32_t tracing_buffer_space_get(void)
+{
+	struct cpu_buffer *buf = curr_buffer();
+
+	return CPU_BUFFER_SIZE - 1 -
+		used(atomic_get(&buf->head), atomic_get(&buf->tail));
+}
+
+#else
+
+static struct ring_buf tracing_ring_buf;
+static uint8_t tracing_buffer[CONFIG_TRACING_BUFFER_SIZE + 1];
+
 uint32_t tracing_buffer_put_claim(uint8_t **data, uint32_t size)
 {
 	return ring_buf_put_claim(&tracing_ring_buf, data, size);
@@ -67,3 +219,5 @@ uint32_t tracing_buffer_space_get(void)
 {
 	return ring_buf_space_get(&tracing_ring_buf);
 }
+
+#endif /* CONFIG_TRACING_PER_CPU_BUFFERS */
@@ -9,6 +9,7 @@
 #include <kernel.h>
 #include <sys/util.h>
 #include <sys/atomic.h>
+#include <sys/byteorder.h>
 #include <tracing_core.h>
 #include <tracing_buffer.h>
 #include <tracing_backend.h>
@@ -24,6 +25,8 @@
 #define TRACING_BACKEND_NAME "tracing_backend_posix"
 #elif defined CONFIG_TRACING_BACKEND_RAM
 #define TRACING_BACKEND_NAME "tracing_backend_ram"
+#elif defined CONFIG_TRACING_BACKEND_FLIGHT_RECORDER
+#define TRACING_BACKEND_NAME "tracing_backend_flight_recorder"
 #else
 #define TRACING_BACKEND_NAME ""
 #endif
@@ -47,19 +50,54 @@ static K_SEM_DEFINE(tracing_thread_sem, 0, 1);
 static K_THREAD_STACK_DEFINE(tracing_thread_stack,
 			CONFIG_TRACING_THREAD_STACK_SIZE);
 
+#ifdef CONFIG_TRACING_PER_CPU_BUFFERS
+/* Output what the CPUs buffered so far, a chunk per CPU at a time so
+ * that a busy CPU does not hold back the others.
+ */
+static void tracing_cpu_buffers_output(void)
+{
+	struct tracing_buffer_chunk_hdr hdr = {
+		.magic = TRACING_BUFFER_CHUNK_MAGIC,
+	};
+	uint8_t *transferring_buf;
+	uint32_t transferring_length;
+
+	for (unsigned int cpu = 0; cpu < CONFIG_MP_NUM_CPUS; cpu++) {
+		transferring_length =
+			tracing_buffer_cpu_get_claim(cpu, &transferring_buf,
+						     UINT16_MAX);
+		if (transferring_length == 0U) {
+			continue;
+		}
+
+		hdr.cpu = cpu;
+		hdr.len = sys_cpu_to_le16(transferring_length);
+
+		tracing_buffer_handle((uint8_t *)&hdr, sizeof(hdr));
+		tracing_buffer_handle(transferring_buf, transferring_length);
+		tracing_buffer_cpu_get_finish(cpu, transferring_length);
+	}
+}
+#endif
+
 static void tracing_thread_func(void *dummy1, void *dummy2, void *dummy3)
 {
+#ifndef CONFIG_TRACING_PER_CPU_BUFFERS
 	uint8_t *transferring_buf;
 	uint32_t transferring_length, tracing_buffer_max_length;
 
-	tracing_thread_tid = k_current_get();
-
 	tracing_buffer_max_length = tracing_buffer_capacity_get();
+#endif
+
+	tracing_thread_tid = k_current_get();
 
 	while (true) {
 		if (tracing_buffer_is_empty()) {
 			k_sem_take(&tracing_thread_sem, K_FOREVER);
 		} else {
+#ifdef CONFIG_TRACING_PER_CPU_BUFFERS
+			tracing_cpu_buffers_output();
+#else
 			transferring_length =
 				tracing_buffer_get_claim(
 						&transferring_buf,
@@ -67,6 +105,7 @@ static void tracing_thread_func(void *dummy1, void *dummy2, void *dummy3)
 			tracing_buffer_handle(transferring_buf,
 					      transferring_length);
 			tracing_buffer_get_finish(transferring_length);
+#endif
 		}
 	}
 }
@@ -5,6 +5,8 @@
  */
 
 #include <string.h>
+#include <kernel.h>
+#include <kernel_structs.h>
 #include <sys/cbprintf.h>
 #include <tracing_buffer.h>
 #include <tracing_format_common.h>
@@ -83,3 +85,38 @@ bool tracing_format_data_put(tracing_data_t *tracing_data_array, uint32_t count)
 	tracing_buffer_put_finish(total_size);
 	return true;
 }
+
+/* Cycle count of the last timestamped message of each buffer */
+#ifdef CONFIG_TRACING_PER_CPU_BUFFERS
+static uint32_t last_timestamp[CONFIG_MP_NUM_CPUS];
+#define LAST_TIMESTAMP last_timestamp[_current_cpu->id]
+#else
+static uint32_t last_timestamp;
+#define LAST_TIMESTAMP last_timestamp
+#endif
+
+bool tracing_format_timed_data_put(uint8_t *data, uint32_t size)
+{
+	uint32_t now = k_cycle_get_32();
+	uint32_t delta = now - LAST_TIMESTAMP;
+	uint8_t hdr[5];
+	uint32_t hdr_len = 0U;
+
+	while (delta >= 0x80U) {
+		hdr[hdr_len++] = (uint8_t)delta | 0x80U;
+		delta >>= 7;
+	}
+	hdr[hdr_len++] = (uint8_t)delta;
+
+	if (tracing_buffer_space_get() < hdr_len + size) {
+		return false;
+	}
+
+	tracing_buffer_put(hdr, hdr_len);
+	tracing_buffer_put(data, size);
+
+	/* A dropped message leaves the reference of the next one as is */
+	LAST_TIMESTAMP = now;
+
+	return true;
+}
@@ -73,3 +73,28 @@ void tracing_format_data(tracing_data_t *tracing_data_array, uint32_t count)
 	}
 	TRACING_UNLOCK();
 }
+
+void tracing_format_timed_data(uint8_t *data, uint32_t length)
+{
+	uint8_t *buf;
+	bool put_success;
+	uint32_t tracing_buffer_size;
+
+	if (!is_tracing_enabled()) {
+		return;
+	}
+
+	tracing_buffer_size = tracing_buffer_capacity_get();
+
+	TRACING_LOCK();
+	put_success = tracing_format_timed_data_put(data, length);
+
+	if (put_success) {
+		length = tracing_buffer_get_claim(&buf, tracing_buffer_size);
+		tracing_buffer_handle(buf, length);
+		tracing_buffer_get_finish(length);
+	} else {
+		tracing_packet_drop_handle();
+	}
+	TRACING_UNLOCK();
+}
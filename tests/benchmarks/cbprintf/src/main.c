@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/cbprintf.h>
+
+/* This benchmark compares the cycles per call of cbprintf(), which
+ * parses the format string on every call, with CBPRINTF_FMT(), which
+ * uses the conversions pre-parsed on its first call. The output goes to
+ * a callback counting the characters, so that mostly the formatting is
+ * timed.
+ */
+
+#define N_CALLS 1000
+
+static size_t out_count;
+
+static int out(int c, void *ctx)
+{
+	ARG_UNUSED(ctx);
+
+	out_count++;
+
+	return c;
+}
+
+/* Time N_CALLS calls of both formatters with the same arguments */
+#define BENCH(fmt, ...) do {						\
+	uint32_t start, runtime, preparsed;				\
+	size_t count;							\
+									\
+	out_count = 0;							\
+	start = k_cycle_get_32();					\
+	for (int i = 0; i < N_CALLS; i++) {				\
+		cbprintf(out, NULL, fmt, __VA_ARGS__);			\
+	}								\
+	runtime = k_cycle_get_32() - start;				\
+	count = out_count;						\
+									\
+	out_count = 0;							\
+	start = k_cycle_get_32();					\
+	for (int i = 0; i < N_CALLS; i++) {				\
+		CBPRINTF_FMT(out, NULL, fmt, __VA_ARGS__);		\
+	}								\
+	preparsed = k_cycle_get_32() - start;				\
+									\
+	check(fmt, count, out_count);					\
+	printk("%-24s runtime %6u pre-parsed %6u cycles/call\n", fmt,	\
+	       runtime / N_CALLS, preparsed / N_CALLS);			\
+} while (false)
+
+static void check(const char *fmt, size_t runtime, size_t preparsed)
+{
+	if (runtime != preparsed) {
+		printk("%s: %zu characters, %zu pre-parsed\n", fmt, runtime,
+		       preparsed);
+	}
+}
+
+void main(void)
+{
+	static const char str[] = "hello";
+	volatile int value = -123456;
+	volatile double fp = 3.14159;
+
+	BENCH("%d", value);
+	BENCH("%s", str);
+	BENCH("%08x", (unsigned int)value);
+	BENCH("%.3f", fp);
+	BENCH("id %d name %s addr %08x", value, str, (unsigned int)value);
+
+	printk("fin\n");
+}
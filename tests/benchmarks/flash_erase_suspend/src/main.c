@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <drivers/flash.h>
+
+/* This benchmark measures the latency of reads from a thread while the
+ * flash is erased in the background, one sector after the other, with
+ * asynchronous erase requests. The reading thread has a higher priority
+ * than the one doing the erases, so its reads only wait for the flash.
+ */
+
+#ifdef CONFIG_ARCH_POSIX
+#define SOC_NV_FLASH_NODE DT_CHILD(DT_INST(0, zephyr_sim_flash), flash_0)
+#else
+#define SOC_NV_FLASH_NODE DT_CHILD(DT_INST(0, zephyr_sim_flash), flash_sim_0)
+#endif /* CONFIG_ARCH_POSIX */
+
+#define FLASH_OFFSET DT_REG_ADDR(SOC_NV_FLASH_NODE)
+#define SECTOR_SIZE DT_PROP(SOC_NV_FLASH_NODE, erase_block_size)
+#define N_SECTORS 8
+#define N_READS 256
+
+static const struct device *flash_dev =
+	DEVICE_DT_GET(DT_INST(0, zephyr_sim_flash));
+
+static struct flash_async_req erase_req;
+static int erases_left;
+static K_SEM_DEFINE(erase_done, 0, 1);
+
+static void check(bool ok, const char *what)
+{
+	if (!ok) {
+		printk("%s failed\n", what);
+		k_oops();
+	}
+}
+
+static void erase_cb(const struct device *dev, struct flash_async_req *req,
+		     int result)
+{
+	check(result == 0, "erase");
+
+	if (--erases_left == 0) {
+		k_sem_give(&erase_done);
+		return;
+	}
+
+	check(flash_erase_async(dev, FLASH_OFFSET +
+				(erases_left % N_SECTORS) * SECTOR_SIZE,
+				SECTOR_SIZE, req) == 0, "flash_erase_async");
+}
+
+/* Reads from the last sector, which is not erased, while erases_left is
+ * not zero or for N_READS reads when idle.
+ */
+static void run(bool erasing, uint32_t *avg_us, uint32_t *max_us)
+{
+	off_t offset = FLASH_OFFSET + N_SECTORS * SECTOR_SIZE;
+	uint64_t total = 0;
+	uint32_t max = 0;
+	uint8_t buf[16];
+	int n;
+
+	for (n = 0; erasing ? erases_left > 0 : n < N_READS; n++) {
+		uint32_t start, cycles;
+
+		/* Let the erases go on */
+		k_msleep(1);
+
+		start = k_cycle_get_32();
+		check(flash_read(flash_dev, offset, buf, sizeof(buf)) == 0,
+		      "flash_read");
+		cycles = k_cycle_get_32() - start;
+
+		total += cycles;
+		max = MAX(max, cycles);
+	}
+
+	*avg_us = k_cyc_to_us_floor32(total / MAX(n, 1));
+	*max_us = k_cyc_to_us_floor32(max);
+}
+
+void main(void)
+{
+	uint32_t idle_avg, idle_max, erase_avg, erase_max;
+
+	check(device_is_ready(flash_dev), "device");
+
+	run(false, &idle_avg, &idle_max);
+
+	flash_async_req_init(&erase_req, erase_cb, NULL);
+	erases_left = N_SECTORS * 4;
+	check(flash_erase_async(flash_dev, FLASH_OFFSET, SECTOR_SIZE,
+				&erase_req) == 0, "flash_erase_async");
+
+	run(true, &erase_avg, &erase_max);
+
+	k_sem_take(&erase_done, K_FOREVER);
+
+	printk("idle avg %6u max %6u erasing avg %6u max %6u us\n",
+	       idle_avg, idle_max, erase_avg, erase_max);
+
+	printk("fin\n");
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* This benchmark measures the cost of small k_heap allocations made
+ * concurrently by several threads, without and with a per-CPU cache
+ * attached to the heap.  Each thread keeps a small working set of
+ * blocks and replaces one of them per iteration, which is the pattern
+ * of buffer and message allocations in typical applications.
+ */
+
+#define MAX_THREADS 4
+#define N_OPS 10000
+#define WORKING_SET 8
+#define STACK_SIZE 1024
+
+static const int thread_counts[] = { 1, 2, MAX_THREADS };
+static const size_t sizes[] = { 16, 24, 40, 64, 100, 128, 200, 32 };
+
+K_HEAP_DEFINE(bench_heap, 32 * 1024);
+
+static struct k_heap_cache bench_cache;
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, MAX_THREADS, STACK_SIZE);
+static struct k_thread threads[MAX_THREADS];
+
+static K_SEM_DEFINE(start_sem, 0, MAX_THREADS);
+static K_SEM_DEFINE(done_sem, 0, MAX_THREADS);
+
+static void worker(void *arg1, void *arg2, void *arg3)
+{
+	void *blocks[WORKING_SET] = { 0 };
+	int seed = POINTER_TO_INT(arg1);
+
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	k_sem_take(&start_sem, K_FOREVER);
+
+	for (int i = 0; i < N_OPS; i++) {
+		int slot = (i + seed) % WORKING_SET;
+
+		k_heap_free(&bench_heap, blocks[slot]);
+		blocks[slot] = k_heap_alloc(&bench_heap,
+					    sizes[(i * 3 + seed) % ARRAY_SIZE(sizes)],
+					    K_NO_WAIT);
+		if (blocks[slot] == NULL) {
+			printk("allocation failed\n");
+			k_oops();
+		}
+	}
+
+	for (int i = 0; i < WORKING_SET; i++) {
+		k_heap_free(&bench_heap, blocks[i]);
+	}
+
+	k_sem_give(&done_sem);
+}
+
+/* Returns the average number of cycles per free/alloc pair, measured
+ * over the whole run so that contention between threads shows up.
+ */
+static uint32_t run(int n_threads)
+{
+	int prio = k_thread_priority_get(k_current_get()) + 1;
+	uint32_t start, cycles;
+
+	for (int i = 0; i < n_threads; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE,
+				worker, INT_TO_POINTER(i), NULL, NULL,
+				prio, 0, K_NO_WAIT);
+	}
+
+	/* Let them all block on the start semaphore */
+	k_sleep(K_MSEC(10));
+
+	start = k_cycle_get_32();
+
+	for (int i = 0; i < n_threads; i++) {
+		k_sem_give(&start_sem);
+	}
+
+	for (int i = 0; i < n_threads; i++) {
+		k_sem_take(&done_sem, K_FOREVER);
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	for (int i = 0; i < n_threads; i++) {
+		k_thread_join(&threads[i], K_FOREVER);
+	}
+
+	return cycles / (n_threads * N_OPS);
+}
+
+void main(void)
+{
+	static uint32_t uncached[ARRAY_SIZE(thread_counts)];
+	struct k_heap_cache_stats stats;
+
+	for (int i = 0; i < ARRAY_SIZE(thread_counts); i++) {
+		uncached[i] = run(thread_counts[i]);
+	}
+
+	k_heap_cache_attach(&bench_heap, &bench_cache);
+
+	for (int i = 0; i < ARRAY_SIZE(thread_counts); i++) {
+		uint32_t cached = run(thread_counts[i]);
+
+		printk("threads %2d heap %6u cached %6u cycles/op\n",
+		       thread_counts[i], uncached[i], cached);
+	}
+
+	k_heap_cache_stats_get(&bench_heap, &stats);
+
+	printk("alloc hits %u misses %u free hits %u refills %u flushes %u cached %zu bytes\n",
+	       stats.alloc_hits, stats.alloc_misses, stats.free_hits,
+	       stats.refills, stats.flushes, stats.cached_bytes);
+
+	printk("fin\n");
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <logging/log.h>
+#include <logging/log_ctrl.h>
+#include <logging/log_backend.h>
+
+LOG_MODULE_REGISTER(bench, LOG_LEVEL_INF);
+
+/* This benchmark measures the throughput of deferred logging when
+ * threads on several CPUs log at the same time. The main thread
+ * processes the messages meanwhile, with a backend which only counts
+ * them and checks that they come in timestamp order.
+ */
+
+#define MAX_THREADS CONFIG_MP_NUM_CPUS
+#define N_MSGS 20000
+#define STACK_SIZE 1024
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, MAX_THREADS, STACK_SIZE);
+static struct k_thread threads[MAX_THREADS];
+
+static atomic_t running;
+static uint32_t processed;
+static uint32_t dropped;
+static uint32_t out_of_order;
+static log_timestamp_t last_timestamp;
+
+static void process(const struct log_backend *const backend,
+		    union log_msg2_generic *msg)
+{
+	log_timestamp_t timestamp = log_msg2_get_timestamp(&msg->log);
+
+	if ((log_timestamp_t)(timestamp - last_timestamp) >
+	    ((log_timestamp_t)-1 >> 1)) {
+		out_of_order++;
+	}
+
+	last_timestamp = timestamp;
+	processed++;
+}
+
+static void dropped_cb(const struct log_backend *const backend, uint32_t cnt)
+{
+	dropped += cnt;
+}
+
+static void panic(const struct log_backend *const backend)
+{
+}
+
+static const struct log_backend_api bench_backend_api = {
+	.process = process,
+	.dropped = dropped_cb,
+	.panic = panic,
+};
+
+LOG_BACKEND_DEFINE(bench_backend, bench_backend_api, true);
+
+static void worker(void *arg1, void *arg2, void *arg3)
+{
+	int id = POINTER_TO_INT(arg1);
+
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	for (int i = 0; i < N_MSGS; i++) {
+		LOG_INF("thread %d message %d", id, i);
+	}
+
+	atomic_dec(&running);
+}
+
+static void run(int n_threads)
+{
+	int prio = k_thread_priority_get(k_current_get());
+	uint32_t start, cycles, rate;
+
+	processed = 0;
+	dropped = 0;
+	out_of_order = 0;
+	last_timestamp = 0;
+	atomic_set(&running, n_threads);
+
+	start = k_cycle_get_32();
+
+	for (int i = 0; i < n_threads; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE,
+				worker, INT_TO_POINTER(i), NULL, NULL,
+				prio, 0, K_NO_WAIT);
+	}
+
+	while (log_process(false) || atomic_get(&running) > 0) {
+	}
+
+	/* Messages committed after the last check of the loop */
+	while (log_process(false)) {
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	for (int i = 0; i < n_threads; i++) {
+		k_thread_join(&threads[i], K_FOREVER);
+	}
+
+	rate = (uint64_t)processed * sys_clock_hw_cycles_per_sec() / cycles;
+
+	printk("threads %2d msgs/s %8u dropped %3u%% out of order %u\n",
+	       n_threads, rate, dropped * 100U / (n_threads * N_MSGS),
+	       out_of_order);
+}
+
+void main(void)
+{
+	for (int i = 1; i <= MAX_THREADS; i++) {
+		run(i);
+	}
+
+	printk("fin\n");
+}
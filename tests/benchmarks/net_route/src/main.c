@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <random/rand32.h>
+#include <net/net_core.h>
+#include <net/net_if.h>
+#include <net/dummy.h>
+
+#include "ipv6.h"
+#include "route.h"
+
+/* This benchmark measures the cost of an IPv6 route lookup for routing
+ * tables of different sizes. The routes have prefixes of 48 to 96 bits
+ * and go through a set of neighbors. Lookups are done both for
+ * destinations that change from one lookup to the next, and repeatedly
+ * for the same destination as when forwarding a stream of packets.
+ */
+
+#define N_NEXTHOPS 32
+#define N_DESTS 1024
+#define N_LOOKUPS 8192
+
+static const int table_sizes[] = { 16, 256, CONFIG_NET_MAX_ROUTES };
+
+static struct net_if *iface;
+static struct in6_addr nexthops[N_NEXTHOPS];
+static struct in6_addr dests[N_DESTS];
+static struct net_route_entry *routes[CONFIG_NET_MAX_ROUTES];
+
+static void check(bool ok, const char *what)
+{
+	if (!ok) {
+		printk("%s failed\n", what);
+		k_oops();
+	}
+}
+
+static void bench_iface_init(struct net_if *iface)
+{
+	static uint8_t mac[] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x01 };
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_DUMMY);
+}
+
+static int bench_send(const struct device *dev, struct net_pkt *pkt)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(pkt);
+
+	return 0;
+}
+
+static struct dummy_api bench_if_api = {
+	.iface_api.init = bench_iface_init,
+	.send = bench_send,
+};
+
+NET_DEVICE_INIT(net_route_bench, "net_route_bench", NULL, NULL,
+		NULL, NULL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+		&bench_if_api, DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 1280);
+
+static void setup(void)
+{
+	static uint8_t lladdrs[N_NEXTHOPS][6];
+
+	iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	check(iface != NULL, "iface");
+
+	for (int i = 0; i < N_NEXTHOPS; i++) {
+		struct net_linkaddr lladdr = {
+			.addr = lladdrs[i],
+			.len = sizeof(lladdrs[i]),
+			.type = NET_LINK_DUMMY,
+		};
+
+		lladdrs[i][0] = 0x02;
+		lladdrs[i][5] = i + 1;
+
+		net_ipv6_addr_create(&nexthops[i], 0xfe80, 0, 0, 0,
+				     0, 0, 0, i + 1);
+
+		check(net_ipv6_nbr_add(iface, &nexthops[i], &lladdr, false,
+				       NET_IPV6_NBR_STATE_REACHABLE) != NULL,
+		      "neighbor");
+	}
+}
+
+/* Route i is 2001:db8:i::/48 with 0, 16, 32 or 48 more bits of prefix */
+static void route_prefix(int i, struct in6_addr *addr, uint8_t *len)
+{
+	net_ipv6_addr_create(addr, 0x2001, 0x0db8, i, i % 4 ? 0x1000 + i : 0,
+			     i % 4 > 1 ? 0x2000 + i : 0,
+			     i % 4 > 2 ? 0x3000 + i : 0, 0, 0);
+	*len = 48 + (i % 4) * 16;
+}
+
+static void populate(int count)
+{
+	for (int i = 0; i < count; i++) {
+		struct in6_addr addr;
+		uint8_t len;
+
+		route_prefix(i, &addr, &len);
+
+		routes[i] = net_route_add(iface, &addr, len,
+					  &nexthops[i % N_NEXTHOPS]);
+		check(routes[i] != NULL, "route add");
+	}
+
+	/* Destinations inside random routes, with random host bits */
+	for (int i = 0; i < N_DESTS; i++) {
+		uint8_t len;
+
+		route_prefix(sys_rand32_get() % count, &dests[i], &len);
+
+		dests[i].s6_addr16[7] = sys_rand32_get();
+	}
+}
+
+static void depopulate(int count)
+{
+	for (int i = 0; i < count; i++) {
+		net_route_del(routes[i]);
+	}
+}
+
+/* Returns the average number of cycles per lookup */
+static uint32_t run(bool same_dest)
+{
+	uint32_t start, cycles;
+
+	start = k_cycle_get_32();
+
+	for (int i = 0; i < N_LOOKUPS; i++) {
+		struct in6_addr *dst = &dests[same_dest ? 0 : i % N_DESTS];
+
+		check(net_route_lookup(iface, dst) != NULL, "lookup");
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	return cycles / N_LOOKUPS;
+}
+
+void main(void)
+{
+	setup();
+
+	for (int i = 0; i < ARRAY_SIZE(table_sizes); i++) {
+		uint32_t lookup, cached;
+
+		populate(table_sizes[i]);
+
+		lookup = run(false);
+		cached = run(true);
+
+		printk("routes %4d lookup %6u same dest %6u cycles\n",
+		       table_sizes[i], lookup, cached);
+
+		depopulate(table_sizes[i]);
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/net_core.h>
+#include <net/net_if.h>
+#include <net/net_pkt.h>
+#include <net/net_context.h>
+#include <net/dummy.h>
+
+#include "ipv6.h"
+#include "udp_internal.h"
+
+/* This benchmark measures the driver to socket RX path for bursts of
+ * small datagrams, submitted either one packet at a time or as a
+ * batch.  The packets are built before the measurement starts so that
+ * only the hand over to the stack and the processing up to the
+ * net_context receive callback are timed.
+ */
+
+#define MAX_BURST 32
+#define N_PKTS 1024
+#define PAYLOAD_LEN 64
+#define MY_PORT 4242
+#define PEER_PORT 4343
+
+static const int burst_sizes[] = { 1, 8, MAX_BURST };
+
+static struct in6_addr my_addr = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+				       0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+static struct in6_addr peer_addr = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+					 0, 0, 0, 0, 0, 0, 0, 0x2 } } };
+
+static uint8_t payload[PAYLOAD_LEN];
+static struct net_pkt *pkts[MAX_BURST];
+static struct net_if *iface;
+
+static int received;
+static int expected;
+static K_SEM_DEFINE(done_sem, 0, 1);
+
+static void check(bool ok, const char *what)
+{
+	if (!ok) {
+		printk("%s failed\n", what);
+		k_oops();
+	}
+}
+
+static void bench_iface_init(struct net_if *iface)
+{
+	static uint8_t mac[] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x01 };
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_DUMMY);
+}
+
+static int bench_send(const struct device *dev, struct net_pkt *pkt)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(pkt);
+
+	return 0;
+}
+
+static struct dummy_api bench_if_api = {
+	.iface_api.init = bench_iface_init,
+	.send = bench_send,
+};
+
+NET_DEVICE_INIT(net_rx_batch_bench, "net_rx_batch_bench", NULL, NULL,
+		NULL, NULL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+		&bench_if_api, DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 1280);
+
+static void recv_cb(struct net_context *context, struct net_pkt *pkt,
+		    union net_ip_header *ip_hdr,
+		    union net_proto_header *proto_hdr,
+		    int status, void *user_data)
+{
+	ARG_UNUSED(context);
+	ARG_UNUSED(ip_hdr);
+	ARG_UNUSED(proto_hdr);
+	ARG_UNUSED(status);
+	ARG_UNUSED(user_data);
+
+	net_pkt_unref(pkt);
+
+	if (++received == expected) {
+		k_sem_give(&done_sem);
+	}
+}
+
+static void setup(void)
+{
+	struct sockaddr_in6 addr = {
+		.sin6_family = AF_INET6,
+		.sin6_port = htons(MY_PORT),
+	};
+	struct net_context *ctx;
+
+	iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	check(iface != NULL, "iface");
+
+	check(net_if_ipv6_addr_add(iface, &my_addr, NET_ADDR_MANUAL, 0) != NULL,
+	      "address");
+
+	net_ipaddr_copy(&addr.sin6_addr, &my_addr);
+
+	check(net_context_get(AF_INET6, SOCK_DGRAM, IPPROTO_UDP, &ctx) == 0,
+	      "context");
+	check(net_context_bind(ctx, (struct sockaddr *)&addr,
+			       sizeof(addr)) == 0, "bind");
+	check(net_context_recv(ctx, recv_cb, K_NO_WAIT, NULL) == 0, "recv");
+}
+
+static struct net_pkt *make_pkt(void)
+{
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_rx_alloc_with_buffer(iface, PAYLOAD_LEN, AF_INET6,
+					   IPPROTO_UDP, K_FOREVER);
+	check(pkt != NULL, "alloc");
+
+	check(net_ipv6_create(pkt, &peer_addr, &my_addr) == 0, "ipv6");
+	check(net_udp_create(pkt, htons(PEER_PORT), htons(MY_PORT)) == 0,
+	      "udp");
+	check(net_pkt_write(pkt, payload, sizeof(payload)) == 0, "write");
+
+	net_pkt_cursor_init(pkt);
+	net_ipv6_finalize(pkt, IPPROTO_UDP);
+
+	return pkt;
+}
+
+/* Returns the average number of cycles per packet */
+static uint32_t run(int burst, bool batch)
+{
+	uint64_t total = 0;
+
+	for (int n = 0; n < N_PKTS; n += burst) {
+		uint32_t start;
+
+		for (int i = 0; i < burst; i++) {
+			pkts[i] = make_pkt();
+		}
+
+		received = 0;
+		expected = burst;
+
+		start = k_cycle_get_32();
+
+		if (batch) {
+			check(net_recv_data_batch(iface, pkts, burst) == 0,
+			      "net_recv_data_batch");
+		} else {
+			for (int i = 0; i < burst; i++) {
+				check(net_recv_data(iface, pkts[i]) == 0,
+				      "net_recv_data");
+			}
+		}
+
+		k_sem_take(&done_sem, K_FOREVER);
+
+		total += k_cycle_get_32() - start;
+	}
+
+	return total / N_PKTS;
+}
+
+void main(void)
+{
+	setup();
+
+	for (int i = 0; i < ARRAY_SIZE(burst_sizes); i++) {
+		uint32_t single = run(burst_sizes[i], false);
+		uint32_t batch = run(burst_sizes[i], true);
+
+		printk("burst %2d single %6u batch %6u cycles/pkt\n",
+		       burst_sizes[i], single, batch);
+	}
+
+	printk("fin\n");
+}
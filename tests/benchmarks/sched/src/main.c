@@ -32,6 +32,10 @@
 #define N_RUNS 1000
 #define N_SETTLE 10
 
+#if defined(CONFIG_SMP) && (CONFIG_MP_NUM_CPUS > 1)
+void smp_bench(void);
+#endif
+
 
 static K_THREAD_STACK_DEFINE(partner_stack, 1024);
 static struct k_thread partner_thread;
@@ -148,5 +152,9 @@ void main(void)
 		       stamps[4] - stamps[3],
 		       whole, avg);
 	}
+
+#if defined(CONFIG_SMP) && (CONFIG_MP_NUM_CPUS > 1)
+	smp_bench();
+#endif
 	printk("fin\n");
 }
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* SMP scaling benchmark.  For each N from 1 to the number of CPUs, a
+ * pair of equal-priority threads per active CPU spin calling k_yield()
+ * for a fixed period, so every iteration is a context switch through
+ * the scheduler.  The total switch count gives throughput, and the
+ * time spent per switch on each CPU gives the switch latency.  With a
+ * single global run queue and lock the per-switch latency grows with
+ * N; per-CPU run queues (CONFIG_SCHED_CPU_RUNQ) should keep it flat.
+ *
+ * With CONFIG_SCHED_CPU_MASK each pair is pinned to its own CPU,
+ * otherwise the threads are free to migrate.
+ */
+
+#define THREADS_PER_CPU 2
+#define NUM_THREADS (CONFIG_MP_NUM_CPUS * THREADS_PER_CPU)
+#define RUN_MS 1000
+#define STACK_SIZE 1024
+
+static K_THREAD_STACK_ARRAY_DEFINE(yield_stacks, NUM_THREADS, STACK_SIZE);
+static struct k_thread yield_threads[NUM_THREADS];
+static uint32_t yield_counts[NUM_THREADS];
+static volatile bool stop;
+
+static void yield_fn(void *arg1, void *arg2, void *arg3)
+{
+	uint32_t *count = arg1;
+
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	while (!stop) {
+		k_yield();
+		(*count)++;
+	}
+}
+
+static void run(int ncpus)
+{
+	int nthreads = ncpus * THREADS_PER_CPU;
+	int prio = k_thread_priority_get(k_current_get()) + 1;
+	uint64_t total = 0U;
+	uint32_t t0, cycles;
+
+	stop = false;
+
+	for (int i = 0; i < nthreads; i++) {
+		yield_counts[i] = 0U;
+		k_thread_create(&yield_threads[i], yield_stacks[i], STACK_SIZE,
+				yield_fn, &yield_counts[i], NULL, NULL,
+				prio, 0, K_FOREVER);
+#ifdef CONFIG_SCHED_CPU_MASK
+		k_thread_cpu_mask_clear(&yield_threads[i]);
+		k_thread_cpu_mask_enable(&yield_threads[i],
+					 i / THREADS_PER_CPU);
+#endif
+	}
+
+	t0 = k_cycle_get_32();
+	for (int i = 0; i < nthreads; i++) {
+		k_thread_start(&yield_threads[i]);
+	}
+
+	k_msleep(RUN_MS);
+	stop = true;
+	cycles = k_cycle_get_32() - t0;
+
+	for (int i = 0; i < nthreads; i++) {
+		k_thread_join(&yield_threads[i], K_FOREVER);
+		total += yield_counts[i];
+	}
+
+	if (total == 0U) {
+		total = 1U;
+	}
+
+	printk("smp cpus %d switches/s %8u cycles/switch %6u\n",
+	       ncpus, (uint32_t)(total * MSEC_PER_SEC / RUN_MS),
+	       (uint32_t)(((uint64_t)cycles * ncpus) / total));
+}
+
+void smp_bench(void)
+{
+	printk("smp scheduler: %s run queues\n",
+	       IS_ENABLED(CONFIG_SCHED_CPU_RUNQ) ? "per-CPU" : "global");
+
+	for (int n = 1; n <= CONFIG_MP_NUM_CPUS; n++) {
+		run(n);
+	}
+}
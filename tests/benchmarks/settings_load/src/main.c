@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <settings/settings.h>
+
+/* This benchmark measures the time taken by settings_load(), which is
+ * what an application does at boot, for an increasing number of items
+ * stored in the NVS backend. Every item is loaded through a static
+ * handler that reads its value, as a real handler would.
+ */
+
+#define MAX_ITEMS 256
+
+static const int item_counts[] = { 32, 128, MAX_ITEMS };
+
+static int loaded;
+
+static void check(bool ok, const char *what)
+{
+	if (!ok) {
+		printk("%s failed\n", what);
+		k_oops();
+	}
+}
+
+static int bench_set(const char *name, size_t len, settings_read_cb read_cb,
+		     void *cb_arg)
+{
+	uint32_t val;
+
+	ARG_UNUSED(name);
+
+	if (len != sizeof(val) || read_cb(cb_arg, &val, sizeof(val)) != len) {
+		return -EINVAL;
+	}
+
+	loaded++;
+
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(bench, "bench", NULL, bench_set, NULL, NULL);
+
+static void populate(int from, int to)
+{
+	char name[16];
+
+	for (uint32_t i = from; i < to; i++) {
+		snprintk(name, sizeof(name), "bench/item%u", i);
+		check(settings_save_one(name, &i, sizeof(i)) == 0, "save");
+	}
+}
+
+/* Returns the number of cycles taken by a settings_load() */
+static uint32_t run(int count)
+{
+	uint32_t start, cycles;
+
+	loaded = 0;
+
+	start = k_cycle_get_32();
+	check(settings_load() == 0, "load");
+	cycles = k_cycle_get_32() - start;
+
+	/* The flash of native_posix may keep items of an earlier run */
+	check(loaded >= count, "item count");
+
+	return cycles;
+}
+
+void main(void)
+{
+	int stored = 0;
+
+	check(settings_subsys_init() == 0, "init");
+
+	for (int i = 0; i < ARRAY_SIZE(item_counts); i++) {
+		populate(stored, item_counts[i]);
+		stored = item_counts[i];
+
+		printk("settings %4d load %10u cycles\n", stored, run(stored));
+	}
+
+	printk("fin\n");
+}
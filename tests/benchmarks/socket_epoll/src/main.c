@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/socket.h>
+
+/* This benchmark measures how the cost of collecting one ready socket
+ * scales with the number of idle sockets watched alongside it, for
+ * poll() and for epoll_wait().  A datagram is sent to the last socket
+ * of the set and, once it has been delivered, both calls are timed
+ * with a zero timeout so that only the collection cost is measured.
+ */
+
+#define MAX_SOCKS 64
+#define N_RUNS 100
+#define BASE_PORT 5000
+
+static const int sock_counts[] = { 4, 16, MAX_SOCKS };
+
+static int socks[MAX_SOCKS];
+static struct pollfd pfds[MAX_SOCKS];
+static struct sockaddr_in6 addrs[MAX_SOCKS];
+static int tx_sock;
+
+static void check(bool ok, const char *what)
+{
+	if (!ok) {
+		printk("%s failed %d\n", what, errno);
+		k_oops();
+	}
+}
+
+static void open_socks(int n)
+{
+	for (int i = 0; i < n; i++) {
+		addrs[i].sin6_family = AF_INET6;
+		addrs[i].sin6_port = htons(BASE_PORT + i);
+		inet_pton(AF_INET6, CONFIG_NET_CONFIG_MY_IPV6_ADDR,
+			  &addrs[i].sin6_addr);
+
+		socks[i] = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+		check(socks[i] >= 0, "socket");
+
+		check(bind(socks[i], (struct sockaddr *)&addrs[i],
+			   sizeof(addrs[i])) == 0, "bind");
+
+		pfds[i].fd = socks[i];
+		pfds[i].events = POLLIN;
+	}
+}
+
+static void close_socks(int n)
+{
+	for (int i = 0; i < n; i++) {
+		close(socks[i]);
+	}
+}
+
+static void run(int n)
+{
+	struct epoll_event ev, out[4];
+	uint64_t t_poll = 0U, t_epoll = 0U;
+	int target = n - 1;
+	char buf[4];
+	uint32_t t0, t1;
+	int epfd, res;
+
+	open_socks(n);
+
+	epfd = epoll_create1(0);
+	check(epfd >= 0, "epoll_create1");
+
+	for (int i = 0; i < n; i++) {
+		ev.events = EPOLLIN;
+		ev.data.fd = socks[i];
+		res = epoll_ctl(epfd, EPOLL_CTL_ADD, socks[i], &ev);
+		check(res == 0, "epoll_ctl");
+	}
+
+	for (int i = 0; i < N_RUNS; i++) {
+		(void)sendto(tx_sock, "x", 1, 0,
+			     (struct sockaddr *)&addrs[target],
+			     sizeof(addrs[target]));
+
+		/* Wait for the loopback delivery, level triggered so the
+		 * socket stays on the ready list for the measured call.
+		 */
+		res = epoll_wait(epfd, out, ARRAY_SIZE(out), -1);
+		check(res == 1, "epoll_wait");
+
+		t0 = k_cycle_get_32();
+		res = poll(pfds, n, 0);
+		t1 = k_cycle_get_32();
+		t_poll += t1 - t0;
+		check(res == 1, "epoll_wait");
+
+		t0 = k_cycle_get_32();
+		res = epoll_wait(epfd, out, ARRAY_SIZE(out), 0);
+		t1 = k_cycle_get_32();
+		t_epoll += t1 - t0;
+		check(res == 1 && out[0].data.fd == socks[target],
+		      "epoll_wait");
+
+		(void)recv(socks[target], buf, sizeof(buf), 0);
+	}
+
+	printk("sockets %3d poll %7u epoll_wait %7u\n", n,
+	       (uint32_t)(t_poll / N_RUNS), (uint32_t)(t_epoll / N_RUNS));
+
+	close(epfd);
+	close_socks(n);
+}
+
+void main(void)
+{
+	tx_sock = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+	check(tx_sock >= 0, "socket");
+
+	for (int i = 0; i < ARRAY_SIZE(sock_counts); i++) {
+		run(sock_counts[i]);
+	}
+
+	close(tx_sock);
+
+	printk("fin\n");
+}
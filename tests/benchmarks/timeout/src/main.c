@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <timeout_q.h>
+
+/* This is a timeout queue microbenchmark.  It fills the kernel
+ * timeout queue with a given number of idle timeouts, all expiring
+ * well after the benchmark is over, then times the individual queue
+ * primitives against that backlog.  Expiries are spread pseudo
+ * randomly so that a sorted list backend has to walk about half the
+ * queue on each insertion.
+ */
+
+#define MAX_PENDING 1000
+#define N_RUNS 200
+
+/* Far enough out that nothing fires while we measure */
+#define BASE_TICKS k_ms_to_ticks_ceil32(60 * MSEC_PER_SEC)
+
+static struct _timeout pending[MAX_PENDING];
+static struct _timeout probe;
+
+static const int pending_counts[] = { 10, 100, 1000 };
+
+static void timeout_fn(struct _timeout *t)
+{
+	ARG_UNUSED(t);
+}
+
+static uint32_t spread(uint32_t *seed)
+{
+	/* Plain LCG, good enough to avoid sorted insertion order */
+	*seed = *seed * 1103515245U + 12345U;
+
+	return (*seed >> 8) % (BASE_TICKS * 4U);
+}
+
+static void run(int npending)
+{
+	uint32_t seed = 0x1234U;
+	uint64_t add = 0U, cancel = 0U, next = 0U, rem = 0U;
+	unsigned int key;
+	uint32_t t0, t1;
+
+	for (int i = 0; i < npending; i++) {
+		z_init_timeout(&pending[i]);
+		z_add_timeout(&pending[i], timeout_fn,
+			      K_TICKS(BASE_TICKS + spread(&seed)));
+	}
+
+	for (int i = 0; i < N_RUNS; i++) {
+		k_timeout_t to = K_TICKS(BASE_TICKS + spread(&seed));
+
+		key = irq_lock();
+
+		t0 = k_cycle_get_32();
+		z_add_timeout(&probe, timeout_fn, to);
+		t1 = k_cycle_get_32();
+		add += t1 - t0;
+
+		t0 = k_cycle_get_32();
+		(void)z_timeout_remaining(&pending[npending / 2]);
+		t1 = k_cycle_get_32();
+		rem += t1 - t0;
+
+		t0 = k_cycle_get_32();
+		(void)z_get_next_timeout_expiry();
+		t1 = k_cycle_get_32();
+		next += t1 - t0;
+
+		t0 = k_cycle_get_32();
+		z_abort_timeout(&probe);
+		t1 = k_cycle_get_32();
+		cancel += t1 - t0;
+
+		irq_unlock(key);
+	}
+
+	for (int i = 0; i < npending; i++) {
+		z_abort_timeout(&pending[i]);
+	}
+
+	printk("pending %4d add %5u abort %5u next %5u remaining %5u\n",
+	       npending, (uint32_t)(add / N_RUNS), (uint32_t)(cancel / N_RUNS),
+	       (uint32_t)(next / N_RUNS), (uint32_t)(rem / N_RUNS));
+}
+
+void main(void)
+{
+	z_init_timeout(&probe);
+
+	printk("timeout queue backend: %s\n",
+	       IS_ENABLED(CONFIG_TIMEOUT_QUEUE_WHEEL) ? "wheel" : "dlist");
+
+	for (int i = 0; i < ARRAY_SIZE(pending_counts); i++) {
+		run(pending_counts[i]);
+	}
+
+	printk("fin\n");
+}
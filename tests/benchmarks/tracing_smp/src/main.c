@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* This benchmark measures the cost of putting CTF events in the tracing
+ * buffer when threads on several CPUs trace at the same time. Events
+ * are traced in bursts which fit in the buffer, the tracing thread
+ * outputs them while the threads sleep between two bursts, so that
+ * the events are not dropped and only their buffering is timed.
+ */
+
+#define MAX_THREADS CONFIG_MP_NUM_CPUS
+#define N_BURSTS 64
+#define BURST_SIZE 64
+#define STACK_SIZE 1024
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, MAX_THREADS, STACK_SIZE);
+static struct k_thread threads[MAX_THREADS];
+static uint64_t cycles[MAX_THREADS];
+static struct k_sem sem;
+
+static void worker(void *arg1, void *arg2, void *arg3)
+{
+	int id = POINTER_TO_INT(arg1);
+
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	cycles[id] = 0;
+
+	for (int i = 0; i < N_BURSTS; i++) {
+		uint32_t start = k_cycle_get_32();
+
+		for (int j = 0; j < BURST_SIZE; j++) {
+			sys_trace_k_sem_give_enter(&sem);
+		}
+
+		cycles[id] += k_cycle_get_32() - start;
+
+		k_sleep(K_MSEC(5));
+	}
+}
+
+static void run(int n_threads)
+{
+	int prio = k_thread_priority_get(k_current_get());
+	uint64_t total = 0;
+
+	for (int i = 0; i < n_threads; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE,
+				worker, INT_TO_POINTER(i), NULL, NULL,
+				prio, 0, K_NO_WAIT);
+	}
+
+	for (int i = 0; i < n_threads; i++) {
+		k_thread_join(&threads[i], K_FOREVER);
+		total += cycles[i];
+	}
+
+	total /= (uint64_t)n_threads * N_BURSTS * BURST_SIZE;
+
+	printk("threads %2d ns/event %6u\n", n_threads,
+	       (uint32_t)k_cyc_to_ns_floor64(total));
+}
+
+void main(void)
+{
+	k_sem_init(&sem, 0, 1);
+
+	for (int i = 1; i <= MAX_THREADS; i++) {
+		run(i);
+	}
+
+	printk("fin\n");
+}
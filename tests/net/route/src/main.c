@@ -67,6 +67,33 @@ static struct in6_addr in6addr_mcast = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
 static struct in6_addr generic_addr = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
 					    0, 0, 0, 0, 0xbe, 0xef, 0, 0 } } };
 
+/* Nested prefixes used by the longest prefix match tests */
+static struct in6_addr lpm_prefix32 = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+					    0, 0, 0, 0, 0, 0, 0, 0 } } };
+static struct in6_addr lpm_prefix64 = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 1,
+					    0, 0, 0, 0, 0, 0, 0, 0 } } };
+static struct in6_addr lpm_host = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 1,
+					0, 0, 0, 0, 0, 0, 0, 0x5 } } };
+
+/* Prefix routed through the peer interface only */
+static struct in6_addr lpm_peer64 = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 2,
+					  0, 0, 0, 0, 0, 0, 0, 0 } } };
+
+/* Destinations within (or outside) the prefixes above */
+static struct in6_addr lpm_dst64 = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 1,
+					 0, 0, 0, 0, 0, 0, 0, 0x77 } } };
+static struct in6_addr lpm_dst32 = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 3,
+					 0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+static struct in6_addr lpm_dst_peer = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 2,
+					    0, 0, 0, 0, 0, 0, 0, 0x9 } } };
+static struct in6_addr lpm_dst_none = { { { 0x20, 0x01, 0x0d, 0xb9, 0, 0, 0, 0,
+					    0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+
+static struct net_route_entry *lpm_route32;
+static struct net_route_entry *lpm_route64;
+static struct net_route_entry *lpm_route_host;
+static struct net_route_entry *lpm_route_peer;
+
 static struct net_if *recipient;
 static struct net_if *my_iface;
 static struct net_if *peer_iface;
@@ -473,6 +500,95 @@ static void test_route_del_many(void)
 	}
 }
 
+static void lpm_routes_add(void)
+{
+	/* Longer prefixes first, adding a route looks up its prefix */
+	lpm_route_host = net_route_add(my_iface, &lpm_host, 128, &peer_addr);
+	zassert_not_null(lpm_route_host, "Route add /128 failed");
+
+	lpm_route64 = net_route_add(my_iface, &lpm_prefix64, 64, &peer_addr);
+	zassert_not_null(lpm_route64, "Route add /64 failed");
+
+	lpm_route32 = net_route_add(my_iface, &lpm_prefix32, 32, &peer_addr);
+	zassert_not_null(lpm_route32, "Route add /32 failed");
+}
+
+static void test_route_lpm_nested(void)
+{
+	lpm_routes_add();
+
+	zassert_equal_ptr(net_route_lookup(my_iface, &lpm_host),
+			  lpm_route_host, "/128 route not selected");
+	zassert_equal_ptr(net_route_lookup(my_iface, &lpm_dst64),
+			  lpm_route64, "/64 route not selected");
+	zassert_equal_ptr(net_route_lookup(my_iface, &lpm_dst32),
+			  lpm_route32, "/32 route not selected");
+	zassert_is_null(net_route_lookup(my_iface, &lpm_dst_none),
+			"Route found outside of all prefixes");
+}
+
+static void test_route_lpm_iface(void)
+{
+	struct net_nbr *nbr;
+
+	nbr = net_ipv6_nbr_add(peer_iface, &peer_addr,
+			       &net_route_data_peer.ll_addr, false,
+			       NET_IPV6_NBR_STATE_REACHABLE);
+	zassert_not_null(nbr, "Cannot add peer to neighbor cache");
+
+	lpm_route_peer = net_route_add(peer_iface, &lpm_peer64, 64,
+				       &peer_addr);
+	zassert_not_null(lpm_route_peer, "Route add on peer failed");
+
+	/* The longer prefix is on another interface */
+	zassert_equal_ptr(net_route_lookup(my_iface, &lpm_dst_peer),
+			  lpm_route32, "Route of other interface selected");
+	zassert_equal_ptr(net_route_lookup(peer_iface, &lpm_dst_peer),
+			  lpm_route_peer, "Peer route not selected");
+	zassert_is_null(net_route_lookup(peer_iface, &lpm_dst64),
+			"Route of other interface selected");
+
+	zassert_equal(net_route_del(lpm_route_peer), 0,
+		      "Route del on peer failed");
+	zassert_is_null(net_route_lookup(peer_iface, &lpm_dst_peer),
+			"Deleted route selected");
+}
+
+static void test_route_lpm_del(void)
+{
+	int i;
+
+	/* Removing the middle prefix falls back to the shorter one */
+	zassert_equal(net_route_del(lpm_route64), 0, "Route del /64 failed");
+	zassert_equal_ptr(net_route_lookup(my_iface, &lpm_dst64),
+			  lpm_route32, "/32 route not selected");
+	zassert_equal_ptr(net_route_lookup(my_iface, &lpm_host),
+			  lpm_route_host, "/128 route not selected");
+
+	zassert_equal(net_route_del(lpm_route32), 0, "Route del /32 failed");
+	zassert_is_null(net_route_lookup(my_iface, &lpm_dst32),
+			"Deleted /32 route selected");
+
+	zassert_equal(net_route_del(lpm_route_host), 0,
+		      "Route del /128 failed");
+	zassert_is_null(net_route_lookup(my_iface, &lpm_host),
+			"Deleted /128 route selected");
+
+	/* Index nodes must be released on delete, or adding the routes
+	 * again would run out of them.
+	 */
+	for (i = 0; i < 2 * MAX_ROUTES; i++) {
+		lpm_routes_add();
+
+		zassert_equal(net_route_del(lpm_route64), 0, NULL);
+		zassert_equal(net_route_del(lpm_route_host), 0, NULL);
+		zassert_equal(net_route_del(lpm_route32), 0, NULL);
+	}
+
+	zassert_is_null(net_route_lookup(my_iface, &lpm_dst64),
+			"Route found in an empty table");
+}
+
 /*test case main entry*/
 void test_main(void)
 {
@@ -492,6 +608,9 @@ void test_main(void)
 			ztest_unit_test(test_route_del_nexthop_again),
 			ztest_unit_test(test_populate_nbr_cache),
 			ztest_unit_test(test_route_add_many),
-			ztest_unit_test(test_route_del_many));
+			ztest_unit_test(test_route_del_many),
+			ztest_unit_test(test_route_lpm_nested),
+			ztest_unit_test(test_route_lpm_iface),
+			ztest_unit_test(test_route_lpm_del));
 	ztest_run_test_suite(test_route);
 }
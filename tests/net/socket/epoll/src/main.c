@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <stdio.h>
+#include <ztest_assert.h>
+
+#include <net/socket.h>
+#include <sys/fdtable.h>
+
+#include "../../socket_helpers.h"
+
+#define BUF_AND_SIZE(buf) buf, sizeof(buf) - 1
+#define STRLEN(buf) (sizeof(buf) - 1)
+
+#define TEST_STR_SMALL "test"
+
+#define SERVER_PORT 4242
+#define CLIENT_PORT 9898
+
+/* Loopback delivery goes through the RX thread */
+#define WAIT_MS 100
+
+static int c_sock;
+static int s_sock;
+static int s_sock2;
+
+static void setup_socks(void)
+{
+	struct sockaddr_in6 c_addr;
+	struct sockaddr_in6 s_addr;
+	struct sockaddr_in6 s_addr2;
+	int res;
+
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, CLIENT_PORT,
+			    &c_sock, &c_addr);
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT,
+			    &s_sock, &s_addr);
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT + 1,
+			    &s_sock2, &s_addr2);
+
+	res = bind(s_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "bind failed");
+
+	res = bind(s_sock2, (struct sockaddr *)&s_addr2, sizeof(s_addr2));
+	zassert_equal(res, 0, "bind failed");
+
+	res = connect(c_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "connect failed");
+}
+
+static void send_small(void)
+{
+	ssize_t len;
+
+	len = send(c_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid send len");
+}
+
+static void recv_small(int sock)
+{
+	char buf[10];
+	ssize_t len;
+
+	len = recv(sock, buf, sizeof(buf), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid recv len");
+}
+
+void test_epoll(void)
+{
+	struct epoll_event ev;
+	struct epoll_event events[2];
+	int epfd;
+	int res;
+
+	setup_socks();
+
+	epfd = epoll_create1(0);
+	zassert_true(epfd >= 0, "epoll_create1 failed");
+
+	ev.events = EPOLLIN;
+	ev.data.fd = s_sock;
+	res = epoll_ctl(epfd, EPOLL_CTL_ADD, s_sock, &ev);
+	zassert_equal(res, 0, "epoll_ctl failed");
+
+	res = epoll_ctl(epfd, EPOLL_CTL_ADD, s_sock, &ev);
+	zassert_equal(res, -1, "double add should fail");
+	zassert_equal(errno, EEXIST, "");
+
+	ev.data.fd = s_sock2;
+	res = epoll_ctl(epfd, EPOLL_CTL_ADD, s_sock2, &ev);
+	zassert_equal(res, 0, "epoll_ctl failed");
+
+	/* Nothing is ready */
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	/* Only the socket with data is reported */
+	send_small();
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), WAIT_MS);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].events, EPOLLIN, "");
+	zassert_equal(events[0].data.fd, s_sock, "");
+
+	/* Level triggered, reported again until the data is read */
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].data.fd, s_sock, "");
+
+	recv_small(s_sock);
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	/* Edge triggered, reported once per arriving packet */
+	ev.events = EPOLLIN | EPOLLET;
+	ev.data.fd = s_sock;
+	res = epoll_ctl(epfd, EPOLL_CTL_MOD, s_sock, &ev);
+	zassert_equal(res, 0, "epoll_ctl failed");
+
+	send_small();
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), WAIT_MS);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].data.fd, s_sock, "");
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	recv_small(s_sock);
+
+	/* One shot, disabled after the first event until re-armed */
+	ev.events = EPOLLIN | EPOLLONESHOT;
+	res = epoll_ctl(epfd, EPOLL_CTL_MOD, s_sock, &ev);
+	zassert_equal(res, 0, "epoll_ctl failed");
+
+	send_small();
+	send_small();
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), WAIT_MS);
+	zassert_equal(res, 1, "");
+
+	recv_small(s_sock);
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), WAIT_MS);
+	zassert_equal(res, 0, "");
+
+	res = epoll_ctl(epfd, EPOLL_CTL_MOD, s_sock, &ev);
+	zassert_equal(res, 0, "epoll_ctl failed");
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 1, "re-armed socket with data not reported");
+
+	recv_small(s_sock);
+
+	/* Removing entries */
+	res = epoll_ctl(epfd, EPOLL_CTL_DEL, s_sock, NULL);
+	zassert_equal(res, 0, "epoll_ctl failed");
+
+	res = epoll_ctl(epfd, EPOLL_CTL_DEL, s_sock, NULL);
+	zassert_equal(res, -1, "double delete should fail");
+	zassert_equal(errno, ENOENT, "");
+
+	/* Closing a socket drops it from the instance */
+	res = close(s_sock2);
+	zassert_equal(res, 0, "close failed");
+
+	res = epoll_ctl(epfd, EPOLL_CTL_DEL, s_sock2, NULL);
+	zassert_equal(res, -1, "closed socket should be gone");
+	zassert_equal(errno, ENOENT, "");
+
+	res = close(epfd);
+	zassert_equal(res, 0, "close failed");
+
+	res = close(c_sock);
+	zassert_equal(res, 0, "close failed");
+
+	res = close(s_sock);
+	zassert_equal(res, 0, "close failed");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(socket_epoll,
+			 ztest_unit_test(test_epoll));
+
+	ztest_run_test_suite(socket_epoll);
+}
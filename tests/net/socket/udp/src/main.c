@@ -14,6 +14,7 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
 
 #include <net/socket.h>
 #include <net/ethernet.h>
+#include <net/net_pkt.h>
 
 #include "ipv6.h"
 #include "../../socket_helpers.h"
@@ -1212,6 +1213,130 @@ void test_v6_msg_trunc(void)
 		       (struct sockaddr *)&server_addr, sizeof(server_addr));
 }
 
+static struct net_buf *zerocopy_alloc(const char *data, size_t len)
+{
+	struct net_buf *frags = NULL;
+
+	while (len > 0) {
+		struct net_buf *frag;
+		size_t chunk;
+
+		frag = net_pkt_get_reserve_tx_data(K_NO_WAIT);
+		zassert_not_null(frag, "cannot allocate data buffer");
+
+		chunk = MIN(len, net_buf_tailroom(frag));
+		net_buf_add_mem(frag, data, chunk);
+		data += chunk;
+		len -= chunk;
+
+		if (frags) {
+			net_buf_frag_add(frags, frag);
+		} else {
+			frags = frag;
+		}
+	}
+
+	return frags;
+}
+
+static void test_zerocopy(int sock_c, int sock_s, struct sockaddr *addr_c,
+			  socklen_t addrlen_c, struct sockaddr *addr_s,
+			  socklen_t addrlen_s)
+{
+	struct sockaddr addr;
+	socklen_t addrlen;
+	struct net_buf *frags;
+	ssize_t rv;
+
+	rv = bind(sock_s, addr_s, addrlen_s);
+	zassert_equal(rv, 0, "server bind failed");
+
+	frags = zerocopy_alloc(BUF_AND_SIZE(TEST_STR2));
+	zassert_not_null(frags->frags, "data should span several buffers");
+
+	rv = zsock_send_buf(sock_c, frags, 0, addr_s, addrlen_s);
+	zassert_equal(rv, STRLEN(TEST_STR2), "zsock_send_buf failed");
+
+	addrlen = sizeof(addr);
+	frags = NULL;
+	rv = zsock_recv_buf(sock_s, &frags, 0, &addr, &addrlen);
+	zassert_equal(rv, STRLEN(TEST_STR2), "zsock_recv_buf failed");
+	zassert_not_null(frags, "no data returned");
+	zassert_equal(net_buf_frags_len(frags), STRLEN(TEST_STR2),
+		      "invalid fragment length");
+	zassert_equal(addrlen, addrlen_c, "unexpected addrlen");
+
+	clear_buf(rx_buf);
+	net_buf_linearize(rx_buf, sizeof(rx_buf), frags, 0,
+			  STRLEN(TEST_STR2));
+	zassert_mem_equal(rx_buf, BUF_AND_SIZE(TEST_STR2), "wrong data");
+
+	/* Received fragments can be sent back as they are */
+	rv = zsock_send_buf(sock_s, frags, 0, &addr, addrlen);
+	zassert_equal(rv, STRLEN(TEST_STR2), "zsock_send_buf reply failed");
+
+	clear_buf(rx_buf);
+	rv = recv(sock_c, rx_buf, sizeof(rx_buf), 0);
+	zassert_equal(rv, STRLEN(TEST_STR2), "recv failed");
+	zassert_mem_equal(rx_buf, BUF_AND_SIZE(TEST_STR2), "wrong data");
+
+	/* Peeking would need to keep the data in the socket */
+	rv = zsock_recv_buf(sock_s, &frags, ZSOCK_MSG_PEEK, NULL, NULL);
+	zassert_equal(rv, -1, "MSG_PEEK should fail");
+	zassert_equal(errno, EINVAL, "incorrect errno value");
+
+	rv = zsock_recv_buf(sock_s, &frags, ZSOCK_MSG_DONTWAIT, NULL, NULL);
+	zassert_equal(rv, -1, "recv should have failed");
+	zassert_equal(errno, EAGAIN, "incorrect errno value");
+
+	rv = close(sock_c);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(sock_s);
+	zassert_equal(rv, 0, "close failed");
+}
+
+void test_v4_zerocopy(void)
+{
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+
+	if (!IS_ENABLED(CONFIG_NET_SOCKETS_ZEROCOPY)) {
+		ztest_test_skip();
+	}
+
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &client_sock, &client_addr);
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &server_sock, &server_addr);
+
+	test_zerocopy(client_sock, server_sock,
+		      (struct sockaddr *)&client_addr, sizeof(client_addr),
+		      (struct sockaddr *)&server_addr, sizeof(server_addr));
+}
+
+void test_v6_zerocopy(void)
+{
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in6 client_addr;
+	struct sockaddr_in6 server_addr;
+
+	if (!IS_ENABLED(CONFIG_NET_SOCKETS_ZEROCOPY)) {
+		ztest_test_skip();
+	}
+
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, ANY_PORT,
+			    &client_sock, &client_addr);
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT,
+			    &server_sock, &server_addr);
+
+	test_zerocopy(client_sock, server_sock,
+		      (struct sockaddr *)&client_addr, sizeof(client_addr),
+		      (struct sockaddr *)&server_addr, sizeof(server_addr));
+}
+
 void test_main(void)
 {
 	k_thread_system_pool_assign(k_current_get());
@@ -1242,7 +1367,9 @@ void test_main(void)
 			 ztest_unit_test(test_v6_sendmsg_with_txtime),
 			 ztest_user_unit_test(test_v6_sendmsg_with_txtime),
 			 ztest_unit_test(test_v4_msg_trunc),
-			 ztest_unit_test(test_v6_msg_trunc)
+			 ztest_unit_test(test_v6_msg_trunc),
+			 ztest_unit_test(test_v4_zerocopy),
+			 ztest_unit_test(test_v6_zerocopy)
 		);
 
 	ztest_run_test_suite(socket_udp);
@@ -125,6 +125,9 @@ static void handle_syn_resend(void);
 static void handle_client_fin_wait_2_test(sa_family_t af, struct tcphdr *th);
 static void handle_client_closing_test(sa_family_t af, struct tcphdr *th);
 static void handle_server_recv_out_of_order(struct net_pkt *pkt);
+static void handle_client_fast_retransmit_test(sa_family_t af,
+					       struct tcphdr *th);
+static void handle_server_recv_coalesced_data(struct tcphdr *th);
 
 static void verify_flags(struct tcphdr *th, uint8_t flags,
 			 const char *fun, int line)
@@ -420,6 +423,12 @@ static int tester_send(const struct device *dev, struct net_pkt *pkt)
 	case 9:
 		handle_server_recv_out_of_order(pkt);
 		break;
+	case 10:
+		handle_client_fast_retransmit_test(net_pkt_family(pkt), &th);
+		break;
+	case 11:
+		handle_server_recv_coalesced_data(&th);
+		break;
 	default:
 		zassert_true(false, "Undefined test case");
 	}
@@ -1484,6 +1493,224 @@ static void test_server_timeout_out_of_order_data(void)
 	net_tcp_put(ooo_ctx);
 }
 
+#define FAST_REXMIT_SEGMENTS 4
+static uint32_t lost_seq;
+static bool data_lost;
+static int64_t data_sent_time;
+
+static void handle_client_fast_retransmit_test(sa_family_t af,
+					       struct tcphdr *th)
+{
+	struct net_pkt *reply;
+	int ret;
+
+	switch (t_state) {
+	case T_SYN:
+		test_verify_flags(th, SYN);
+		seq = 0U;
+		ack = ntohl(th->th_seq) + 1U;
+		reply = prepare_syn_ack_packet(af, htons(MY_PORT),
+					       th->th_sport);
+		t_state = T_SYN_ACK;
+		break;
+	case T_SYN_ACK:
+		test_verify_flags(th, ACK);
+		seq = 1U;
+		lost_seq = ack;
+		t_state = T_DATA;
+		test_sem_give();
+		return;
+	case T_DATA:
+		test_verify_flags(th, PSH | ACK);
+
+		if (ntohl(th->th_seq) != lost_seq) {
+			/* The first segment is missing, every segment after
+			 * it generates a duplicate ACK.
+			 */
+			ack = lost_seq;
+			reply = prepare_ack_packet(af, htons(MY_PORT),
+						   th->th_sport);
+			break;
+		}
+
+		if (!data_lost) {
+			/* Drop the first data segment */
+			data_lost = true;
+			return;
+		}
+
+		/* The lost segment was retransmitted before the RTO */
+		zassert_true(k_uptime_get() - data_sent_time <
+			     CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT,
+			     "Segment was not fast retransmitted");
+
+		ack = lost_seq + FAST_REXMIT_SEGMENTS;
+		reply = prepare_ack_packet(af, htons(MY_PORT), th->th_sport);
+		t_state = T_FIN;
+		test_sem_give();
+		break;
+	case T_FIN:
+		test_verify_flags(th, FIN | ACK);
+		ack = ntohl(th->th_seq) + 1U;
+		t_state = T_FIN_ACK;
+		reply = prepare_fin_ack_packet(af, htons(MY_PORT),
+					       th->th_sport);
+		break;
+	case T_FIN_ACK:
+		test_verify_flags(th, ACK);
+		test_sem_give();
+		return;
+	default:
+		zassert_true(false, "%s unexpected state", __func__);
+		return;
+	}
+
+	ret = net_recv_data(iface, reply);
+	if (ret < 0) {
+		goto fail;
+	}
+
+	return;
+fail:
+	zassert_true(false, "%s failed", __func__);
+}
+
+/* Test case scenario IPv4
+ *   send SYN,
+ *   expect SYN ACK,
+ *   send ACK,
+ *   send 4 data segments, the first one is lost,
+ *   expect 3 duplicate ACKs,
+ *   retransmit the lost segment before the RTO expires,
+ *   expect ACK,
+ *   send FIN,
+ *   expect FIN ACK,
+ *   send ACK.
+ *   any failures cause test case to fail.
+ */
+static void test_client_fast_retransmit(void)
+{
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	struct net_context *ctx;
+	struct tcp *conn;
+	int ret, i;
+
+	t_state = T_SYN;
+	test_case_no = 10;
+	seq = ack = 0;
+	data_lost = false;
+
+	ret = net_context_get(AF_INET, SOCK_STREAM, IPPROTO_TCP, &ctx);
+	if (ret < 0) {
+		zassert_true(false, "Failed to get net_context");
+	}
+
+	net_context_ref(ctx);
+
+	ret = net_context_connect(ctx, (struct sockaddr *)&peer_addr_s,
+				  sizeof(struct sockaddr_in),
+				  NULL,
+				  K_MSEC(100), NULL);
+	if (ret < 0) {
+		zassert_true(false, "Failed to connect to peer");
+	}
+
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	data_sent_time = k_uptime_get();
+
+	for (i = 0; i < FAST_REXMIT_SEGMENTS; i++) {
+		ret = net_context_send(ctx, &lorem_ipsum[i], 1, NULL,
+				       K_NO_WAIT, NULL);
+		if (ret < 0) {
+			zassert_true(false, "Failed to send data to peer");
+		}
+	}
+
+	/* Peer will release the semaphore after it has received the
+	 * retransmitted segment.
+	 */
+	test_sem_take(K_MSEC(CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT),
+		      __LINE__);
+
+	conn = ctx->tcp;
+	zassert_equal(conn->fast_rexmits, 1, "Unexpected fast retransmits %u",
+		      conn->fast_rexmits);
+
+	net_tcp_put(ctx);
+
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	k_sleep(K_MSEC(CONFIG_NET_TCP_TIME_WAIT_DELAY));
+#else
+	ztest_test_skip();
+#endif
+}
+
+#define GRO_SEGMENTS 4
+#define GRO_SEGMENT_LEN 10
+static int gro_acks;
+static uint32_t gro_last_ack;
+
+static void handle_server_recv_coalesced_data(struct tcphdr *th)
+{
+	if (th->th_flags != ACK) {
+		return;
+	}
+
+	gro_acks++;
+	gro_last_ack = ntohl(th->th_ack);
+}
+
+/* Test case scenario
+ *   Expect a listening server,
+ *   establish a connection,
+ *   hand in-order data segments over in one burst, PSH on the last one,
+ *   expect a single ACK covering all of them.
+ */
+static void test_server_recv_coalesced_data(void)
+{
+#if defined(CONFIG_NET_TCP_GRO)
+	const uint8_t *data = lorem_ipsum;
+	struct net_pkt *pkts[GRO_SEGMENTS];
+	struct net_context *ctx;
+	uint32_t start_seq;
+	int ret, i;
+
+	ctx = create_server_socket(0, 0);
+
+	test_case_no = 11;
+	gro_acks = 0;
+	start_seq = seq;
+
+	for (i = 0; i < GRO_SEGMENTS; i++) {
+		pkts[i] = tester_prepare_tcp_pkt(AF_INET6, htons(MY_PORT),
+						 htons(PEER_PORT),
+						 i == GRO_SEGMENTS - 1 ?
+						 PSH | ACK : ACK,
+						 &data[i * GRO_SEGMENT_LEN],
+						 GRO_SEGMENT_LEN);
+		zassert_not_null(pkts[i], "Cannot create pkt");
+
+		seq += GRO_SEGMENT_LEN;
+	}
+
+	ret = net_recv_data_batch(iface, pkts, GRO_SEGMENTS);
+	zassert_equal(ret, 0, "recv data batch failed (%d)", ret);
+
+	/* Let the RX thread process the burst */
+	k_msleep(50);
+
+	zassert_equal(gro_acks, 1, "Expected a single ACK, got %d", gro_acks);
+	zassert_equal(gro_last_ack, start_seq + GRO_SEGMENTS * GRO_SEGMENT_LEN,
+		      "Not all data acknowledged (ack %u)", gro_last_ack);
+
+	net_tcp_put(ctx);
+#else
+	ztest_test_skip();
+#endif
+}
+
 /** Test case main entry */
 void test_main(void)
 {
@@ -1499,7 +1726,9 @@ void test_main(void)
 			 ztest_unit_test(test_client_closing_ipv6),
 			 ztest_unit_test(test_client_invalid_rst),
 			 ztest_unit_test(test_server_recv_out_of_order_data),
-			 ztest_unit_test(test_server_timeout_out_of_order_data)
+			 ztest_unit_test(test_server_timeout_out_of_order_data),
+			 ztest_unit_test(test_client_fast_retransmit),
+			 ztest_unit_test(test_server_recv_coalesced_data)
 			 );
 
 	ztest_run_test_suite(test_tcp_fn);
@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2021 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <zephyr/types.h>
+#include <ztest.h>
+#include <storage/disk_access.h>
+#include <drivers/disk.h>
+
+#define DISK_NAME "CACHE"
+#define SECTOR_SIZE CONFIG_DISK_CACHE_SECTOR_SIZE
+#define SECTOR_COUNT 64
+#define MAX_CALLS 16
+
+/* The tests below expect a cache of 4 blocks with 2 sector requests */
+BUILD_ASSERT(CONFIG_DISK_CACHE_BLOCKS == 4);
+BUILD_ASSERT(CONFIG_DISK_CACHE_MAX_IO == 2);
+BUILD_ASSERT(CONFIG_DISK_CACHE_FLUSH_DELAY == 0);
+
+/* Driver call seen by the RAM disk below */
+struct disk_call {
+	bool write;
+	uint32_t sector;
+	uint32_t count;
+};
+
+static uint8_t ram_disk[SECTOR_COUNT][SECTOR_SIZE];
+static struct disk_call calls[MAX_CALLS];
+static int call_count;
+
+static uint8_t buf[4 * SECTOR_SIZE];
+
+static void log_call(bool write, uint32_t sector, uint32_t count)
+{
+	zassert_true(call_count < MAX_CALLS, "too many driver calls");
+
+	calls[call_count].write = write;
+	calls[call_count].sector = sector;
+	calls[call_count].count = count;
+	call_count++;
+}
+
+static int ram_init(struct disk_info *disk)
+{
+	return 0;
+}
+
+static int ram_status(struct disk_info *disk)
+{
+	return DISK_STATUS_OK;
+}
+
+static int ram_read(struct disk_info *disk, uint8_t *data_buf,
+		    uint32_t start_sector, uint32_t num_sector)
+{
+	zassert_true(start_sector + num_sector <= SECTOR_COUNT,
+		     "read past the end of the disk");
+
+	log_call(false, start_sector, num_sector);
+	memcpy(data_buf, ram_disk[start_sector], num_sector * SECTOR_SIZE);
+
+	return 0;
+}
+
+static int ram_write(struct disk_info *disk, const uint8_t *data_buf,
+		     uint32_t start_sector, uint32_t num_sector)
+{
+	zassert_true(start_sector + num_sector <= SECTOR_COUNT,
+		     "write past the end of the disk");
+
+	log_call(true, start_sector, num_sector);
+	memcpy(ram_disk[start_sector], data_buf, num_sector * SECTOR_SIZE);
+
+	return 0;
+}
+
+static int ram_ioctl(struct disk_info *disk, uint8_t cmd, void *buff)
+{
+	switch (cmd) {
+	case DISK_IOCTL_CTRL_SYNC:
+		break;
+	case DISK_IOCTL_GET_SECTOR_COUNT:
+		*(uint32_t *)buff = SECTOR_COUNT;
+		break;
+	case DISK_IOCTL_GET_SECTOR_SIZE:
+		*(uint32_t *)buff = SECTOR_SIZE;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static const struct disk_operations ram_ops = {
+	.init = ram_init,
+	.status = ram_status,
+	.read = ram_read,
+	.write = ram_write,
+	.ioctl = ram_ioctl,
+};
+
+static struct disk_info ram_disk_info = {
+	.name = DISK_NAME,
+	.ops = &ram_ops,
+};
+
+/* Start with an empty cache, then fill each sector with its number */
+static void disk_reset(void)
+{
+	int rc;
+
+	/* Init writes back and forgets what was cached before */
+	rc = disk_access_init(DISK_NAME);
+	zassert_equal(rc, 0, "disk init failed");
+
+	for (int i = 0; i < SECTOR_COUNT; i++) {
+		memset(ram_disk[i], i, SECTOR_SIZE);
+	}
+
+	call_count = 0;
+}
+
+static void check_call(int i, bool write, uint32_t sector, uint32_t count)
+{
+	zassert_true(i < call_count, "driver call %d missing", i);
+	zassert_equal(calls[i].write, write, "wrong direction of call %d", i);
+	zassert_equal(calls[i].sector, sector, "wrong sector in call %d", i);
+	zassert_equal(calls[i].count, count, "wrong count in call %d", i);
+}
+
+static void read_sector(uint32_t sector)
+{
+	int rc;
+
+	rc = disk_access_read(DISK_NAME, buf, sector, 1);
+	zassert_equal(rc, 0, "read of sector %u failed", sector);
+	zassert_equal(buf[0], ram_disk[sector][0],
+		      "wrong data in sector %u", sector);
+}
+
+/*
+ * Test that a miss evicts the least recently used sector, a hit making a
+ * sector the most recently used one.
+ */
+static void test_lru_eviction(void)
+{
+	disk_reset();
+
+	/* Sectors apart from each other are not read ahead */
+	read_sector(10);
+	read_sector(20);
+	read_sector(30);
+	read_sector(40);
+	zassert_equal(call_count, 4, "misses not read from the disk");
+
+	/* Hit, 20 is the least recently used sector now */
+	read_sector(10);
+	zassert_equal(call_count, 4, "hit read from the disk");
+
+	read_sector(50);
+	zassert_equal(call_count, 5, "miss not read from the disk");
+	check_call(4, false, 50, 1);
+
+	read_sector(30);
+	read_sector(40);
+	read_sector(10);
+	zassert_equal(call_count, 5, "wrong sector evicted");
+
+	read_sector(20);
+	zassert_equal(call_count, 6, "evicted sector still cached");
+	check_call(5, false, 20, 1);
+}
+
+/*
+ * Test that sequential reads fetch the following sector along, and that
+ * it is then served from the cache.
+ */
+static void test_read_ahead(void)
+{
+	disk_reset();
+
+	read_sector(20);
+	zassert_equal(call_count, 1, "miss not read from the disk");
+	check_call(0, false, 20, 1);
+
+	/* Follows the previous read */
+	read_sector(21);
+	zassert_equal(call_count, 2, "miss not read from the disk");
+	check_call(1, false, 21, 2);
+
+	read_sector(22);
+	zassert_equal(call_count, 2, "read ahead sector not cached");
+
+	/* Not read ahead past the end of the disk */
+	read_sector(SECTOR_COUNT - 2);
+	read_sector(SECTOR_COUNT - 1);
+	check_call(3, false, SECTOR_COUNT - 1, 1);
+}
+
+/*
+ * Test that writes stay in the cache until a sync, which writes the
+ * dirty sectors back sorted and in runs of consecutive sectors.
+ */
+static void test_sync_write_back(void)
+{
+	int rc;
+
+	disk_reset();
+
+	for (uint32_t sector = 5; sector >= 3; sector--) {
+		memset(buf, 0xa0 + sector, SECTOR_SIZE);
+		rc = disk_access_write(DISK_NAME, buf, sector, 1);
+		zassert_equal(rc, 0, "write of sector %u failed", sector);
+	}
+
+	zassert_equal(call_count, 0, "write not cached");
+	zassert_equal(ram_disk[4][0], 4, "disk written before sync");
+
+	rc = disk_access_read(DISK_NAME, buf, 4, 1);
+	zassert_equal(rc, 0, "read failed");
+	zassert_equal(buf[0], 0xa4, "written data not read back");
+	zassert_equal(call_count, 0, "dirty sector read from the disk");
+
+	rc = disk_access_ioctl(DISK_NAME, DISK_IOCTL_CTRL_SYNC, NULL);
+	zassert_equal(rc, 0, "sync failed");
+
+	zassert_equal(call_count, 2, "wrong number of write backs");
+	check_call(0, true, 3, 2);
+	check_call(1, true, 5, 1);
+
+	for (uint32_t sector = 3; sector <= 5; sector++) {
+		zassert_equal(ram_disk[sector][0], 0xa0 + sector,
+			      "sector %u not written back", sector);
+		zassert_equal(ram_disk[sector][SECTOR_SIZE - 1], 0xa0 + sector,
+			      "sector %u not written back", sector);
+	}
+
+	rc = disk_access_ioctl(DISK_NAME, DISK_IOCTL_CTRL_SYNC, NULL);
+	zassert_equal(rc, 0, "sync failed");
+	zassert_equal(call_count, 2, "clean sectors written back");
+}
+
+/*
+ * Test that large requests bypass the cache, reads seeing the dirty
+ * sectors not yet written back, and writes replacing them.
+ */
+static void test_direct_io(void)
+{
+	int rc;
+
+	disk_reset();
+
+	memset(buf, 0xd6, SECTOR_SIZE);
+	rc = disk_access_write(DISK_NAME, buf, 6, 1);
+	zassert_equal(rc, 0, "write failed");
+	zassert_equal(call_count, 0, "write not cached");
+
+	rc = disk_access_read(DISK_NAME, buf, 4, 4);
+	zassert_equal(rc, 0, "direct read failed");
+	zassert_equal(call_count, 1, "direct read not done at once");
+	check_call(0, false, 4, 4);
+
+	zassert_equal(buf[0], 4, "wrong data from the disk");
+	zassert_equal(buf[SECTOR_SIZE], 5, "wrong data from the disk");
+	zassert_equal(buf[2 * SECTOR_SIZE], 0xd6, "dirty sector not overlaid");
+	zassert_equal(buf[3 * SECTOR_SIZE - 1], 0xd6,
+		      "dirty sector not overlaid");
+	zassert_equal(buf[3 * SECTOR_SIZE], 7, "wrong data from the disk");
+	zassert_equal(ram_disk[6][0], 6, "disk written before sync");
+
+	memset(buf, 0xe0, sizeof(buf));
+	rc = disk_access_write(DISK_NAME, buf, 4, 4);
+	zassert_equal(rc, 0, "direct write failed");
+	zassert_equal(call_count, 2, "direct write not done at once");
+	check_call(1, true, 4, 4);
+
+	/* The outdated dirty sector is not written back */
+	rc = disk_access_ioctl(DISK_NAME, DISK_IOCTL_CTRL_SYNC, NULL);
+	zassert_equal(rc, 0, "sync failed");
+	zassert_equal(call_count, 2, "outdated sector written back");
+	zassert_equal(ram_disk[6][0], 0xe0, "direct write overwritten");
+}
+
+void test_main(void)
+{
+	int rc;
+
+	rc = disk_access_register(&ram_disk_info);
+	zassert_equal(rc, 0, "disk register failed");
+
+	ztest_test_suite(disk_cache_test,
+			 ztest_unit_test(test_lru_eviction),
+			 ztest_unit_test(test_read_ahead),
+			 ztest_unit_test(test_sync_write_back),
+			 ztest_unit_test(test_direct_io)
+			);
+
+	ztest_run_test_suite(disk_cache_test);
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Asynchronous requests on a littlefs file:
+ * * adjacent writes
+ * * sync
+ * * adjacent reads
+ */
+
+#include <string.h>
+#include <ztest.h>
+#include "testfs_tests.h"
+#include "testfs_lfs.h"
+
+#define ASYNC "async"
+#define NREQ 8
+#define REQ_SIZE 32
+
+#ifdef CONFIG_FILE_SYSTEM_ASYNC
+static struct fs_async_req reqs[NREQ];
+static uint8_t bufs[NREQ][REQ_SIZE];
+static atomic_t completed;
+
+/* Runs in a worker thread, the test thread checks the count */
+static void async_cb(struct fs_async_req *req, ssize_t result)
+{
+	ARG_UNUSED(req);
+
+	if (result == REQ_SIZE) {
+		atomic_inc(&completed);
+	}
+}
+
+static void wait_signal(struct k_poll_signal *signal)
+{
+	struct k_poll_event event = K_POLL_EVENT_INITIALIZER(
+		K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY, signal);
+
+	zassert_equal(k_poll(&event, 1, K_SECONDS(5)), 0,
+		      "request not completed");
+	k_poll_signal_reset(signal);
+}
+
+/* Queue one request per buffer, the last one signals */
+static void queue_all(struct fs_file_t *file, bool write,
+		      struct k_poll_signal *signal)
+{
+	int rc;
+
+	atomic_set(&completed, 0);
+
+	for (int i = 0; i < NREQ; i++) {
+		reqs[i].cb = async_cb;
+		reqs[i].signal = i == NREQ - 1 ? signal : NULL;
+
+		if (write) {
+			rc = fs_write_async(file, bufs[i], REQ_SIZE,
+					    i * REQ_SIZE, &reqs[i]);
+		} else {
+			rc = fs_read_async(file, bufs[i], REQ_SIZE,
+					   i * REQ_SIZE, &reqs[i]);
+		}
+		zassert_equal(rc, 0, "submit %d failed: %d", i, rc);
+	}
+}
+#endif
+
+void test_lfs_async(void)
+{
+#ifdef CONFIG_FILE_SYSTEM_ASYNC
+	struct fs_mount_t *mp = &testfs_small_mnt;
+	struct k_poll_signal signal;
+	struct fs_async_req sync_req = { .signal = &signal };
+	struct testfs_path path;
+	struct fs_file_t file;
+
+	k_poll_signal_init(&signal);
+	fs_file_t_init(&file);
+
+	zassert_equal(testfs_lfs_wipe_partition(mp), TC_PASS,
+		      "failed to wipe partition");
+	zassert_equal(fs_mount(mp), 0, "mount failed");
+
+	zassert_equal(fs_open(&file,
+			      testfs_path_init(&path, mp,
+					       ASYNC,
+					       TESTFS_PATH_END),
+			      FS_O_CREATE | FS_O_RDWR),
+		      0,
+		      "open async failed");
+
+	for (int i = 0; i < NREQ; i++) {
+		memset(bufs[i], i, REQ_SIZE);
+	}
+
+	queue_all(&file, true, &signal);
+	zassert_equal(fs_sync_async(&file, &sync_req), 0,
+		      "sync submit failed");
+
+	/* Requests complete in order, the sync is the last one */
+	wait_signal(&signal);
+	zassert_equal(sync_req.result, 0, "sync failed: %d",
+		      (int)sync_req.result);
+	zassert_equal(atomic_get(&completed), NREQ, "writes not completed");
+
+	memset(bufs, 0xff, sizeof(bufs));
+
+	queue_all(&file, false, &signal);
+	wait_signal(&signal);
+	zassert_equal(atomic_get(&completed), NREQ, "reads not completed");
+
+	for (int i = 0; i < NREQ; i++) {
+		for (int j = 0; j < REQ_SIZE; j++) {
+			zassert_equal(bufs[i][j], i, "bad data in block %d", i);
+		}
+	}
+
+	zassert_equal(fs_close(&file), 0, "close async failed");
+	zassert_equal(fs_unmount(mp), 0, "unmount failed");
+#else
+	ztest_test_skip();
+#endif
+}
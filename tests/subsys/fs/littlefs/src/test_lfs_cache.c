@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Mount-wide block cache and statistics:
+ * * flash operations are counted
+ * * metadata of files opened together is served from the cache
+ * * data read through the cache is correct
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <ztest.h>
+#include <fs/littlefs.h>
+#include "testfs_tests.h"
+#include "testfs_lfs.h"
+
+#define NFILES CONFIG_FS_LITTLEFS_NUM_FILES
+#define FILE_SIZE 200
+#define ROUNDS 4
+
+#if defined(CONFIG_FS_LITTLEFS_BLOCK_CACHE) && defined(CONFIG_FS_LITTLEFS_STATS)
+static uint8_t buf[FILE_SIZE];
+
+static const char *file_path(struct testfs_path *path, struct fs_mount_t *mp,
+			     int i)
+{
+	char name[8];
+
+	snprintf(name, sizeof(name), "f%d", i);
+
+	return testfs_path_init(path, mp, name, TESTFS_PATH_END);
+}
+#endif
+
+void test_lfs_cache(void)
+{
+#if defined(CONFIG_FS_LITTLEFS_BLOCK_CACHE) && defined(CONFIG_FS_LITTLEFS_STATS)
+	struct fs_mount_t *mp = &testfs_small_mnt;
+	struct fs_littlefs *fs = mp->fs_data;
+	struct fs_file_t files[NFILES];
+	struct testfs_path path;
+	uint32_t hits, reads;
+
+	zassert_equal(testfs_lfs_wipe_partition(mp), TC_PASS,
+		      "failed to wipe partition");
+	zassert_equal(fs_mount(mp), 0, "mount failed");
+
+	for (int i = 0; i < NFILES; i++) {
+		fs_file_t_init(&files[i]);
+		memset(buf, i, sizeof(buf));
+
+		zassert_equal(fs_open(&files[i], file_path(&path, mp, i),
+				      FS_O_CREATE | FS_O_WRITE),
+			      0, "open %d for writing failed", i);
+		zassert_equal(fs_write(&files[i], buf, sizeof(buf)),
+			      sizeof(buf), "write %d failed", i);
+		zassert_equal(fs_close(&files[i]), 0, "close %d failed", i);
+	}
+
+	zassert_true(fs->stats.progs > 0, "programs not counted");
+	zassert_true(fs->stats.erases > 0, "erases not counted");
+
+	hits = fs->stats.cache_hits;
+	reads = fs->stats.reads;
+
+	for (int r = 0; r < ROUNDS; r++) {
+		for (int i = 0; i < NFILES; i++) {
+			zassert_equal(fs_open(&files[i],
+					      file_path(&path, mp, i),
+					      FS_O_READ),
+				      0, "open %d for reading failed", i);
+		}
+
+		for (int i = 0; i < NFILES; i++) {
+			memset(buf, 0xff, sizeof(buf));
+			zassert_equal(fs_read(&files[i], buf, sizeof(buf)),
+				      sizeof(buf), "read %d failed", i);
+
+			for (int j = 0; j < sizeof(buf); j++) {
+				zassert_equal(buf[j], i, "bad data in file %d",
+					      i);
+			}
+
+			zassert_equal(fs_close(&files[i]), 0,
+				      "close %d failed", i);
+		}
+	}
+
+	TC_PRINT("reads %u ; progs %u ; erases %u ; hits %u ; misses %u\n",
+		 fs->stats.reads, fs->stats.progs, fs->stats.erases,
+		 fs->stats.cache_hits, fs->stats.cache_misses);
+
+	zassert_true(fs->stats.cache_hits > hits, "no cache hits");
+	zassert_true(fs->stats.reads > reads, "reads not counted");
+
+	zassert_equal(fs_unmount(mp), 0, "unmount failed");
+#else
+	ztest_test_skip();
+#endif
+}
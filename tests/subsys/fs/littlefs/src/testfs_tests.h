@@ -24,6 +24,12 @@ void test_lfs_dirops(void);
 /* Tests in test_lfs_perf */
 void test_lfs_perf(void);
 
+/* Tests in test_lfs_async */
+void test_lfs_async(void);
+
+/* Tests in test_lfs_cache */
+void test_lfs_cache(void);
+
 /* Test fs_open flags */
 void test_fs_open_flags_lfs(void);
 
@@ -706,6 +706,208 @@ void test_nvs_gc_corrupt_ate(void)
 	zassert_true(err == 0,  "nvs_init call failure: %d", err);
 }
 
+static int flash_sim_read_calls_find(struct stats_hdr *hdr, void *arg,
+				     const char *name, uint16_t off)
+{
+	if (!strcmp(name, "flash_read_calls")) {
+		uint32_t **flash_read_stat = (uint32_t **) arg;
+		*flash_read_stat = (uint32_t *)((uint8_t *)hdr + off);
+	}
+
+	return 0;
+}
+
+/*
+ * Test that with the lookup cache an entry is read with a single ate read
+ * no matter how many entries were written after it, also after the cache
+ * has been rebuilt by nvs_init() and entries have been moved by gc.
+ */
+void test_nvs_cache_lookup(void)
+{
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	uint32_t *flash_read_stat;
+	uint32_t reads_before;
+	uint16_t id, data;
+	ssize_t len;
+	int err;
+
+	fs.sector_count = 3;
+
+	err = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+
+	stats_walk(sim_stats, flash_sim_read_calls_find, &flash_read_stat);
+
+	for (int pass = 0; pass < 2; pass++) {
+		/* Enough entries to fill more than a sector and trigger gc */
+		for (int i = 0; i < fs.sector_size / 8; i++) {
+			id = i % 16;
+			data = i;
+			len = nvs_write(&fs, id, &data, sizeof(data));
+			zassert_true(len == sizeof(data),
+				     "nvs_write failed: %d", len);
+		}
+
+		err = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+		zassert_true(err == 0,  "nvs_init call failure: %d", err);
+
+		for (id = 0; id < 16; id++) {
+			reads_before = *flash_read_stat;
+
+			len = nvs_read(&fs, id, &data, sizeof(data));
+			zassert_true(len == sizeof(data),
+				     "nvs_read failed: %d", len);
+			zassert_true(*flash_read_stat - reads_before <= 2,
+				     "too many flash reads: %u",
+				     *flash_read_stat - reads_before);
+		}
+	}
+
+	err = nvs_delete(&fs, 0);
+	zassert_true(err == 0,  "nvs_delete call failure: %d", err);
+
+	len = nvs_read(&fs, 0, &data, sizeof(data));
+	zassert_true(len == -ENOENT, "nvs_read shouldn't found the entry: %d",
+		     len);
+#else
+	ztest_test_skip();
+#endif
+}
+
+struct walk_result {
+	struct nvs_walk_entry found[8];
+	bool seen[8];
+	int count;
+};
+
+static int walk_cb(struct nvs_fs *fs, const struct nvs_walk_entry *entry,
+		   void *param)
+{
+	struct walk_result *result = param;
+
+	zassert_true(entry->id < ARRAY_SIZE(result->found),
+		     "unexpected id %u", entry->id);
+
+	/* Keep the newest entry of each id */
+	if (!result->seen[entry->id]) {
+		result->found[entry->id] = *entry;
+		result->seen[entry->id] = true;
+	}
+	result->count++;
+
+	return 0;
+}
+
+/*
+ * Test that nvs_walk() reports the newest entry of each id first, that
+ * nvs_read_entry() reads it, and that entries go stale on a write.
+ */
+void test_nvs_walk(void)
+{
+	struct walk_result result = { 0 };
+	uint16_t id, data;
+	ssize_t len;
+	int err;
+
+	fs.sector_count = 3;
+
+	err = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+
+	/* Two entries per id, the last one with data == id * 10 */
+	for (int i = 0; i < 2 * ARRAY_SIZE(result.found); i++) {
+		id = i % ARRAY_SIZE(result.found);
+		data = i < ARRAY_SIZE(result.found) ? 0 : id * 10;
+		len = nvs_write(&fs, id, &data, sizeof(data));
+		zassert_true(len == sizeof(data), "nvs_write failed: %d", len);
+	}
+
+	err = nvs_delete(&fs, 0);
+	zassert_true(err == 0,  "nvs_delete call failure: %d", err);
+
+	err = nvs_walk(&fs, walk_cb, &result);
+	zassert_true(err == 0,  "nvs_walk call failure: %d", err);
+	zassert_equal(result.count, 2 * ARRAY_SIZE(result.found) + 1,
+		      "wrong number of entries: %d", result.count);
+	zassert_equal(result.found[0].len, 0, "delete not reported");
+
+	for (id = 1; id < ARRAY_SIZE(result.found); id++) {
+		len = nvs_read_entry(&fs, &result.found[id], &data,
+				     sizeof(data));
+		zassert_true(len == sizeof(data), "nvs_read_entry failed: %d",
+			     len);
+		zassert_equal(data, id * 10, "wrong data for id %u", id);
+	}
+
+	len = nvs_write(&fs, 1, &data, sizeof(data));
+	zassert_true(len == sizeof(data), "nvs_write failed: %d", len);
+
+	len = nvs_read_entry(&fs, &result.found[1], &data, sizeof(data));
+	zassert_equal(len, -EAGAIN, "entry not stale after write: %d", len);
+}
+
+/*
+ * Test that the sector emptied by gc is erased by the work queue, and
+ * that the file system is consistent before and after that.
+ */
+void test_nvs_background_erase(void)
+{
+#ifdef CONFIG_NVS_BACKGROUND_ERASE
+	const uint16_t max_id = 10;
+	/* 50th write will trigger 1st GC. */
+	const uint16_t max_writes = 51;
+	uint8_t buf[32];
+	int err;
+
+	fs.sector_count = 3;
+
+	err = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+
+	write_content(max_id, 0, max_writes, &fs);
+
+	/* sector sequence: gc'ed, closed, write */
+	zassert_equal(fs.ate_wra >> ADDR_SECT_SHIFT, 2,
+		     "unexpected write sector");
+	check_content(max_id, &fs);
+
+	/* Let the system work queue run */
+	k_sleep(K_MSEC(100));
+
+	zassert_false(fs.erase_pending, "gc'ed sector not erased");
+
+	for (off_t off = 0; off < fs.sector_size; off += sizeof(buf)) {
+		err = flash_read(fs.flash_device, fs.offset + off, buf,
+				 sizeof(buf));
+		zassert_true(err == 0,  "flash_read call failure: %d", err);
+
+		for (int i = 0; i < sizeof(buf); i++) {
+			zassert_equal(buf[i],
+				      fs.flash_parameters->erase_value,
+				      "gc'ed sector not erased at %u",
+				      off + i);
+		}
+	}
+
+	check_content(max_id, &fs);
+
+	/* Trigger 2nd GC, into the sector erased in the background */
+	write_content(max_id, max_writes, max_writes + 25, &fs);
+
+	zassert_equal(fs.ate_wra >> ADDR_SECT_SHIFT, 0,
+		     "unexpected write sector");
+	check_content(max_id, &fs);
+
+	err = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+
+	zassert_false(fs.erase_pending, "erase left pending by nvs_init");
+	check_content(max_id, &fs);
+#else
+	ztest_test_skip();
+#endif
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_nvs,
@@ -729,7 +931,13 @@ void test_main(void)
 			 ztest_unit_test_setup_teardown(
 				 test_nvs_gc_corrupt_close_ate, setup, teardown),
 			 ztest_unit_test_setup_teardown(
-				 test_nvs_gc_corrupt_ate, setup, teardown)
+				 test_nvs_gc_corrupt_ate, setup, teardown),
+			 ztest_unit_test_setup_teardown(
+				 test_nvs_cache_lookup, setup, teardown),
+			 ztest_unit_test_setup_teardown(
+				 test_nvs_walk, setup, teardown),
+			 ztest_unit_test_setup_teardown(
+				 test_nvs_background_erase, setup, teardown)
 			);
 
 	ztest_run_test_suite(test_nvs);
@@ -13,6 +13,7 @@
 #include <ztest.h>
 #include <errno.h>
 #include <settings/settings.h>
+#include "settings_priv.h"
 #include <logging/log.h>
 LOG_MODULE_REGISTER(settings_basic_test);
 
@@ -606,6 +607,180 @@ static void test_direct_loading_filter(void)
 	}
 }
 
+SETTINGS_STATIC_HANDLER_DEFINE(st, "st", NULL, NULL, NULL, NULL);
+SETTINGS_STATIC_HANDLER_DEFINE(st_sub, "st/sub", NULL, NULL, NULL, NULL);
+SETTINGS_STATIC_HANDLER_DEFINE(st_sub_key, "st/sub/key", NULL, NULL, NULL,
+			       NULL);
+SETTINGS_STATIC_HANDLER_DEFINE(stx, "stx", NULL, NULL, NULL, NULL);
+
+/*
+ * Test that the static handler with the longest name matching whole
+ * components of a settings name is found.
+ */
+static void test_static_handler_lookup(void)
+{
+	struct settings_handler_static *ch;
+	const char *next;
+	int rc;
+
+	rc = settings_subsys_init();
+	zassert_true(rc == 0, "subsys init failed");
+
+	ch = settings_parse_and_lookup("st/a", &next);
+	zassert_equal_ptr(ch, &settings_handler_st, "wrong handler");
+	zassert_true(next && !strcmp(next, "a"), "wrong next");
+
+	ch = settings_parse_and_lookup("st/sub/a", &next);
+	zassert_equal_ptr(ch, &settings_handler_st_sub, "wrong handler");
+	zassert_true(next && !strcmp(next, "a"), "wrong next");
+
+	ch = settings_parse_and_lookup("st/subx/a", &next);
+	zassert_equal_ptr(ch, &settings_handler_st, "wrong handler");
+	zassert_true(next && !strcmp(next, "subx/a"), "wrong next");
+
+	ch = settings_parse_and_lookup("st/sub/key=1", &next);
+	zassert_equal_ptr(ch, &settings_handler_st_sub_key, "wrong handler");
+	zassert_is_null(next, "wrong next");
+
+	ch = settings_parse_and_lookup("stx", &next);
+	zassert_equal_ptr(ch, &settings_handler_stx, "wrong handler");
+	zassert_is_null(next, "wrong next");
+
+	ch = settings_parse_and_lookup("s/st", &next);
+	zassert_is_null(ch, "unexpected handler");
+	zassert_is_null(next, "wrong next");
+}
+
+struct deferred_result {
+	uint8_t a;
+	uint8_t b;
+	int a_calls;
+};
+
+static int deferred_loader(const char *key, size_t len,
+			   settings_read_cb read_cb, void *cb_arg,
+			   void *param)
+{
+	struct deferred_result *result = param;
+	uint8_t val;
+
+	zassert_equal(len, sizeof(val), "wrong length");
+	zassert_equal(read_cb(cb_arg, &val, sizeof(val)), sizeof(val),
+		      "read failed");
+
+	if (!strcmp(key, "a")) {
+		result->a = val;
+		result->a_calls++;
+	} else if (!strcmp(key, "b")) {
+		result->b = val;
+	}
+
+	return 0;
+}
+
+/*
+ * Test that deferred saves of an item are merged, written by a flush or a
+ * load, and overridden by a save done at once.
+ */
+static void test_deferred_save(void)
+{
+#if defined(CONFIG_SETTINGS_DEFERRED_SAVE)
+	struct deferred_result result = { 0 };
+	uint8_t val;
+	int rc;
+
+	rc = settings_subsys_init();
+	zassert_true(rc == 0, "subsys init failed");
+
+	val = 1;
+	rc = settings_save_one_deferred("df/a", &val, sizeof(val));
+	zassert_true(rc == 0, "deferred save failed");
+	val = 2;
+	rc = settings_save_one_deferred("df/a", &val, sizeof(val));
+	zassert_true(rc == 0, "deferred save failed");
+
+	rc = settings_save_one_deferred("df/b", &val, sizeof(val));
+	zassert_true(rc == 0, "deferred save failed");
+	val = 3;
+	rc = settings_save_one("df/b", &val, sizeof(val));
+	zassert_true(rc == 0, "save failed");
+
+	rc = settings_flush();
+	zassert_true(rc == 0, "flush failed");
+
+	rc = settings_load_subtree_direct("df", deferred_loader, &result);
+	zassert_true(rc == 0, "load failed");
+	zassert_equal(result.a, 2, "deferred value not written");
+	zassert_equal(result.a_calls, 1, "wrong number of values");
+	zassert_equal(result.b, 3, "deferred value written over a newer one");
+
+	/* A load writes pending values first */
+	rc = settings_save_one_deferred("df/a", NULL, 0);
+	zassert_true(rc == 0, "deferred delete failed");
+
+	memset(&result, 0, sizeof(result));
+	rc = settings_load_subtree_direct("df", deferred_loader, &result);
+	zassert_true(rc == 0, "load failed");
+	zassert_equal(result.a_calls, 0, "deferred delete not written");
+#else
+	ztest_test_skip();
+#endif
+}
+
+#if defined(CONFIG_SETTINGS_DEFERRED_SAVE)
+static int failing_save(struct settings_store *cs, const char *name,
+			const char *value, size_t val_len)
+{
+	return -EIO;
+}
+
+static const struct settings_store_itf failing_itf = {
+	.csi_save = failing_save,
+};
+
+static struct settings_store failing_store = {
+	.cs_itf = &failing_itf,
+};
+#endif
+
+/*
+ * Test that a deferred value the backend fails to write stays pending and
+ * is written by a later flush.
+ */
+static void test_deferred_save_failure(void)
+{
+#if defined(CONFIG_SETTINGS_DEFERRED_SAVE)
+	struct settings_store *dst;
+	struct deferred_result result = { 0 };
+	uint8_t val;
+	int rc;
+
+	rc = settings_subsys_init();
+	zassert_true(rc == 0, "subsys init failed");
+
+	dst = settings_save_dst;
+	settings_dst_register(&failing_store);
+
+	val = 4;
+	rc = settings_save_one_deferred("df/a", &val, sizeof(val));
+	zassert_true(rc == 0, "deferred save failed");
+
+	rc = settings_flush();
+	zassert_equal(rc, -EIO, "backend error not returned");
+
+	settings_dst_register(dst);
+
+	rc = settings_flush();
+	zassert_true(rc == 0, "flush failed");
+
+	rc = settings_load_subtree_direct("df", deferred_loader, &result);
+	zassert_true(rc == 0, "load failed");
+	zassert_equal(result.a_calls, 1, "failed value not kept");
+	zassert_equal(result.a, 4, "wrong value written");
+#else
+	ztest_test_skip();
+#endif
+}
 
 void test_main(void)
 {
@@ -614,7 +789,10 @@ void test_main(void)
 			 ztest_unit_test(test_support_rtn),
 			 ztest_unit_test(test_register_and_loading),
 			 ztest_unit_test(test_direct_loading),
-			 ztest_unit_test(test_direct_loading_filter)
+			 ztest_unit_test(test_direct_loading_filter),
+			 ztest_unit_test(test_static_handler_lookup),
+			 ztest_unit_test(test_deferred_save),
+			 ztest_unit_test(test_deferred_save_failure)
 			);
 
 	ztest_run_test_suite(settings_test_suite);
@@ -259,6 +259,82 @@ static void test_stream_flash_bytes_written(void)
 	VERIFY_WRITTEN(BUF_LEN, BUF_LEN);
 }
 
+static void test_stream_flash_double_buffer(void)
+{
+#ifdef CONFIG_STREAM_FLASH_DOUBLE_BUFFER
+	static uint8_t buf2[BUF_LEN];
+	size_t total = (page_size * 2) + 100;
+	size_t chunk = 100;
+	int rc;
+
+	init_target();
+
+	rc = stream_flash_double_buffer_set(&ctx, NULL);
+	zassert_true(rc < 0, "should fail as buffer is NULL");
+
+	rc = stream_flash_double_buffer_set(&ctx, buf2);
+	zassert_equal(rc, 0, "expected success");
+
+	/* Chunks that do not line up with the buffers nor the pages */
+	for (size_t off = 0; off < total; off += chunk) {
+		rc = stream_flash_buffered_write(&ctx, write_buf,
+						 MIN(chunk, total - off), false);
+		zassert_equal(rc, 0, "expected success");
+	}
+
+	rc = stream_flash_buffered_write(&ctx, write_buf, 0, true);
+	zassert_equal(rc, 0, "expected success");
+
+	zassert_equal(stream_flash_bytes_written(&ctx), total,
+		      "all bytes should be written after a flush");
+
+	/* Erasing ahead must not have touched anything already written */
+	VERIFY_WRITTEN(0, total);
+	VERIFY_ERASED(total, page_size - 100);
+#else
+	ztest_test_skip();
+#endif
+}
+
+static void test_stream_flash_abort(void)
+{
+#ifdef CONFIG_STREAM_FLASH_DOUBLE_BUFFER
+	static uint8_t buf2[BUF_LEN];
+#endif
+	int rc;
+
+	init_target();
+
+#ifdef CONFIG_STREAM_FLASH_DOUBLE_BUFFER
+	rc = stream_flash_double_buffer_set(&ctx, buf2);
+	zassert_equal(rc, 0, "expected success");
+#endif
+
+	/* Two full buffers go to flash, the rest is dropped */
+	rc = stream_flash_buffered_write(&ctx, write_buf, (BUF_LEN * 2) + 10,
+					 false);
+	zassert_equal(rc, 0, "expected success");
+
+	rc = stream_flash_abort(&ctx);
+	zassert_equal(rc, 0, "expected success");
+
+	zassert_equal(stream_flash_bytes_written(&ctx), BUF_LEN * 2,
+		      "the write in progress should be completed");
+	VERIFY_WRITTEN(0, BUF_LEN * 2);
+	VERIFY_ERASED(BUF_LEN * 2, 10);
+
+	rc = stream_flash_init(&ctx, fdev, buf, BUF_LEN, FLASH_BASE, 0, NULL);
+	zassert_equal(rc, 0, "should succeed after an abort");
+
+#ifdef CONFIG_STREAM_FLASH_DOUBLE_BUFFER
+	rc = stream_flash_double_buffer_set(&ctx, buf2);
+	zassert_equal(rc, 0, "no write should be in progress");
+#endif
+
+	rc = stream_flash_abort(NULL);
+	zassert_true(rc < 0, "should fail as ctx is NULL");
+}
+
 static void test_stream_flash_buf_size_greater_than_page_size(void)
 {
 	int rc;
@@ -665,6 +741,8 @@ void test_main(void)
 	     ztest_unit_test(test_stream_flash_buffered_write_whole_page),
 	     ztest_unit_test(test_stream_flash_erase_page),
 	     ztest_unit_test(test_stream_flash_bytes_written),
+	     ztest_unit_test(test_stream_flash_double_buffer),
+	     ztest_unit_test(test_stream_flash_abort),
 	     ztest_unit_test(test_stream_flash_progress_api),
 	     ztest_unit_test(test_stream_flash_progress_resume),
 	     ztest_unit_test(test_stream_flash_progress_clear)
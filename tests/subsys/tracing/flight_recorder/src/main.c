@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <zephyr.h>
+#include <stdio.h>
+#include <tracing/tracing_format.h>
+#include <tracing/flight_recorder.h>
+
+/**
+ * @brief Tests for the tracing flight recorder
+ * @defgroup tracing_flight_recorder_tests Tracing flight recorder
+ * @ingroup all_tests
+ * @{
+ * @}
+ */
+
+#define PACKET_COUNT 100
+#define PACKET_LEN sizeof("fr:000")
+
+static uint8_t dumped[CONFIG_TRACING_FLIGHT_RECORDER_SIZE];
+static size_t dumped_len;
+
+static void dump_cb(const uint8_t *data, size_t length, void *user_data)
+{
+	zassert_true(dumped_len + length <= sizeof(dumped),
+		     "More data than the recorder size");
+
+	memcpy(&dumped[dumped_len], data, length);
+	dumped_len += length;
+}
+
+static size_t dump(void)
+{
+	size_t total;
+
+	dumped_len = 0;
+	total = tracing_flight_recorder_dump(dump_cb, NULL);
+	zassert_equal(total, dumped_len, "Dump returned a wrong length");
+
+	return total;
+}
+
+static void record_packet(int i)
+{
+	char packet[PACKET_LEN];
+
+	snprintf(packet, sizeof(packet), "fr:%03d", i);
+	tracing_format_raw_data((uint8_t *)packet, sizeof(packet));
+}
+
+static bool packet_dumped(int i)
+{
+	char packet[PACKET_LEN];
+
+	snprintf(packet, sizeof(packet), "fr:%03d", i);
+
+	for (size_t offset = 0; offset + sizeof(packet) <= dumped_len;
+	     offset++) {
+		if (memcmp(&dumped[offset], packet, sizeof(packet)) == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @brief Test that the oldest packets are overwritten
+ *
+ * @details Record more packets than the recorder holds, the dump must
+ * end with the last packet, in whole, and the first ones must be gone.
+ *
+ * @ingroup tracing_flight_recorder_tests
+ */
+void test_flight_recorder_overwrite(void)
+{
+	tracing_flight_recorder_resume();
+
+	for (int i = 0; i < PACKET_COUNT; i++) {
+		record_packet(i);
+	}
+
+	tracing_flight_recorder_freeze();
+
+	zassert_true(dump() > 0, "Nothing recorded");
+	zassert_true(packet_dumped(PACKET_COUNT - 1), "Last packet missing");
+	zassert_false(packet_dumped(0), "Oldest packet not overwritten");
+
+	tracing_flight_recorder_resume();
+}
+
+/**
+ * @brief Test freezing and resuming the recorder
+ *
+ * @details Packets recorded while the recorder is frozen must be
+ * dropped and the recorded ones kept, recording must go on once it is
+ * resumed.
+ *
+ * @ingroup tracing_flight_recorder_tests
+ */
+void test_flight_recorder_freeze(void)
+{
+	static uint8_t frozen[CONFIG_TRACING_FLIGHT_RECORDER_SIZE];
+	size_t frozen_len;
+
+	record_packet(PACKET_COUNT);
+	tracing_flight_recorder_freeze();
+	zassert_true(tracing_flight_recorder_is_frozen(), "Not frozen");
+
+	frozen_len = dump();
+	memcpy(frozen, dumped, frozen_len);
+	zassert_true(packet_dumped(PACKET_COUNT), "Packet missing");
+
+	record_packet(PACKET_COUNT + 1);
+
+	zassert_equal(dump(), frozen_len, "Recorded while frozen");
+	zassert_mem_equal(dumped, frozen, frozen_len, "Recorded while frozen");
+	zassert_true(tracing_flight_recorder_is_frozen(),
+		     "Dump resumed a frozen recorder");
+
+	tracing_flight_recorder_resume();
+	zassert_false(tracing_flight_recorder_is_frozen(), "Not resumed");
+
+	record_packet(PACKET_COUNT + 2);
+	tracing_flight_recorder_freeze();
+
+	dump();
+	zassert_false(packet_dumped(PACKET_COUNT + 1),
+		      "Packet recorded while frozen");
+	zassert_true(packet_dumped(PACKET_COUNT + 2),
+		     "Packet missing after resume");
+
+	tracing_flight_recorder_resume();
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_flight_recorder,
+			 ztest_unit_test(test_flight_recorder_overwrite),
+			 ztest_unit_test(test_flight_recorder_freeze)
+			 );
+	ztest_run_test_suite(test_flight_recorder);
+}
@@ -108,6 +108,10 @@
 
 #endif /* VIA_TWISTER */
 
+#ifdef CONFIG_CBPRINTF_COMPLETE
+#define CONFIG_CBPRINTF_PREPARSED_FMT 1
+#endif
+
 /* Can't use IS_ENABLED on symbols that don't start with CONFIG_
  * without checkpatch complaints, so do something else.
  */
@@ -1386,6 +1390,49 @@ static void test_cbpprintf(void)
 	zassert_equal(rc, -EINVAL, NULL);
 }
 
+/* Check a pre-parsed format against cbprintf(), on the call parsing it
+ * and on a call using the parsed conversions.
+ */
+#define TEST_FMT(_fmt, ...) do { \
+	char _buf[sizeof(buf)]; \
+	int _rc, _rc_fmt; \
+	CBPRINTF_FMT_DEFINE(_pfmt, _fmt); \
+	reset_out(); \
+	_rc = cbprintf(out, &outbuf, _fmt, __VA_ARGS__); \
+	outbuf_null_terminate(&outbuf); \
+	strcpy(_buf, buf); \
+	for (int _i = 0; _i < 2; _i++) { \
+		reset_out(); \
+		_rc_fmt = cbprintf_fmt(out, &outbuf, &_pfmt, __VA_ARGS__); \
+		outbuf_null_terminate(&outbuf); \
+		zassert_equal(_rc, _rc_fmt, "%s: %d != %d", _fmt, _rc, \
+			      _rc_fmt); \
+		zassert_equal(strcmp(_buf, buf), 0, "%s: '%s' != '%s'", \
+			      _fmt, _buf, buf); \
+	} \
+} while (false)
+
+static void test_cbprintf_fmt(void)
+{
+	if (ENABLED_USE_LIBC) {
+		TC_PRINT("disabled\n");
+		return;
+	}
+
+	TEST_FMT("text only%s", "");
+	TEST_FMT("%d|%-5s|%08x|%c", -42, "ab", 0xbeef, 'z');
+	TEST_FMT("%*d|%.*s|%%|%p", -6, 7, 2, "abcdef", (void *)0x1234);
+	TEST_FMT("%hhx %ld %u", 0x1ff, 5L, 3U);
+	if (IS_ENABLED(CONFIG_CBPRINTF_FP_SUPPORT)) {
+		TEST_FMT("%.3f %+e", 3.14159, -0.5);
+	}
+
+	reset_out();
+	CBPRINTF_FMT(out, &outbuf, "%d %s", 12, "ok");
+	outbuf_null_terminate(&outbuf);
+	zassert_equal(strcmp(buf, "12 ok"), 0, NULL);
+}
+
 static void test_nop(void)
 {
 }
@@ -1467,6 +1514,7 @@ void test_main(void)
 			 ztest_unit_test(test_cbpprintf),
 			 ztest_unit_test(test_cbprintf_package_rw_string_indexes),
 			 ztest_unit_test(test_cbprintf_fsc_package),
+			 ztest_unit_test(test_cbprintf_fmt),
 			 ztest_unit_test(test_nop)
 			 );
 	ztest_run_test_suite(test_prf);